@@ -1,27 +1,90 @@
 #pragma once
 
 #include <async_coro/config.h>
+#include <async_coro/internal/hardware_interference_size.h>
 #include <async_coro/thread_safety/light_mutex.h>
+#include <async_coro/thread_safety/no_lock_mutex.h>
 #include <async_coro/thread_safety/unique_lock.h>
+#include <async_coro/warnings.h>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <ranges>
 #include <type_traits>
 #include <vector>
 
 namespace async_coro {
 
+/**
+ * @brief Policies that define how many threads can push and pop values of atomic_queue simultaneously
+ */
+namespace atomic_queue_policy {
+
+// Any number of producers and consumers. Both push and pop are protected by spin locks
+struct mpmc {
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = true;
+};
+
+// Any number of producers and only one consumer. Values are linked with one atomic exchange and popped without locks
+struct mpsc {
+  static constexpr bool multi_producer = true;
+  static constexpr bool multi_consumer = false;
+};
+
+// Only one producer and one consumer. Push and pop don't use any locks
+struct spsc {
+  static constexpr bool multi_producer = false;
+  static constexpr bool multi_consumer = false;
+};
+
+// Same as TPolicy but state of producers and consumers is packed without cache line padding.
+// Saves memory of many mostly idle queues at cost of false sharing between producers, consumers and neighbour queues
+template <typename TPolicy>
+struct packed : TPolicy {
+  static constexpr bool packed_layout = true;
+};
+
+}  // namespace atomic_queue_policy
+
+ASYNC_CORO_WARNINGS_MSVC_PUSH
+ASYNC_CORO_WARNINGS_MSVC_IGNORE(4324)
+
 /**
  * @brief A thread safe queue that uses atomics for a fast path.
  * In case when there is no preallocated values it will fall back to using spin lock mutex to allocate a new bank of values.
- * This queue is designed to be used in multi producer/multi consumer scenarios.
+ * By default this queue is designed to be used in multi producer/multi consumer scenarios.
+ * Single consumer policies replace locks on the consumer side with lock free linked list of values.
  * @tparam T The type of the values to be stored in the queue.
  * @tparam BlockSize The number of values to be preallocated in a single bank.
+ * @tparam Policy One of atomic_queue_policy types. Defines how many producers and consumers can use queue simultaneously.
  */
-template <typename T, std::uint32_t BlockSize = 64>  // NOLINT(*-magic-*)
+template <typename T, std::uint32_t BlockSize = 64, typename Policy = atomic_queue_policy::mpmc>  // NOLINT(*-magic-*)
 class atomic_queue {
   static_assert(BlockSize > 1, "Block size should be more than 1");
+  static_assert(Policy::multi_producer || !Policy::multi_consumer, "Single producer multi consumer queue is not supported");
+
+  static constexpr bool is_single_consumer = !Policy::multi_consumer;
+
+  // members of packed queues get only their natural alignment, as the strictest alignas is applied
+  static constexpr std::size_t state_alignment = [] {
+    if constexpr (requires { Policy::packed_layout; }) {
+      return Policy::packed_layout ? std::size_t{1} : std::hardware_constructive_interference_size;
+    } else {
+      return std::hardware_constructive_interference_size;
+    }
+  }();
+
+  // single producer doesn't need to guard list of free values as consumer returns values to separate list
+  using producer_mutex = std::conditional_t<Policy::multi_producer, light_mutex, no_lock_mutex>;
 
   union union_store {
     T value;
@@ -38,29 +101,57 @@ class atomic_queue {
 
   struct value {
     union_store val;
-    value* next;
+    std::atomic<value*> next;
   };
 
   struct values_bank {
     std::array<value, BlockSize> values;
+    // scratch counter used while searching for banks that can be released
+    std::uint32_t num_free_values = 0;
 
     values_bank() noexcept {
       value* prev_value = nullptr;
       for (auto& val : values) {
         if (prev_value) {
-          prev_value->next = &val;
+          prev_value->next.store(&val, std::memory_order::relaxed);
         }
         prev_value = &val;
       }
-      prev_value->next = nullptr;
+      prev_value->next.store(nullptr, std::memory_order::relaxed);
     }
   };
 
+  // returns bank memory to the resource it was allocated from
+  struct bank_deleter {
+    std::pmr::memory_resource* resource;
+
+    void operator()(values_bank* bank) const noexcept {
+      std::pmr::polymorphic_allocator<values_bank>{resource}.delete_object(bank);
+    }
+  };
+
+  using bank_ptr = std::unique_ptr<values_bank, bank_deleter>;
+
  public:
+  /**
+   * @brief Construct a new atomic queue object that allocates banks of values from the default memory resource
+   */
+  atomic_queue() noexcept
+      : atomic_queue(std::pmr::get_default_resource()) {}
+
   /**
    * @brief Construct a new atomic queue object
+   * @param resource Memory resource used to allocate banks of values. Should outlive the queue
    */
-  atomic_queue() noexcept = default;
+  explicit atomic_queue(std::pmr::memory_resource* resource) noexcept
+      : _additional_banks(resource) {
+    ASYNC_CORO_ASSERT(resource != nullptr);
+
+    if constexpr (is_single_consumer) {
+      // first value of the head bank is used as a stub
+      _head_bank.values[0].next.store(nullptr, std::memory_order::relaxed);
+    }
+  }
 
   atomic_queue(const atomic_queue&) = delete;
   atomic_queue(atomic_queue&&) = delete;
@@ -69,14 +160,20 @@ class atomic_queue {
    * @brief Destroy the atomic queue object and all the values that are still in it.
    */
   ~atomic_queue() noexcept {
-    unique_lock lock{_value_mutex};
+    value* head = nullptr;
 
-    auto head = _head.exchange(nullptr, std::memory_order::relaxed);
-    _last = nullptr;
+    if constexpr (is_single_consumer) {
+      head = _head.load(std::memory_order::acquire)->next.load(std::memory_order::acquire);
+    } else {
+      unique_lock lock{_value_mutex};
+
+      head = _head.exchange(nullptr, std::memory_order::relaxed);
+      _last = nullptr;
+    }
 
     while (head) {
       std::destroy_at(std::addressof(head->val.value));
-      head = head->next;
+      head = head->next.load(std::memory_order::relaxed);
     }
   }
 
@@ -92,30 +189,12 @@ class atomic_queue {
    */
   template <typename... U>
   void push(U&&... val) {
-    value* head;  // NOLINT(*-init-*)
-
-    {
-      unique_lock lock{_free_value_mutex};
-
-      if (!_free_value) {
-        allocate_new_bank();
-      }
-
-      head = _free_value;
-      _free_value = head->next;
-    }
+    value* head = acquire_free_value<true>();
 
     new (std::addressof(head->val.value)) T{std::forward<U>(val)...};
-    head->next = nullptr;
-
-    unique_lock lock{_value_mutex};
+    head->next.store(nullptr, std::memory_order::relaxed);
 
-    value* expected_to_set = nullptr;
-    _head.compare_exchange_strong(expected_to_set, head, std::memory_order::relaxed);
-    if (_last) {
-      _last->next = head;
-    }
-    _last = head;
+    link_values(head, head);
   }
 
   /**
@@ -127,30 +206,43 @@ class atomic_queue {
    */
   template <typename... U>
   bool try_push(U&&... val) noexcept(std::is_nothrow_constructible_v<T, U&&...>) {
-    value* head;  // NOLINT(*-init-*)
+    value* head = acquire_free_value<false>();
+    if (!head) {
+      return false;
+    }
 
-    {
-      unique_lock lock{_free_value_mutex};
+    new (std::addressof(head->val.value)) T{std::forward<U>(val)...};
+    head->next.store(nullptr, std::memory_order::relaxed);
 
-      if (!_free_value) {
-        return false;
-      }
+    link_values(head, head);
 
-      head = _free_value;
-      _free_value = head->next;
-    }
+    return true;
+  }
 
-    new (std::addressof(head->val.value)) T{std::forward<U>(val)...};
-    head->next = nullptr;
+  /**
+   * @brief Pushes all values of the range to the queue.
+   * Free values are taken and the whole chain is linked to the queue with a single lock or atomic exchange.
+   * @tparam R Sized range of values that can be used to construct T. Values are moved from range with std::ranges::iter_move.
+   * @param range The range of values to push.
+   */
+  template <std::ranges::sized_range R>
+  void push_bulk(R&& range) {
+    const auto num_values = static_cast<std::size_t>(std::ranges::size(range));
+    if (num_values == 0) {
+      return;
+    }
 
-    unique_lock lock{_value_mutex};
+    value* first = acquire_free_values(num_values);
+    value* last = first;
+    value* current = first;
 
-    value* expected_to_set = nullptr;
-    _head.compare_exchange_strong(expected_to_set, head, std::memory_order::relaxed);
-    if (_last) {
-      _last->next = head;
+    for (auto it = std::ranges::begin(range); current != nullptr; ++it) {
+      new (std::addressof(current->val.value)) T{std::ranges::iter_move(it)};
+      last = current;
+      current = current->next.load(std::memory_order::relaxed);
     }
-    _last = head;
+
+    link_values(first, last);
   }
 
   /**
@@ -161,60 +253,520 @@ class atomic_queue {
   bool try_pop(T& val) noexcept(std::is_nothrow_move_assignable_v<T>) {
     value* head;  // NOLINT(*-init-*)
 
-    {
-      // we use common lock here as head->next can change unexpectedly
-      unique_lock lock{_value_mutex};
+    if constexpr (is_single_consumer) {
+      // only consumer changes head so there is no need for locks
+      value* stub = _head.load(std::memory_order::relaxed);
+      head = stub->next.load(std::memory_order::acquire);
+      if (!head) {
+        return false;
+      }
 
-      head = _head.load(std::memory_order::relaxed);
-      if (head) {
-        _head.store(head->next, std::memory_order::relaxed);
-        if (_last == head) {
-          _last = head->next;
+      val = std::move(head->val.value);
+      std::destroy_at(std::addressof(head->val.value));
+
+      // popped value becomes a new stub
+      _head.store(head, std::memory_order::relaxed);
+
+      recycle_values(stub, stub);
+    } else {
+      bool is_empty = false;
+      {
+        // we use common lock here as head->next can change unexpectedly
+        unique_lock lock{_value_mutex};
+
+        head = _head.load(std::memory_order::relaxed);
+        if (head) {
+          _head.store(head->next.load(std::memory_order::relaxed), std::memory_order::relaxed);
+          if (_last == head) {
+            _last = head->next.load(std::memory_order::relaxed);
+          }
+          is_empty = _last == nullptr;
+        } else {
+          return false;
         }
-      } else {
-        return false;
+      }
+
+      val = std::move(head->val.value);
+      std::destroy_at(std::addressof(head->val.value));
+
+      recycle_values(head, head);
+
+      if (is_empty) {
+        try_trim_banks();
       }
     }
 
-    val = std::move(head->val.value);
-    std::destroy_at(std::addressof(head->val.value));
+    return true;
+  }
+
+  /**
+   * @brief Tries to pop a value from the queue and invokes func with the value that is still stored in the queue node.
+   * Value is not moved out of the queue, it is destroyed and its node is recycled right after the invocation.
+   * @param func Callable that takes T&.
+   * @return true if a value was consumed, false if the queue is empty.
+   * @note For single consumer queues func must not pop values from the same queue.
+   */
+  template <typename F>
+  bool try_consume(F&& func) noexcept(std::is_nothrow_invocable_v<F&&, T&>) {
+    value* head;  // NOLINT(*-init-*)
 
-    {
-      unique_lock lock{_free_value_mutex};
-      head->next = _free_value;
-      _free_value = head;
+    if constexpr (is_single_consumer) {
+      value* stub = _head.load(std::memory_order::relaxed);
+      head = stub->next.load(std::memory_order::acquire);
+      if (!head) {
+        return false;
+      }
+
+      // consumed value becomes a new stub so its node will be recycled only on the next pop
+      _head.store(head, std::memory_order::relaxed);
+
+      recycle_values(stub, stub);
+
+      const consume_guard guard{*this, head, false};
+      std::forward<F>(func)(head->val.value);
+    } else {
+      bool is_empty = false;
+      {
+        unique_lock lock{_value_mutex};
+
+        head = _head.load(std::memory_order::relaxed);
+        if (!head) {
+          return false;
+        }
+
+        _head.store(head->next.load(std::memory_order::relaxed), std::memory_order::relaxed);
+        if (_last == head) {
+          _last = nullptr;
+        }
+        is_empty = _last == nullptr;
+      }
+
+      const consume_guard guard{*this, head, is_empty};
+      std::forward<F>(func)(head->val.value);
     }
 
     return true;
   }
 
+  /**
+   * @brief Tries to pop up to max_values values from the queue.
+   * Values are detached from the queue with a single lock and returned to the free list as one chain.
+   * @param out Output iterator where popped values will be moved to.
+   * @param max_values Max number of values to pop.
+   * @return number of popped values.
+   */
+  template <std::output_iterator<T&&> OutIt>
+  std::size_t try_pop_bulk(OutIt out, std::size_t max_values) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    if (max_values == 0) {
+      return 0;
+    }
+
+    std::size_t num_values = 0;
+
+    if constexpr (is_single_consumer) {
+      value* const stub = _head.load(std::memory_order::relaxed);
+      value* new_stub = stub;
+      value* last_free = stub;
+
+      // every popped value becomes a stub and the previous stub goes to the chain of free values
+      for (value* current = stub->next.load(std::memory_order::acquire); current != nullptr && num_values < max_values;
+           current = current->next.load(std::memory_order::acquire)) {
+        *out = std::move(current->val.value);
+        ++out;
+        std::destroy_at(std::addressof(current->val.value));
+
+        last_free = new_stub;
+        new_stub = current;
+        num_values++;
+      }
+
+      if (num_values == 0) {
+        return 0;
+      }
+
+      _head.store(new_stub, std::memory_order::relaxed);
+
+      recycle_values(stub, last_free);
+    } else {
+      value* first = nullptr;
+      value* last = nullptr;
+      bool is_empty = false;
+
+      {
+        unique_lock lock{_value_mutex};
+
+        first = _head.load(std::memory_order::relaxed);
+        if (!first) {
+          return 0;
+        }
+
+        last = first;
+        num_values = 1;
+        while (num_values < max_values && last != _last) {
+          last = last->next.load(std::memory_order::relaxed);
+          num_values++;
+        }
+
+        _head.store(last->next.load(std::memory_order::relaxed), std::memory_order::relaxed);
+        if (_last == last) {
+          _last = nullptr;
+          is_empty = true;
+        }
+      }
+
+      for (value* current = first;; current = current->next.load(std::memory_order::relaxed)) {
+        *out = std::move(current->val.value);
+        ++out;
+        std::destroy_at(std::addressof(current->val.value));
+
+        if (current == last) {
+          break;
+        }
+      }
+
+      recycle_values(first, last);
+
+      if (is_empty) {
+        try_trim_banks();
+      }
+    }
+
+    return num_values;
+  }
+
   /**
    * @brief Checks if the queue has any values.
    * @return true if the queue has any values, false otherwise.
    */
   [[nodiscard]] bool has_value() const noexcept {
-    return _head.load(std::memory_order::relaxed) != nullptr;
+    if constexpr (is_single_consumer) {
+      return _head.load(std::memory_order::relaxed)->next.load(std::memory_order::relaxed) != nullptr;
+    } else {
+      return _head.load(std::memory_order::relaxed) != nullptr;
+    }
+  }
+
+  /**
+   * @brief Sets number of values that queue keeps allocated after it was drained.
+   * Fully free banks above this capacity are released lazily when the queue becomes empty.
+   * By default all allocated banks are kept until destruction of the queue.
+   * @param num_values Number of values to keep. Rounded up to the whole number of banks, the first bank is always kept.
+   */
+  void set_retained_capacity(std::size_t num_values) noexcept {
+    _retained_banks.store(std::max<std::size_t>(1, (num_values + BlockSize - 1) / BlockSize), std::memory_order::relaxed);
+  }
+
+  /**
+   * @brief Releases all fully free banks of values except the first one.
+   * Banks that still contain values waiting in the queue or being pushed are kept.
+   * @note For single producer queue should be called only from the producer thread.
+   */
+  void shrink_to_fit() noexcept {
+    unique_lock lock{_free_value_mutex};
+
+    release_free_banks(1);
+  }
+
+  /**
+   * @brief Returns number of allocated banks of values including the preallocated one.
+   * Each bank holds BlockSize values.
+   */
+  [[nodiscard]] std::size_t get_num_banks() const noexcept {
+    return _num_banks.load(std::memory_order::relaxed);
   }
 
  private:
+  // destroys consumed value and recycles its node even if consumer throws
+  class consume_guard {
+   public:
+    consume_guard(atomic_queue& queue, value* val, bool is_empty) noexcept
+        : _queue(queue),
+          _val(val),
+          _is_empty(is_empty) {}
+    consume_guard(const consume_guard&) = delete;
+    consume_guard(consume_guard&&) = delete;
+
+    ~consume_guard() noexcept {
+      std::destroy_at(std::addressof(_val->val.value));
+
+      if constexpr (!is_single_consumer) {
+        _queue.recycle_values(_val, _val);
+
+        if (_is_empty) {
+          _queue.try_trim_banks();
+        }
+      }
+    }
+
+    consume_guard& operator=(const consume_guard&) = delete;
+    consume_guard& operator=(consume_guard&&) = delete;
+
+   private:
+    atomic_queue& _queue;
+    value* _val;
+    bool _is_empty;
+  };
+
+  template <bool AllowAllocation>
+  value* acquire_free_value() noexcept(!AllowAllocation) {
+    unique_lock lock{_free_value_mutex};
+
+    if (!_free_value && !refill_free_values<AllowAllocation>()) {
+      return nullptr;
+    }
+
+    value* head = _free_value;
+    _free_value = head->next.load(std::memory_order::relaxed);
+    return head;
+  }
+
+  // takes chain of num_values free values. The last value of the chain has no next value
+  value* acquire_free_values(std::size_t num_values) {
+    ASYNC_CORO_ASSERT(num_values != 0);
+
+    unique_lock lock{_free_value_mutex};
+
+    value* first = nullptr;
+    value* last = nullptr;
+
+    while (num_values != 0) {
+      if (!_free_value) {
+        refill_free_values<true>();
+      }
+
+      // take as many values as possible from the current chain of free values
+      value* head = _free_value;
+      value* tail = head;
+      num_values--;
+      for (value* next = tail->next.load(std::memory_order::relaxed); num_values != 0 && next != nullptr; next = tail->next.load(std::memory_order::relaxed)) {
+        tail = next;
+        num_values--;
+      }
+      _free_value = tail->next.load(std::memory_order::relaxed);
+
+      if (last) {
+        last->next.store(head, std::memory_order::relaxed);
+      } else {
+        first = head;
+      }
+      last = tail;
+    }
+
+    last->next.store(nullptr, std::memory_order::relaxed);
+    return first;
+  }
+
+  template <bool AllowAllocation>
+  bool refill_free_values() noexcept(!AllowAllocation) CORO_THREAD_REQUIRES(_free_value_mutex) {
+    if constexpr (is_single_consumer) {
+      // take all values that were returned by consumer
+      _free_value = _returned_values.exchange(nullptr, std::memory_order::acquire);
+      if (_free_value) {
+        // producer can't see when consumer drains the queue, so extra banks are released when returned values are taken
+        trim_banks_lazily();
+      }
+      if (_free_value) {
+        return true;
+      }
+    }
+
+    if constexpr (AllowAllocation) {
+      allocate_new_bank();
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  // links chain of constructed values to the end of the queue
+  void link_values(value* first, value* last) noexcept {
+    if constexpr (is_single_consumer) {
+      value* prev;  // NOLINT(*-init-*)
+      if constexpr (Policy::multi_producer) {
+        prev = _tail.exchange(last, std::memory_order::acq_rel);
+      } else {
+        prev = _tail.load(std::memory_order::relaxed);
+        _tail.store(last, std::memory_order::relaxed);
+      }
+      prev->next.store(first, std::memory_order::release);
+    } else {
+      unique_lock lock{_value_mutex};
+
+      value* expected_to_set = nullptr;
+      _head.compare_exchange_strong(expected_to_set, first, std::memory_order::relaxed);
+      if (_last) {
+        _last->next.store(first, std::memory_order::relaxed);
+      }
+      _last = last;
+    }
+  }
+
+  // returns chain of free values back to producers
+  void recycle_values(value* first, value* last) noexcept {
+    if constexpr (is_single_consumer) {
+      value* top = _returned_values.load(std::memory_order::relaxed);
+      do {
+        last->next.store(top, std::memory_order::relaxed);
+      } while (!_returned_values.compare_exchange_weak(top, first, std::memory_order::release, std::memory_order::relaxed));
+    } else {
+      unique_lock lock{_free_value_mutex};
+      last->next.store(_free_value, std::memory_order::relaxed);
+      _free_value = first;
+    }
+  }
+
   void allocate_new_bank() CORO_THREAD_REQUIRES(_free_value_mutex) {
-    _additional_banks.emplace_back(std::make_unique<values_bank>());
+    auto* resource = _additional_banks.get_allocator().resource();
+    _additional_banks.emplace_back(std::pmr::polymorphic_allocator<values_bank>{resource}.template new_object<values_bank>(), bank_deleter{resource});
     _free_value = std::addressof(_additional_banks.back()->values[0]);
+    _num_banks.store(_additional_banks.size() + 1, std::memory_order::relaxed);
   }
 
- private:
-  light_mutex _free_value_mutex;
+  // called by consumer of multi consumer queue when queue becomes empty
+  void try_trim_banks() noexcept {
+    if (_num_banks.load(std::memory_order::relaxed) <= _retained_banks.load(std::memory_order::relaxed)) [[likely]] {
+      return;
+    }
+
+    // don't wait for producers here, trimming will be done on the next drain
+    unique_lock lock{_free_value_mutex, std::defer_lock};
+    if (lock.try_lock()) {
+      trim_banks_lazily();
+    }
+  }
+
+  void trim_banks_lazily() noexcept CORO_THREAD_REQUIRES(_free_value_mutex) {
+    const auto retained_banks = _retained_banks.load(std::memory_order::relaxed);
+    if (_num_banks.load(std::memory_order::relaxed) <= retained_banks) {
+      return;
+    }
+
+    if (_trim_backoff != 0) {
+      _trim_backoff--;
+      return;
+    }
+
+    if (!release_free_banks(retained_banks)) {
+      // some banks are still in use, skip next drains instead of walking free values every time
+      _trim_backoff = BlockSize;
+    }
+  }
+
+  // releases fully free additional banks until there are max_banks banks. Returns true if the target was reached
+  bool release_free_banks(std::size_t max_banks) noexcept CORO_THREAD_REQUIRES(_free_value_mutex) {
+    // the head bank is never released
+    if (_additional_banks.size() + 1 <= max_banks) {
+      return true;
+    }
+
+    if constexpr (is_single_consumer) {
+      // values returned by consumer should be counted too
+      if (value* returned = _returned_values.exchange(nullptr, std::memory_order::acquire)) {
+        value* last = returned;
+        while (value* next = last->next.load(std::memory_order::relaxed)) {
+          last = next;
+        }
+        last->next.store(_free_value, std::memory_order::relaxed);
+        _free_value = returned;
+      }
+    }
+
+    std::ranges::sort(_additional_banks, std::less<>{}, &get_bank_values);
+
+    for (auto& bank : _additional_banks) {
+      bank->num_free_values = 0;
+    }
+
+    for (value* val = _free_value; val != nullptr; val = val->next.load(std::memory_order::relaxed)) {
+      if (auto* bank = find_additional_bank(val)) {
+        bank->num_free_values++;
+      }
+    }
+
+    // only banks that keep BlockSize free values after this loop will be released
+    auto num_to_release = _additional_banks.size() + 1 - max_banks;
+    for (auto& bank : _additional_banks) {
+      if (bank->num_free_values != BlockSize) {
+        continue;
+      }
+      if (num_to_release == 0) {
+        bank->num_free_values = 0;
+      } else {
+        num_to_release--;
+      }
+    }
+
+    // unlink values of released banks from the list of free values
+    value* first_kept = nullptr;
+    value* last_kept = nullptr;
+    for (value* val = _free_value; val != nullptr; val = val->next.load(std::memory_order::relaxed)) {
+      const auto* bank = find_additional_bank(val);
+      if (bank && bank->num_free_values == BlockSize) {
+        continue;
+      }
+
+      if (last_kept) {
+        last_kept->next.store(val, std::memory_order::relaxed);
+      } else {
+        first_kept = val;
+      }
+      last_kept = val;
+    }
+    if (last_kept) {
+      last_kept->next.store(nullptr, std::memory_order::relaxed);
+    }
+    _free_value = first_kept;
+
+    std::erase_if(_additional_banks, [](const auto& bank) { return bank->num_free_values == BlockSize; });
+    _num_banks.store(_additional_banks.size() + 1, std::memory_order::relaxed);
+
+    return num_to_release == 0;
+  }
+
+  static const value* get_bank_values(const bank_ptr& bank) noexcept {
+    return bank->values.data();
+  }
 
-  values_bank _head_bank;
-  value* _free_value CORO_THREAD_GUARDED_BY(_free_value_mutex) = std::addressof(_head_bank.values[0]);
+  // returns additional bank that owns the value. Banks should be sorted by address
+  values_bank* find_additional_bank(const value* val) noexcept CORO_THREAD_REQUIRES(_free_value_mutex) {
+    auto it = std::ranges::upper_bound(_additional_banks, val, std::less<>{}, &get_bank_values);
+    if (it == _additional_banks.begin()) {
+      return nullptr;
+    }
+
+    auto& bank = *(--it);
+    if (std::less<>{}(val, bank->values.data() + BlockSize)) {
+      return bank.get();
+    }
+    return nullptr;
+  }
 
-  light_mutex _value_mutex;
+ private:
+  // Producers state. Producers of single consumer queue touch only this cache line on the fast path
+  alignas(producer_mutex) alignas(state_alignment) producer_mutex _free_value_mutex;
+  value* _free_value CORO_THREAD_GUARDED_BY(_free_value_mutex) = std::addressof(_head_bank.values[is_single_consumer ? 1 : 0]);
+  std::pmr::vector<bank_ptr> _additional_banks CORO_THREAD_GUARDED_BY(_free_value_mutex);
+  std::uint32_t _trim_backoff CORO_THREAD_GUARDED_BY(_free_value_mutex) = 0;
+  std::atomic_size_t _num_banks = 1;
+  std::atomic_size_t _retained_banks = std::numeric_limits<std::size_t>::max();
+
+  // used only by single consumer queue. Last linked value
+  std::atomic<value*> _tail = is_single_consumer ? std::addressof(_head_bank.values[0]) : nullptr;
+
+  // Linked values. Multi consumer queue also links pushed values under _value_mutex
+  alignas(light_mutex) alignas(state_alignment) light_mutex _value_mutex;
   value* _last CORO_THREAD_GUARDED_BY(_value_mutex) = nullptr;
 
-  std::vector<std::unique_ptr<values_bank>> _additional_banks CORO_THREAD_GUARDED_BY(_free_value_mutex);
+  // For single consumer queue it points to stub value which next is the first value in queue
+  std::atomic<value*> _head = is_single_consumer ? std::addressof(_head_bank.values[0]) : nullptr;
+
+  // used only by single consumer queue. Values that were released by consumer and not yet taken by producers
+  alignas(std::atomic<value*>) alignas(state_alignment) std::atomic<value*> _returned_values = nullptr;
 
-  // moved to end to minify false sharing effects with other atomics
-  std::atomic<value*> _head = nullptr;
+  // preallocated values don't share cache lines with the state above
+  alignas(values_bank) alignas(state_alignment) values_bank _head_bank;
 };
 
+ASYNC_CORO_WARNINGS_MSVC_POP
+
 };  // namespace async_coro
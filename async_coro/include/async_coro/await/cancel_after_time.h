@@ -37,4 +37,24 @@ inline auto cancel_after_time(std::chrono::steady_clock::duration sleep_duration
   return internal::cancel_after_time{sleep_duration, execution_q};
 }
 
+/**
+ * @brief Requests cancel of current task after some time with tolerance
+ *
+ * Cancel can happen up to `slack` later than requested, so many timeouts can be handled by one timer wakeup
+ *
+ * @return An awaitable of void
+ */
+inline auto cancel_after_time(std::chrono::steady_clock::duration sleep_duration, timer_slack slack) noexcept {
+  return internal::cancel_after_time{sleep_duration, slack};
+}
+
+/**
+ * @brief Requests cancel of current task after some time with tolerance. Cancellation is happening on provided execution_q
+ *
+ * @return An awaitable of void
+ */
+inline auto cancel_after_time(std::chrono::steady_clock::duration sleep_duration, execution_queue_mark execution_q, timer_slack slack) noexcept {
+  return internal::cancel_after_time{sleep_duration, execution_q, slack};
+}
+
 }  // namespace async_coro
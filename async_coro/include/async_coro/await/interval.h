@@ -0,0 +1,210 @@
+#pragma once
+
+#include <async_coro/base_handle.h>
+#include <async_coro/config.h>
+#include <async_coro/execution_queue_mark.h>
+#include <async_coro/executor_data.h>
+#include <async_coro/i_execution_system.h>
+#include <async_coro/internal/base_handle_ptr.h>
+#include <async_coro/runtime_clock.h>
+#include <async_coro/scheduler.h>
+#include <async_coro/utils/callback_on_stack.h>
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace async_coro {
+
+/**
+ * @brief Awaitable that resumes a coroutine on ticks of a fixed period
+ *
+ * Unlike a loop of `co_await async_coro::sleep(period)` the interval is registered in the execution system
+ * once with i_execution_system::plan_periodic and is re-armed in place on every tick. Ticks happen on absolute
+ * time points start + N * period, where start is the time of the interval creation, so the schedule doesn't drift
+ * when the coroutine is resumed late.
+ *
+ * Ticks that happen while the coroutine is not awaiting are remembered:
+ * - missed_tick_policy::skip - the next co_await returns immediately, all remembered ticks are merged into one
+ * - missed_tick_policy::burst - every remembered tick makes one co_await return immediately
+ * co_await returns the number of ticks that were consumed by it.
+ *
+ * The interval should be created and awaited inside one coroutine. The periodic task is cancelled
+ * when the interval is destroyed.
+ *
+ * Example usage:
+ * @code
+ * async_coro::interval ticker{std::chrono::seconds{1}};
+ * while (true) {
+ *   co_await ticker;
+ *   send_heartbeat();
+ * }
+ * @endcode
+ */
+class interval {
+  // State shared with the periodic task. Can outlive the interval while the last tick is being executed
+  struct shared_state {
+    std::atomic_uint32_t num_ticks{0};
+
+    // Suspended coroutine. Who takes it out resumes the coroutine
+    std::atomic<base_handle*> waiter{nullptr};
+
+    // Owning pointer to the waiter. Is moved out by who takes the waiter
+    base_handle_ptr waiter_ptr;
+  };
+
+ public:
+  /**
+   * @brief Creates interval that resumes the coroutine on the queue of the coroutine
+   */
+  explicit interval(std::chrono::steady_clock::duration period, missed_tick_policy policy = missed_tick_policy::skip)
+      : _start(runtime_clock::now()),
+        _period(period),
+        _state(std::make_shared<shared_state>()),
+        _policy(policy),
+        _use_parent_q(true) {
+    ASYNC_CORO_ASSERT(period > std::chrono::steady_clock::duration::zero());
+  }
+
+  /**
+   * @brief Creates interval that resumes the coroutine on the specified queue
+   */
+  interval(std::chrono::steady_clock::duration period, execution_queue_mark execution_q, missed_tick_policy policy = missed_tick_policy::skip)
+      : _start(runtime_clock::now()),
+        _period(period),
+        _state(std::make_shared<shared_state>()),
+        _execution_queue(execution_q),
+        _policy(policy),
+        _use_parent_q(false) {
+    ASYNC_CORO_ASSERT(period > std::chrono::steady_clock::duration::zero());
+  }
+
+  interval(const interval&) = delete;
+  interval(interval&&) = delete;
+
+  ~interval() noexcept {
+    if (_execution_system != nullptr) {
+      _execution_system->cancel_execution(_task_id);
+    }
+  }
+
+  interval& operator=(interval&&) = delete;
+  interval& operator=(const interval&) = delete;
+
+  [[nodiscard]] bool await_ready() noexcept {
+    return take_ticks();
+  }
+
+  template <typename U>
+    requires(std::derived_from<U, base_handle>)
+  void await_suspend(std::coroutine_handle<U> handle) {
+    base_handle& promise = handle.promise();
+
+    promise.plan_sleep_on_queue(_execution_queue, base_handle::cancel_callback_ptr{&_on_cancel});
+
+    _state->waiter_ptr = promise.get_owning_ptr();
+    _state->waiter.store(std::addressof(promise), std::memory_order::release);
+
+    if (_was_cancelled.load(std::memory_order::acquire)) {
+      cancel_wait();
+    } else if (_state->num_ticks.load(std::memory_order::acquire) != 0) {
+      // tick came after await_ready and didn't see the waiter
+      if (_state->waiter.exchange(nullptr, std::memory_order::acq_rel) != nullptr) {
+        _execution_system->plan_execution(
+            [ptr = std::move(_state->waiter_ptr)](const executor_data& data) {
+              ptr->continue_after_sleep(data.get_owning_thread());
+            },
+            _execution_queue);
+      }
+    }
+  }
+
+  std::uint32_t await_resume() noexcept {
+    if (_num_taken == 0) {
+      take_ticks();
+    }
+    return std::exchange(_num_taken, 0);
+  }
+
+  interval& coro_await_transform(base_handle& parent) {
+    if (_execution_system == nullptr) {
+      if (_use_parent_q) {
+        _execution_queue = parent.get_execution_queue();
+      }
+
+      _execution_system = std::addressof(parent.get_scheduler().get_execution_system());
+      _task_id = _execution_system->plan_periodic(
+          [state = _state](const executor_data& data) {
+            state->num_ticks.fetch_add(1, std::memory_order::release);
+
+            if (auto* waiter = state->waiter.exchange(nullptr, std::memory_order::acq_rel)) {
+              const auto ptr = std::move(state->waiter_ptr);
+              waiter->continue_after_sleep(data.get_owning_thread());
+            }
+          },
+          _execution_queue, _start + _period, _period, _policy);
+    }
+
+    _was_cancelled.store(false, std::memory_order::relaxed);
+    return *this;
+  }
+
+ private:
+  bool take_ticks() noexcept {
+    if (_policy == missed_tick_policy::skip) {
+      _num_taken = _state->num_ticks.exchange(0, std::memory_order::acquire);
+      return _num_taken != 0;
+    }
+
+    auto num_ticks = _state->num_ticks.load(std::memory_order::relaxed);
+    while (num_ticks != 0) {
+      if (_state->num_ticks.compare_exchange_weak(num_ticks, num_ticks - 1, std::memory_order::acquire, std::memory_order::relaxed)) {
+        _num_taken = 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void cancel_wait() noexcept {
+    if (auto* waiter = _state->waiter.exchange(nullptr, std::memory_order::acq_rel)) {
+      const auto ptr = std::move(_state->waiter_ptr);
+
+      // continue execution to run cancel logic
+      waiter->continue_after_sleep();
+    }
+    // else continue will be called by the tick
+  }
+
+ private:
+  class cancel_callback : public callback_on_stack<cancel_callback, base_handle::cancel_callback> {
+   public:
+    void on_execute_and_destroy() {
+      auto& awaiter = this->get_owner(&interval::_on_cancel);
+
+      // turn on flag first, as await_suspend will read it after publishing the waiter
+      awaiter._was_cancelled.store(true, std::memory_order::release);
+
+      awaiter.cancel_wait();
+    }
+  };
+
+ private:
+  i_execution_system* _execution_system = nullptr;
+  cancel_callback _on_cancel;
+  const std::chrono::steady_clock::time_point _start;
+  const std::chrono::steady_clock::duration _period;
+  std::shared_ptr<shared_state> _state;
+  delayed_task_id _task_id;
+  std::uint32_t _num_taken = 0;
+  std::atomic_bool _was_cancelled{false};
+  execution_queue_mark _execution_queue = async_coro::execution_queues::any;
+  const missed_tick_policy _policy;
+  bool _use_parent_q;
+};
+
+}  // namespace async_coro
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <async_coro/internal/await_blocking.h>
+
+#include <type_traits>
+#include <utility>
+
+namespace async_coro {
+
+/**
+ * @brief Awaitable helper: run a blocking function on the blocking pool
+ *
+ * Returns an awaitable that executes `func` on a thread of the blocking pool of the execution system,
+ * so calls that block in the kernel (file IO, DNS, legacy synchronous APIs) don't hold back workers.
+ * The coroutine is resumed on its execution queue with the result of `func`.
+ * Exceptions thrown by `func` are rethrown from co_await.
+ *
+ * Usage:
+ * @code
+ * std::string content = co_await async_coro::run_blocking([&] { return read_file(path); });
+ * @endcode
+ */
+template <typename F>
+  requires(std::is_invocable_v<std::decay_t<F>&>)
+inline auto run_blocking(F&& func) noexcept(std::is_nothrow_constructible_v<std::decay_t<F>, F&&>) {
+  return internal::await_blocking<std::decay_t<F>>{std::forward<F>(func)};
+}
+
+}  // namespace async_coro
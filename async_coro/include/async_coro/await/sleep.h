@@ -39,4 +39,26 @@ inline auto sleep(std::chrono::steady_clock::duration sleep_duration, execution_
   return internal::await_sleep{sleep_duration, execution_q};
 }
 
+/**
+ * @brief Awaitable helper: sleep for a relative duration with tolerance
+ *
+ * The coroutine can be resumed up to `slack` later than requested, which lets the
+ * execution system resume many sleeping coroutines after one timer wakeup.
+ *
+ * Example:
+ * @code
+ * co_await async_coro::sleep(std::chrono::seconds{1}, async_coro::timer_slack{std::chrono::milliseconds{50}});
+ * @endcode
+ */
+inline auto sleep(std::chrono::steady_clock::duration sleep_duration, timer_slack slack) noexcept {
+  return internal::await_sleep{sleep_duration, slack};
+}
+
+/**
+ * @brief Awaitable helper: sleep for a relative duration with tolerance and resume on a specific queue
+ */
+inline auto sleep(std::chrono::steady_clock::duration sleep_duration, execution_queue_mark execution_q, timer_slack slack) noexcept {
+  return internal::await_sleep{sleep_duration, execution_q, slack};
+}
+
 }  // namespace async_coro
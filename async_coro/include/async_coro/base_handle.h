@@ -4,13 +4,15 @@
 #include <async_coro/execution_queue_mark.h>
 #include <async_coro/internal/base_handle_ptr.h>
 #include <async_coro/internal/coroutine_suspender.h>
+#include <async_coro/thread_index.h>
 #include <async_coro/utils/callback_fwd.h>
 #include <async_coro/utils/callback_ptr.h>
 
 #include <atomic>
+#include <chrono>
 #include <coroutine>
 #include <cstdint>
-#include <thread>
+#include <memory_resource>
 
 namespace async_coro {
 
@@ -153,7 +155,7 @@ class base_handle {
    * @note This method is useful for determining if immediate execution is safe
    * @note The result may change if the coroutine switches execution contexts
    */
-  [[nodiscard]] bool is_execution_thread_same(std::thread::id thread_id) const noexcept {
+  [[nodiscard]] bool is_execution_thread_same(thread_index thread_id) const noexcept {
     return _execution_thread.load(std::memory_order::relaxed) == thread_id;
   }
 
@@ -255,7 +257,7 @@ class base_handle {
    *
    * @note Should be called from thread that fits execution_queue
    */
-  void continue_after_sleep(std::thread::id current_thread = std::this_thread::get_id());
+  void continue_after_sleep(thread_index current_thread = thread_index::current());
 
   /**
    * @brief Returns the current execution queue for this coroutine
@@ -273,6 +275,34 @@ class base_handle {
     return _execution_queue;
   }
 
+  /**
+   * @brief Returns memory resource of the scheduler for callbacks of the coroutine
+   *
+   * @return Resource of the scheduler or the default resource if the coroutine wasn't added to a scheduler
+   */
+  [[nodiscard]] std::pmr::memory_resource* get_memory_resource() const noexcept;
+
+  /**
+   * @brief Returns deadline of the coroutine
+   *
+   * Continuations of the coroutine planned by the scheduler carry this deadline, so deadline queues
+   * resume coroutines with the earliest deadline first. Embedded coroutines get deadline of their parent.
+   *
+   * @return Time point or steady_clock::time_point::max() if the coroutine has no deadline
+   */
+  [[nodiscard]] std::chrono::steady_clock::time_point get_deadline() const noexcept {
+    return _deadline;
+  }
+
+  /**
+   * @brief Sets deadline of the coroutine
+   *
+   * @note Should be called from the thread that runs the coroutine or before the coroutine is started
+   */
+  void set_deadline(std::chrono::steady_clock::time_point deadline) noexcept {
+    _deadline = deadline;
+  }
+
   /**
    * @brief Returns object that manages current suspension
    *
@@ -417,7 +447,7 @@ class base_handle {
   };
 
   // returns true if loop was exclusively locked
-  defer_leave enter_update_loop(internal::scheduled_run_data& run_data, internal::scheduled_run_data*& current_data, std::thread::id current_thread) noexcept;
+  defer_leave enter_update_loop(internal::scheduled_run_data& run_data, internal::scheduled_run_data*& current_data, thread_index current_thread) noexcept;
 
   // leaves update loop
   void leave_update_loop() noexcept;
@@ -479,11 +509,13 @@ class base_handle {
   cancel_callback_atomic_ptr _on_cancel = nullptr;
   // Currently awaiting child coroutine. Used for cancel notifications
   base_handle_ptr _current_child = nullptr;
+  // Deadline of planned continuations
+  std::chrono::steady_clock::time_point _deadline = std::chrono::steady_clock::time_point::max();
   execution_queue_mark _execution_queue = execution_queues::any;
   std::atomic_uint8_t _atomic_state{0};
   // They get changed synchronously with state so no false sharing
   std::atomic<internal::scheduled_run_data*> _run_data{nullptr};
-  std::atomic<std::thread::id> _execution_thread;
+  std::atomic<thread_index> _execution_thread;
 
   static_assert(decltype(_execution_thread)::is_always_lock_free, "Wrong platform/compiler?");
   static_assert(decltype(_run_data)::is_always_lock_free, "Wrong platform/compiler?");
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <async_coro/config.h>
+#include <async_coro/internal/hardware_interference_size.h>
+#include <async_coro/warnings.h>
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <type_traits>
+
+namespace async_coro {
+
+ASYNC_CORO_WARNINGS_MSVC_PUSH
+ASYNC_CORO_WARNINGS_MSVC_IGNORE(4324)
+
+/**
+ * @brief A lock free bounded queue based on a ring buffer of sequence numbered cells.
+ * Every cell stores a sequence number that tells producers and consumers whether the cell is ready for them,
+ * so push and pop need a single CAS on the shared position and never take a lock.
+ * This queue is designed to be used in multi producer/multi consumer scenarios.
+ * @tparam T The type of the values to be stored in the queue.
+ */
+template <typename T>
+class bounded_atomic_queue {
+  static_assert(std::is_nothrow_destructible_v<T>, "Values of bounded_atomic_queue should be nothrow destructible");
+
+  union union_store {
+    T value;
+    char tmp_byte;
+
+    union_store() noexcept {}  // NOLINT(*member-init)
+    union_store(const union_store&) = delete;
+    union_store(union_store&&) = delete;
+    ~union_store() noexcept {}
+
+    union_store& operator=(const union_store&) = delete;
+    union_store& operator=(union_store&&) = delete;
+  };
+
+  struct cell {
+    std::atomic_size_t sequence;
+    union_store val;
+  };
+
+  using t_diff = std::make_signed_t<std::size_t>;
+
+ public:
+  /**
+   * @brief Construct a new bounded atomic queue object
+   * @param capacity Max number of values in the queue. Will be rounded up to the next power of 2.
+   * @param resource Memory resource used to allocate the ring. Should outlive the queue.
+   */
+  explicit bounded_atomic_queue(std::uint32_t capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : _mask(std::bit_ceil(capacity < 2 ? 2U : capacity) - 1),
+        _allocator(resource),
+        _cells(_allocator.allocate(_mask + 1)) {
+    for (std::size_t i = 0; i <= _mask; i++) {
+      _allocator.construct(std::addressof(_cells[i]));
+      _cells[i].sequence.store(i, std::memory_order::relaxed);
+    }
+  }
+
+  bounded_atomic_queue(const bounded_atomic_queue&) = delete;
+  bounded_atomic_queue(bounded_atomic_queue&&) = delete;
+
+  /**
+   * @brief Destroy the bounded atomic queue object and all the values that are still in it.
+   */
+  ~bounded_atomic_queue() noexcept {
+    auto pos = _dequeue_pos.load(std::memory_order::acquire);
+    const auto end = _enqueue_pos.load(std::memory_order::acquire);
+
+    for (; pos != end; pos++) {
+      auto& cell = _cells[pos & _mask];
+      if (cell.sequence.load(std::memory_order::acquire) == pos + 1) {
+        std::destroy_at(std::addressof(cell.val.value));
+      }
+    }
+
+    std::destroy_n(_cells, _mask + 1);
+    _allocator.deallocate(_cells, _mask + 1);
+  }
+
+  bounded_atomic_queue& operator=(const bounded_atomic_queue&) = delete;
+  bounded_atomic_queue& operator=(bounded_atomic_queue&&) = delete;
+
+  /**
+   * @brief Pushes a new value to the queue.
+   * If the queue is full this method yields current thread until some consumer frees a cell.
+   * @tparam U The types of the arguments to be forwarded to the constructor of T.
+   * @param v The arguments to be forwarded to the constructor of T.
+   */
+  template <typename... U>
+  void push(U&&... val) noexcept {
+    cell* cell = nullptr;
+    std::size_t pos = 0;
+
+    while (!try_acquire_push_cell(cell, pos)) {
+      std::this_thread::yield();
+    }
+
+    publish(*cell, pos, std::forward<U>(val)...);
+  }
+
+  /**
+   * @brief Tries to push a new value to the queue.
+   * @tparam U The types of the arguments to be forwarded to the constructor of T.
+   * @param v The arguments to be forwarded to the constructor of T.
+   * @return true if the value was pushed successfully, false if the queue is full.
+   */
+  template <typename... U>
+  bool try_push(U&&... val) noexcept {
+    cell* cell = nullptr;
+    std::size_t pos = 0;
+
+    if (!try_acquire_push_cell(cell, pos)) {
+      return false;
+    }
+
+    publish(*cell, pos, std::forward<U>(val)...);
+    return true;
+  }
+
+  /**
+   * @brief Tries to pop a value from the queue.
+   * @param v The reference to the value where the popped value will be moved to.
+   * @return true if a value was popped successfully, false otherwise.
+   */
+  bool try_pop(T& val) noexcept {
+    static_assert(std::is_nothrow_move_assignable_v<T>, "Values of bounded_atomic_queue should be nothrow move assignable");
+
+    auto pos = _dequeue_pos.load(std::memory_order::relaxed);
+    cell* cell = nullptr;
+
+    while (true) {
+      cell = std::addressof(_cells[pos & _mask]);
+      const auto seq = cell->sequence.load(std::memory_order::acquire);
+      const auto diff = static_cast<t_diff>(seq) - static_cast<t_diff>(pos + 1);
+      if (diff == 0) {
+        if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // queue is empty
+        return false;
+      } else {
+        pos = _dequeue_pos.load(std::memory_order::relaxed);
+      }
+    }
+
+    val = std::move(cell->val.value);
+    std::destroy_at(std::addressof(cell->val.value));
+
+    // make cell available for producer on the next lap
+    cell->sequence.store(pos + _mask + 1, std::memory_order::release);
+
+    return true;
+  }
+
+  /**
+   * @brief Checks if the queue has any values.
+   * @return true if the queue has any values, false otherwise.
+   */
+  [[nodiscard]] bool has_value() const noexcept {
+    const auto pos = _dequeue_pos.load(std::memory_order::relaxed);
+    return _cells[pos & _mask].sequence.load(std::memory_order::relaxed) == pos + 1;
+  }
+
+  /**
+   * @brief Returns max number of values that can be stored in the queue.
+   */
+  [[nodiscard]] std::size_t capacity() const noexcept { return _mask + 1; }
+
+ private:
+  bool try_acquire_push_cell(cell*& cell, std::size_t& pos) noexcept {
+    pos = _enqueue_pos.load(std::memory_order::relaxed);
+
+    while (true) {
+      cell = std::addressof(_cells[pos & _mask]);
+      const auto seq = cell->sequence.load(std::memory_order::acquire);
+      const auto diff = static_cast<t_diff>(seq) - static_cast<t_diff>(pos);
+      if (diff == 0) {
+        if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed)) {
+          return true;
+        }
+      } else if (diff < 0) {
+        // queue is full
+        return false;
+      } else {
+        pos = _enqueue_pos.load(std::memory_order::relaxed);
+      }
+    }
+  }
+
+  template <typename... U>
+  static void publish(cell& cell, std::size_t pos, U&&... val) noexcept {
+    // cell is already owned by us so constructor can't throw here or the queue will be stuck on this cell
+    static_assert(std::is_nothrow_constructible_v<T, U&&...>, "Values of bounded_atomic_queue should be nothrow constructible");
+
+    new (std::addressof(cell.val.value)) T{std::forward<U>(val)...};
+    cell.sequence.store(pos + 1, std::memory_order::release);
+  }
+
+ private:
+  const std::size_t _mask;
+  std::pmr::polymorphic_allocator<cell> _allocator;
+  cell* const _cells;
+
+  // producers and consumers positions live on separate cache lines to avoid false sharing between them
+  alignas(std::hardware_constructive_interference_size) std::atomic_size_t _enqueue_pos{0};
+  alignas(std::hardware_constructive_interference_size) std::atomic_size_t _dequeue_pos{0};
+};
+
+ASYNC_CORO_WARNINGS_MSVC_POP
+
+}  // namespace async_coro
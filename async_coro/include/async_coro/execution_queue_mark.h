@@ -211,6 +211,19 @@ class execution_thread_mask {
     return execution_thread_mask{other._mask & _mask};
   }
 
+  /**
+   * @brief Equality comparison operator
+   *
+   * @param other The thread mask to compare with
+   * @return true if both masks allow exactly the same queues, false otherwise
+   *
+   * @note This operator is constexpr for compile-time evaluation
+   * @note This operator is noexcept and will not throw exceptions
+   */
+  constexpr bool operator==(execution_thread_mask other) const noexcept {
+    return _mask == other._mask;
+  }
+
  private:
   /** @brief The underlying bit mask representing allowed execution queues */
   std::uint32_t _mask;
@@ -1,21 +1,34 @@
 #pragma once
 
-#include <async_coro/atomic_queue.h>
 #include <async_coro/executor_data.h>
 #include <async_coro/i_execution_system.h>
+#include <async_coro/internal/adaptive_spin.h>
+#include <async_coro/internal/blocking_pool.h>
 #include <async_coro/internal/hardware_interference_size.h>
+#include <async_coro/internal/high_resolution_timer.h>
+#include <async_coro/internal/task_slot.h>
+#include <async_coro/internal/timing_wheel.h>
+#include <async_coro/internal/task_queue_storage.h>
+#include <async_coro/numa_topology.h>
+#include <async_coro/runtime_clock.h>
+#include <async_coro/thread_index.h>
 #include <async_coro/thread_notifier.h>
 #include <async_coro/thread_safety/analysis.h>
 #include <async_coro/thread_safety/condition_variable.h>
 #include <async_coro/thread_safety/mutex.h>
+#include <async_coro/utils/thread_scheduling.h>
 #include <async_coro/utils/unique_function.h>
 #include <async_coro/warnings.h>
+#include <async_coro/work_stealing_deque.h>
 
 #include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <string>
 #include <thread>
 #include <utility>
@@ -23,6 +36,16 @@
 
 namespace async_coro {
 
+/**
+ * @brief Strategy of a worker that has no tasks
+ */
+enum class worker_idle_policy : std::uint8_t {
+  // Worker does num_loops_before_sleep empty loops and parks
+  fixed_loops,
+  // Worker spins with exponential backoff for a time budget and parks. Budget is tuned online by observed wakeup latency and idle durations
+  adaptive,
+};
+
 /**
  * @brief Configuration for a single execution thread
  *
@@ -57,8 +80,115 @@ struct execution_thread_config {
   // Bit mask defining which execution queues this thread is allowed to process
   execution_thread_mask allowed_tasks = execution_queues::worker | execution_queues::any;
 
-  // Num empty worker loops to do before going to sleep on notifier
+  // Num empty worker loops in a row to do before going to sleep on notifier
   std::size_t num_loops_before_sleep = 30;  // NOLINT(*-magic-*)
+
+  // What the worker does when it has no tasks
+  worker_idle_policy idle_policy = worker_idle_policy::fixed_loops;
+
+  // Bounds of the spin budget with adaptive idle policy
+  std::chrono::nanoseconds min_spin_duration = std::chrono::microseconds{1};
+  std::chrono::nanoseconds max_spin_duration = std::chrono::microseconds{100};  // NOLINT(*-magic-*)
+
+  // CPU set, scheduling policy and nice value applied when the thread starts
+  thread_scheduling scheduling{};
+
+  // Index of the NUMA node of the thread or numa_topology::no_node. The thread runs on CPUs of the node
+  // if scheduling.cpu_set is empty and takes tasks of numa queues from its node first
+  std::uint32_t numa_node = numa_topology::no_node;
+};
+
+/**
+ * @brief Configuration of an elastic group of worker threads
+ *
+ * The group starts min_workers threads with the system. More threads up to max_workers are started while tasks
+ * of the group queues wait for a free worker longer than spawn_delay. Threads above min_workers exit after they
+ * were parked for idle_timeout. Slots of all max_workers threads are allocated upfront.
+ */
+struct execution_worker_group_config {
+  // Configuration of every thread of the group. Its name is used as prefix of thread names
+  execution_thread_config worker{"worker"};
+
+  // Number of threads that run all the time
+  std::uint32_t min_workers = 0;
+
+  // Max number of running threads
+  std::uint32_t max_workers = 1;
+
+  // Time tasks should stay in the group queues without a free worker before one more thread is started
+  std::chrono::nanoseconds spawn_delay = std::chrono::milliseconds{1};
+
+  // Time a thread above min_workers stays parked before it exits
+  std::chrono::nanoseconds idle_timeout = std::chrono::seconds{1};
+};
+
+/**
+ * @brief Configuration of the pool of threads for blocking tasks
+ *
+ * Pool threads execute tasks planned with plan_blocking() (e.g. by run_blocking awaitable) and are not counted as workers.
+ * Threads are started when a task finds all pool threads busy and exit after they waited for tasks for idle_timeout.
+ */
+struct execution_blocking_pool_config {
+  // Max number of pool threads. Tasks that find all of them busy wait in FIFO order. Zero turns the pool off,
+  // blocking tasks are planned on the worker queue then
+  std::uint32_t max_threads = 64;  // NOLINT(*-magic-*)
+
+  // Time a pool thread waits for tasks before it exits
+  std::chrono::nanoseconds idle_timeout = std::chrono::seconds{10};  // NOLINT(*-magic-*)
+
+  // Name of pool threads
+  std::string name = "blocking";
+};
+
+/**
+ * @brief Type of container that stores tasks of an execution queue
+ */
+enum class execution_queue_type : std::uint8_t {
+  // Unbounded queue (atomic_queue). Queues with only one consumer thread automatically use lock free mpsc policy
+  unbounded,
+  // Lock free ring buffer (bounded_atomic_queue). Tasks that don't fit in the ring are stored in unbounded overflow queue
+  bounded,
+  // Unbounded queue sharded by producer threads (sharded_atomic_queue). Reduces contention when many threads plan tasks
+  // to the same queue. Tasks are executed in FIFO order only within one producer thread
+  sharded,
+  // Unbounded queue sharded by NUMA nodes. Tasks are pushed to the node of the planning thread, workers take tasks
+  // of their node first and tasks of other nodes only when their node has none. Sleeping workers of the planning
+  // thread node are woken up first. Tasks are executed in FIFO order only within one node
+  numa,
+  // Queue ordered by task deadlines under a lock (earliest deadline first). Tasks without deadline are executed
+  // after tasks with deadlines in FIFO order. Tasks planned to the queue bypass local deques and LIFO slots of workers
+  deadline,
+};
+
+/**
+ * @brief Configuration for a single execution queue
+ *
+ * Queues without configuration use default values of this struct.
+ */
+struct execution_queue_config {
+  // The execution queue this configuration applies to
+  execution_queue_mark queue;
+
+  // Type of container used to store tasks of the queue
+  execution_queue_type type = execution_queue_type::unbounded;
+
+  // Capacity of the ring buffer for bounded queues. Rounded up to the next power of 2
+  std::uint32_t capacity = 1024;  // NOLINT(*-magic-*)
+
+  // Number of shards for sharded queues. If 0 number of hardware threads is used
+  std::uint32_t num_shards = 0;
+
+  // Number of tasks the unbounded storage keeps allocated after the queue was drained. Extra memory is released lazily
+  std::uint32_t retained_capacity = 4096;  // NOLINT(*-magic-*)
+
+  // Share of the queue in the time of threads that serve several queues. On every round a thread takes up to weight
+  // tasks in a row from the queue before it moves to the next one, so under saturation queues are served in proportion
+  // to their weights (deficit round robin with unit task cost). Zero is treated as 1
+  std::uint32_t weight = 1;
+
+  // What workers do with tasks of deadline queues that are taken after their deadline. Continuations of coroutines
+  // are never dropped, they are executed as with keep policy
+  missed_deadline_policy missed_deadline = missed_deadline_policy::keep;
 };
 
 /**
@@ -73,6 +203,103 @@ struct execution_system_config {
 
   // Bit mask defining which execution queues the main thread can process
   execution_thread_mask main_thread_allowed_tasks = execution_queues::main | execution_queues::any;
+
+  // Elastic groups of worker threads. Their threads follow worker_configs in worker indexes, group by group
+  std::vector<execution_worker_group_config> worker_groups{};
+
+  // Pool of threads for blocking tasks. Its threads don't serve execution queues
+  execution_blocking_pool_config blocking_pool{};
+
+  // NUMA topology for numa queues and workers with numa_node. Is discovered from the system if not set
+  std::optional<numa_topology> topology{};
+
+  // Per queue configurations. Queues without configuration use default execution_queue_config values
+  std::vector<execution_queue_config> queue_configs{};
+
+  // Memory resource for task queues, delayed tasks and executor data. If nullptr std::pmr::get_default_resource() is used.
+  // Should outlive the execution system
+  std::pmr::memory_resource *memory_resource = nullptr;
+
+  // Enables work stealing mode. Tasks planned from a worker are pushed to its local deque,
+  // idle workers steal tasks from workers with the same allowed_tasks mask. Tasks planned from other threads use shared queues
+  bool work_stealing = false;
+
+  // Capacity of the local deque of every worker in work stealing mode. Tasks that don't fit go to the shared queue
+  std::uint32_t local_queue_capacity = 256;  // NOLINT(*-magic-*)
+
+  // Enables LIFO slot of workers. The last task planned from a worker to a queue it serves is stored in the slot
+  // and is executed by this worker right after the current task, the task that was in the slot is planned as usual.
+  // Idle workers with the same allowed_tasks mask can steal tasks from the slot
+  bool lifo_slot = false;
+
+  // Max number of tasks executed from the LIFO slot in a row before the worker serves other tasks
+  std::uint32_t max_lifo_slot_hits = 3;  // NOLINT(*-magic-*)
+
+  // Resolution of the timing wheel of delayed tasks. Delayed tasks are planned no later than one tick after their time
+  std::chrono::steady_clock::duration timer_resolution = std::chrono::milliseconds{1};
+
+  // Slack of delayed tasks planned without explicit timer_slack. Tasks with close time points are executed
+  // after one timer wakeup if their slack windows overlap
+  std::chrono::steady_clock::duration default_timer_slack = std::chrono::steady_clock::duration::zero();
+
+  // Enables high resolution mode of the timer thread. It waits for deadlines on timerfd with absolute CLOCK_MONOTONIC
+  // time points instead of the condition variable and wakes up within microseconds. Lower timer_resolution as well,
+  // delayed tasks are not executed before the tick of the timing wheel. Is ignored with worker_timers and on platforms without timerfd
+  bool high_resolution_timers = false;
+
+  // Final part of every wait that the timer thread spins in high resolution mode. Removes the rest of the kernel
+  // wakeup latency at cost of CPU time. Zero turns spinning off
+  std::chrono::steady_clock::duration timer_spin_duration = std::chrono::steady_clock::duration::zero();
+
+  // CPU set, scheduling policy and nice value of the timer thread. Lets pin it next to the workers it wakes up
+  thread_scheduling timer_thread_scheduling{};
+
+  // Enables timers owned by workers. Every worker keeps its own delayed tasks and sleeps until the nearest of them,
+  // expired tasks are executed right on the worker without extra thread wakeups. Delayed tasks of a queue are spread
+  // between its workers, tasks of queues without workers are planned by any worker. No timer thread is started in this mode
+  bool worker_timers = false;
+
+  // Source of the current time for workers. With cached and coarse modes workers read the clock once per loop iteration
+  // and delayed tasks, sleep and other time based awaitables started from workers use this time
+  clock_mode clock = clock_mode::precise;
+};
+
+/**
+ * @brief Makes configurations of workers_per_node workers for every node of the topology
+ *
+ * Workers are named "<name_prefix>_<node id>_<index>" and are bound to their nodes.
+ */
+std::vector<execution_thread_config> make_numa_worker_configs(const numa_topology &topology, std::uint32_t workers_per_node,
+                                                              execution_thread_mask allowed_tasks, const std::string &name_prefix = "worker");
+
+/**
+ * @brief Counters of the execution system
+ *
+ * Counters are updated with relaxed atomics, values read while tasks are planned are approximate.
+ */
+struct execution_system_stats {
+  // Number of sleeping workers woken up to execute planned tasks
+  std::uint64_t num_wakeups = 0;
+
+  // Number of wakeups skipped as workers searching for tasks could take the planned tasks
+  std::uint64_t num_skipped_wakeups = 0;
+};
+
+/**
+ * @brief Idle time counters of a worker
+ */
+struct execution_worker_stats {
+  // Time the worker spent in empty loops searching for tasks
+  std::chrono::nanoseconds spin_time{};
+
+  // Time the worker spent parked on its notifier
+  std::chrono::nanoseconds park_time{};
+
+  // Number of times the worker was parked
+  std::uint64_t num_parks = 0;
+
+  // Current spin budget of the worker with adaptive idle policy, zero otherwise
+  std::chrono::nanoseconds spin_budget{};
 };
 
 /**
@@ -138,6 +365,28 @@ class execution_system : public i_execution_system {
    */
   void plan_execution(task_function func, execution_queue_mark execution_queue) override;
 
+  /**
+   * @brief Schedules a task for execution on the specified queue before the deadline
+   *
+   * Deadline queues execute the task in order of its deadline, other queues ignore the deadline.
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  void plan_execution(task_function func, execution_queue_mark execution_queue, task_deadline deadline) override;
+
+  /**
+   * @brief Schedules a batch of tasks for execution on the specified queue
+   *
+   * All tasks are pushed to the queue at once and up to funcs.size() sleeping
+   * workers of the queue are woken up.
+   *
+   * @param funcs The task functions to be executed. All functions are moved out of the span
+   * @param execution_queue The execution queue where the tasks should be scheduled
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  void plan_execution_bulk(std::span<task_function> funcs, execution_queue_mark execution_queue) override;
+
   /**
    * @brief Executes a task immediately if possible, otherwise schedules it
    *
@@ -164,16 +413,49 @@ class execution_system : public i_execution_system {
   delayed_task_id plan_execution_after(task_function func, execution_queue_mark execution_queue,
                                        std::chrono::steady_clock::time_point when) override;
 
+  /**
+   * @brief Schedules a task to be executed between the given steady_clock time and time + slack
+   *
+   * Task time is aligned inside the slack window so tasks with overlapping windows share one timer wakeup.
+   * All tasks that expire on one wakeup are pushed to their queues with one bulk push per queue.
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  delayed_task_id plan_execution_after(task_function func, execution_queue_mark execution_queue,
+                                       std::chrono::steady_clock::time_point when, timer_slack slack) override;
+
+  /**
+   * @brief Schedules a task for periodic execution on the specified queue
+   *
+   * The task stays in the timer wheel and is re-armed in place on every tick,
+   * so ticks don't allocate and don't change the id of the task.
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  delayed_task_id plan_periodic(task_function func, execution_queue_mark execution_queue,
+                                std::chrono::steady_clock::time_point first_time,
+                                std::chrono::steady_clock::duration period, missed_tick_policy policy) override;
+
   /**
    * @brief Cancels execution of previously scheduled function
    *
-   * @param task_id delayed_task_id structure returned from 'plan_execution_after'
+   * @param task_id delayed_task_id structure returned from 'plan_execution_after' or 'plan_periodic'
    * @return true if task was cancelled false otherwise
    *
    * @note Thread safety: This method is thread-safe and can be called from any thread
    */
   bool cancel_execution(const delayed_task_id &task_id) override;
 
+  /**
+   * @brief Schedules a blocking task on the blocking pool
+   *
+   * Starts one more pool thread if all of them are busy and execution_blocking_pool_config::max_threads is not reached.
+   * If the pool is turned off or already stopped by destruction of the system, the task is planned on the worker queue.
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  void plan_blocking(task_function func) override;
+
   /**
    * @brief Checks if the current thread can execute tasks from the specified queue
    *
@@ -185,7 +467,7 @@ class execution_system : public i_execution_system {
    *
    * @note This method is useful for determining if immediate execution is possible
    */
-  [[nodiscard]] bool is_thread_fits(execution_queue_mark execution_queue, std::thread::id thread_id) const noexcept override;
+  [[nodiscard]] bool is_thread_fits(execution_queue_mark execution_queue, thread_index thread_id) const noexcept override;
 
   /**
    * @brief Processes one task from the main thread's execution queues
@@ -203,12 +485,26 @@ class execution_system : public i_execution_system {
   /**
    * @brief Returns the current number of worker threads
    *
-   * @return The number of worker threads currently managed by this execution system
+   * @return The number of worker threads currently managed by this execution system. Includes max_workers of every worker group
    *
    * @note This count does not include the main thread
    */
   [[nodiscard]] std::uint32_t get_num_worker_threads() const noexcept { return _num_workers; }
 
+  /**
+   * @brief Returns the number of worker threads that are running now. Threads of worker groups are started and stopped on demand
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  [[nodiscard]] std::uint32_t get_num_running_workers() const noexcept;
+
+  /**
+   * @brief Returns the number of running threads of the blocking pool. They are not included in worker counts
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  [[nodiscard]] std::uint32_t get_num_blocking_threads() const noexcept { return _blocking_pool.get_num_threads(); }
+
   /**
    * @brief Returns the number of workers that can process tasks from the specified queue
    *
@@ -222,6 +518,77 @@ class execution_system : public i_execution_system {
    */
   [[nodiscard]] std::uint32_t get_num_workers_for_queue(execution_queue_mark execution_queue) const noexcept;
 
+  /**
+   * @brief Returns number of memory banks allocated by the unbounded storage of the queue
+   *
+   * Useful for monitoring memory of long running services. Queues release banks above
+   * execution_queue_config::retained_capacity lazily when they become empty.
+   *
+   * @param execution_queue The execution queue to check
+   * @return Number of allocated banks. Each bank holds a fixed number of tasks
+   */
+  [[nodiscard]] std::size_t get_num_allocated_banks(execution_queue_mark execution_queue) const noexcept;
+
+  /**
+   * @brief Returns number of tasks taken from the queue by workers and the main thread
+   *
+   * Lets validate shares of weighted queues under saturation. Tasks executed from local deques and LIFO slots
+   * are not counted as they bypass the queue.
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  [[nodiscard]] std::uint64_t get_num_served_tasks(execution_queue_mark execution_queue) const noexcept;
+
+  /**
+   * @brief Returns number of tasks of the deadline queue that were taken after their deadline and were dropped or demoted.
+   * Is always zero for other queues and with missed_deadline_policy::keep
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  [[nodiscard]] std::uint64_t get_num_missed_deadlines(execution_queue_mark execution_queue) const noexcept;
+
+  /**
+   * @brief Releases all fully free memory banks of all queues
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  void shrink_to_fit() noexcept;
+
+  /**
+   * @brief Returns counters of the system summed over all threads
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  [[nodiscard]] execution_system_stats get_stats() const noexcept;
+
+  /**
+   * @brief Returns idle time counters of the worker. Helps to trade wakeup latency against CPU time spent spinning
+   *
+   * @param worker_index Index of the worker in execution_system_config::worker_configs. Threads of worker groups follow them
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  [[nodiscard]] execution_worker_stats get_worker_stats(std::uint32_t worker_index) const noexcept;
+
+  /**
+   * @brief Returns settings of execution_thread_config::scheduling and timer_thread_scheduling that failed to apply
+   *
+   * Threads with failed settings keep running with the rest of settings applied.
+   * Errors of threads started by the constructor are available right after it.
+   *
+   * @note Thread safety: This method is thread-safe and can be called from any thread
+   */
+  [[nodiscard]] std::vector<thread_scheduling_error> get_scheduling_errors() const;
+
+  /**
+   * @brief Returns NUMA topology used by the system. Is a single node topology if no numa queues and no workers with numa_node are used
+   */
+  [[nodiscard]] const numa_topology &get_numa_topology() const noexcept { return *_numa; }
+
+  /**
+   * @brief Returns memory resource used for internal allocations of the system
+   */
+  [[nodiscard]] std::pmr::memory_resource *get_memory_resource() const noexcept { return _memory_resource; }
+
   /**
    * @brief Returns executor_data used in main update loop
    */
@@ -229,6 +596,52 @@ class execution_system : public i_execution_system {
 
  private:
   struct worker_thread_data;
+  struct task_queue;
+  struct stats_counters;
+  struct worker_group;
+
+  /**
+   * @brief Starts the thread of the worker slot
+   * @param num_threads_to_wait_start Counter of threads the constructor waits for, nullptr for threads started later
+   */
+  void start_worker(worker_thread_data &data, std::atomic<std::size_t> *num_threads_to_wait_start);
+
+  /**
+   * @brief Applies scheduling settings to the calling thread and remembers failed ones
+   */
+  void apply_scheduling(const thread_scheduling &scheduling, const std::string &thread_name);
+
+  /**
+   * @brief Loop of the thread that starts and retires threads of worker groups
+   */
+  void groups_loop();
+
+  /**
+   * @brief Starts one more thread of the group in a free slot
+   */
+  void start_group_worker(worker_group &group);
+
+  /**
+   * @brief Asks workers of the group parked longer than idle_timeout to exit
+   * @return Time point of the next idle timeout check
+   */
+  static std::chrono::steady_clock::time_point retire_idle_workers(worker_group &group, std::chrono::steady_clock::time_point now) noexcept;
+
+  /**
+   * @brief Checks if some group that can start more threads has tasks in its queues
+   */
+  [[nodiscard]] bool has_groups_backlog() const noexcept;
+
+  /**
+   * @brief Wakes up the groups thread as tasks were planned while all workers were busy
+   */
+  void nudge_groups() noexcept;
+
+  /**
+   * @brief Stops the worker of a group whose retirement was requested
+   * @return true if the worker should exit, false if it got tasks or its group can't lose threads
+   */
+  bool try_retire(worker_thread_data &data) noexcept;
 
   /**
    * @brief Main loop for worker threads
@@ -249,32 +662,216 @@ class execution_system : public i_execution_system {
    */
   void timer_loop();
 
+  /**
+   * @brief Sets the time point the timer thread wakes up at
+   */
+  void set_timer_wakeup(std::chrono::steady_clock::time_point time) noexcept CORO_THREAD_REQUIRES(_delayed_mutex);
+
+  /**
+   * @brief Waits for the armed high resolution timer. The last timer_spin_duration before the time point is spun
+   * @param time Deadline the timer is armed for
+   */
+  void wait_high_resolution(std::chrono::steady_clock::time_point time);
+
+  /**
+   * @brief Wakes up sleeping workers of the queue, one per pushed task that searching workers can't take
+   *
+   * Workers are woken in round robin order so the load is spread over all of them.
+   */
+  void notify_workers(task_queue &task_q, std::size_t num_tasks) noexcept;
+
+  /**
+   * @brief Marks the worker as searching for tasks in all its queues. Planned tasks don't wake other workers while it searches
+   */
+  static void begin_searching(worker_thread_data &data) noexcept;
+
+  /**
+   * @brief Removes searching mark of the worker
+   * @param found_task Whether the worker stops searching as it found a task. The last searcher of a queue
+   * that still has tasks wakes up another worker, as wakeups for these tasks could be skipped
+   */
+  void end_searching(worker_thread_data &data, bool found_task) noexcept;
+
+  /**
+   * @brief Ends searching of the worker before it runs a found task, so wakeups skipped for the worker are passed on
+   */
+  void on_task_found(worker_thread_data &data, bool &is_searching) noexcept;
+
+  /**
+   * @brief Returns counters of the current worker or the shared counters for other threads
+   */
+  [[nodiscard]] stats_counters &get_stats_counters() noexcept;
+
+  /**
+   * @brief Returns data of the current thread if it is a worker of this system, nullptr otherwise
+   */
+  [[nodiscard]] worker_thread_data *get_current_worker() const noexcept;
+
+  /**
+   * @brief Pushes the task to the LIFO slot or to the local deque of the current worker
+   *
+   * @return true if the task was planned, false if it should be planned to the shared queue. func is untouched in this case
+   */
+  bool try_plan_local(task_function &func, execution_queue_mark execution_queue);
+
+  /**
+   * @brief Pushes the task to the local deque of the worker in work stealing mode and wakes up one of its peers
+   *
+   * @return true if the task was pushed, false otherwise. func is untouched in this case
+   */
+  static bool try_push_local(worker_thread_data &worker, task_function &func) noexcept;
+
+  /**
+   * @brief Wakes up one sleeping peer of the worker to steal its local tasks
+   */
+  static void notify_peer(worker_thread_data &worker) noexcept;
+
+  /**
+   * @brief Pushes the task to the shared queue and wakes up one of its workers
+   */
+  void plan_shared(task_function &&func, execution_queue_mark execution_queue);
+
+  /**
+   * @brief Steals one task from the peers of the worker and executes it
+   * @param is_searching Searching state of the worker, searching ends before the task runs
+   *
+   * @return true if a task was executed
+   */
+  bool steal_and_execute(worker_thread_data &data, bool &is_searching);
+
+  struct delayed_task;
+  struct periodic_task;
+
+  /**
+   * @brief Adds the delayed task to the timer wheel of the timer thread or of the owner worker and wakes it up if needed
+   *
+   * @param slack Slack of one shot task. Is ignored for periodic tasks
+   */
+  delayed_task_id insert_delayed_task(delayed_task &&task, std::chrono::steady_clock::time_point when, timer_slack slack);
+
+  /**
+   * @brief Plans the next execution of the periodic task whose tick has come
+   *
+   * @param task Periodic task in the timer wheel
+   * @param now Time of the wheel advance
+   * @param expired Container where the task function that executes pending ticks is added to
+   * @return Time point of the next tick
+   */
+  static std::chrono::steady_clock::time_point on_periodic_tick(delayed_task &task, std::chrono::steady_clock::time_point now,
+                                                                std::pmr::vector<delayed_task> &expired);
+
+  /**
+   * @brief Executes pending ticks of the periodic task one after another
+   */
+  static void run_periodic_task(periodic_task &task, const executor_data &data);
+
+  /**
+   * @brief Selects the worker that owns the timer of a delayed task for the queue
+   *
+   * @return Index of the worker in _thread_data
+   */
+  std::uint32_t select_timer_owner(execution_queue_mark execution_queue) noexcept;
+
+  /**
+   * @brief Executes delayed tasks of the worker whose time has come
+   *
+   * @param is_searching Searching state of the worker, searching ends before the first task runs
+   *
+   * @return true if any task was executed or planned
+   */
+  bool run_expired_timers(worker_thread_data &data, bool &is_searching);
+
+  /**
+   * @brief Puts the worker to sleep until notification or the nearest deadline of its timers
+   * @param spin_start Start of the spin before the sleep. Is moved to the wakeup time
+   */
+  static void sleep_worker(worker_thread_data &data, std::chrono::steady_clock::time_point &spin_start) noexcept;
+
+  /**
+   * @brief Checks if the idle worker should stop searching for tasks and park
+   * @param num_empty_loops Number of empty loops in a row including the current one
+   * @param spin_start Start of the current spin
+   */
+  static bool should_park(worker_thread_data &data, std::size_t num_empty_loops, std::chrono::steady_clock::time_point spin_start) noexcept;
+
+  /**
+   * @brief Accounts the finished idle period of the worker and adapts its spin budget
+   */
+  static void end_idle(worker_thread_data &data, std::chrono::steady_clock::time_point idle_start,
+                       std::chrono::steady_clock::time_point spin_start) noexcept;
+
  private:
-  using t_task_id = decltype(std::declval<delayed_task_id>().task_id);
+  // State of the periodic task shared between its timer and its pending execution
+  struct periodic_task {
+    periodic_task(task_function &&task, std::chrono::steady_clock::time_point first, std::chrono::steady_clock::duration tick_period,
+                  missed_tick_policy tick_policy) noexcept
+        : func(std::move(task)),
+          first_time(first),
+          period(tick_period),
+          policy(tick_policy) {}
 
-  // ...internal delayed task handling
-  class delayed_task {
-   public:
     task_function func;
-    t_task_id id;
-    std::chrono::steady_clock::time_point when;
-    execution_queue_mark queue;
-    bool cancel_execution = false;
-
-    delayed_task(task_function &&task,
-                 std::chrono::steady_clock::time_point when_tp,
-                 execution_queue_mark queue_mark,
-                 t_task_id t_id) noexcept
-        : func(std::move(task)),
-          id(t_id),
-          when(when_tp),
-          queue(queue_mark) {}
+    const std::chrono::steady_clock::time_point first_time;
+    const std::chrono::steady_clock::duration period;
+
+    // Number of ticks from first_time to the next tick. Used only under lock of the timer wheel
+    std::int64_t next_tick = 1;
 
-    auto operator<=>(const delayed_task &other) const noexcept { return when <=> other.when; }
+    // Number of ticks that are waiting for execution. Execution is planned when it becomes not 0
+    std::atomic_uint32_t num_pending{0};
+    std::atomic_bool is_cancelled{false};
+
+    const missed_tick_policy policy;
   };
 
-  // Type alias for the task queue using atomic_queue
-  using tasks = atomic_queue<task_function>;
+  // ...internal delayed task handling. Time of the task is stored in the timing wheel
+  struct delayed_task {
+    task_function func;
+    std::shared_ptr<periodic_task> periodic;
+    execution_queue_mark queue{0};
+
+    delayed_task() noexcept = default;
+    delayed_task(task_function &&task, execution_queue_mark queue_mark) noexcept : func(std::move(task)), queue(queue_mark) {}
+    delayed_task(std::shared_ptr<periodic_task> &&task, execution_queue_mark queue_mark) noexcept : periodic(std::move(task)), queue(queue_mark) {}
+  };
+
+  // Type alias for the task queue with configurable container
+  using tasks = internal::task_queue_storage<task_function>;
+
+  // Task in the LIFO slot of a worker. Queue is needed to plan the task as usual when it loses the slot
+  struct slot_task {
+    task_function func;
+    execution_queue_mark queue{0};
+
+    slot_task() noexcept = default;
+    slot_task(task_function &&task, execution_queue_mark queue_mark) noexcept : func(std::move(task)), queue(queue_mark) {}
+  };
+
+  // Delayed tasks of a worker in worker timers mode
+  struct worker_timers {
+    static constexpr auto no_deadline = std::chrono::steady_clock::duration::max().count();
+
+    worker_timers(std::chrono::steady_clock::duration resolution, std::chrono::steady_clock::time_point start,
+                  std::pmr::memory_resource *resource, unsigned id_bits)
+        : tasks(resolution, start, resource, id_bits),
+          expired(resource) {}
+
+    async_coro::mutex mutex;
+
+    internal::timing_wheel<delayed_task> tasks CORO_THREAD_GUARDED_BY(mutex);
+
+    // Time since epoch of the next deadline of tasks. Is read by the worker without lock
+    std::atomic<std::chrono::steady_clock::rep> deadline{no_deadline};
+
+    // Expired tasks that are executed without lock. Used only by the owner worker
+    std::pmr::vector<delayed_task> expired;
+  };
+
+  // Counters of execution_system_stats. Workers update their own counters without contention
+  struct stats_counters {
+    std::atomic_uint64_t num_wakeups{0};
+    std::atomic_uint64_t num_skipped_wakeups{0};
+  };
 
   ASYNC_CORO_WARNINGS_MSVC_PUSH
   ASYNC_CORO_WARNINGS_MSVC_IGNORE(4324)
@@ -298,29 +895,138 @@ class execution_system : public i_execution_system {
     // Pointers to task queues this worker can process
     std::vector<tasks *> task_queues;
 
+    // Task queues this worker can process with their wake state. Has the same order as task_queues
+    std::vector<task_queue *> served_queues;
+
+    // Number of tasks taken by this worker from every queue of task_queues. Written only by the worker
+    // NOLINTNEXTLINE(*-avoid-c-arrays)
+    std::unique_ptr<std::atomic_uint64_t[]> num_served;
+
     // Bit mask defining which execution queues this worker can process
     execution_thread_mask mask;
 
     // Num empty worker loops to do before going to sleep on notifier
     std::size_t num_loops_before_sleep = 0;
+
+    // What the worker does when it has no tasks
+    worker_idle_policy idle_policy = worker_idle_policy::fixed_loops;
+
+    // Spin budget and backoff with adaptive idle policy. Used only by the worker
+    internal::adaptive_spin spin;
+
+    // Idle time counters in nanoseconds. Written only by the worker
+    std::atomic<std::int64_t> spin_time{0};
+    std::atomic<std::int64_t> park_time{0};
+    std::atomic_uint64_t num_parks{0};
+    std::atomic<std::int64_t> spin_budget{0};
+
+    // Tasks planned from this worker in work stealing mode, nullptr otherwise
+    std::unique_ptr<work_stealing_deque<task_function>> local_tasks;
+
+    // Workers with the same mask that steal tasks from this worker and from which this worker steals
+    std::vector<worker_thread_data *> peers;
+
+    // Index of the peer to start the next steal from
+    std::size_t steal_cursor = 0;
+
+    // Index of the peer to start the next wakeup from. Used only by the owner
+    std::size_t wake_cursor = 0;
+
+    // The last task planned from this worker if LIFO slot is enabled
+    internal::task_slot<slot_task> next_task;
+
+    // Delayed tasks owned by this worker in worker timers mode, nullptr otherwise
+    std::unique_ptr<worker_timers> timers;
+
+    // Counters updated by this worker
+    stats_counters stats;
+
+    // Name of the worker thread
+    std::string name;
+
+    // OS level settings applied when a thread starts in the slot
+    thread_scheduling scheduling;
+
+    // Index of the NUMA node of the worker or numa_topology::no_node
+    std::uint32_t numa_node = numa_topology::no_node;
+
+    // Elastic group of the worker, nullptr for workers of worker_configs
+    worker_group *group = nullptr;
+
+    // Index of the thread that runs in the slot, invalid if no thread runs. Is read by is_thread_fits of other threads
+    std::atomic<thread_index> thread_id{};
+
+    // Whether a thread runs in the slot. Is cleared by the exiting thread
+    std::atomic_bool is_running{false};
+
+    // Time since epoch when the worker of a group parked, zero while it runs. Is read by the groups thread
+    std::atomic<std::chrono::steady_clock::rep> parked_since{0};
+
+    // Set by the groups thread when the worker was parked for idle_timeout
+    std::atomic_bool retire_requested{false};
   };
 
-  ASYNC_CORO_WARNINGS_MSVC_POP
+  // Elastic group of workers. Slots of all its threads are allocated upfront so queues never change their workers
+  struct worker_group {
+    std::uint32_t min_workers = 0;
+    std::uint32_t max_workers = 0;
+    std::chrono::nanoseconds spawn_delay{};
+    std::chrono::nanoseconds idle_timeout{};
+
+    // Slots of group threads
+    std::vector<worker_thread_data *> workers;
+
+    // Number of started threads that weren't retired
+    std::atomic_uint32_t num_active{0};
+
+    // Time since tasks wait in the group queues for a free worker, zero if there are no such tasks. Used only by the groups thread
+    std::chrono::steady_clock::time_point backlog_since;
+  };
 
   /**
    * @brief Data structure for managing a single execution queue
    *
    * This struct represents a single execution queue and contains both the
    * queue itself and references to all worker threads that can process it.
+   * Every queue starts on its own cache line so neighbour queues don't share them.
    */
-  struct task_queue {
-    // The actual task queue containing pending tasks
+  struct alignas(std::hardware_constructive_interference_size) task_queue {
+    // Pointers to worker threads that can execute tasks from this queue. Read only after construction
+    std::vector<worker_thread_data *> workers_data;
+
+    // Max number of tasks taken from the queue in a row by one thread. Read only after construction
+    std::uint32_t weight = 1;
+
+    // Whether tasks are ordered by deadlines, so they can't be planned to local deques. Read only after construction
+    bool is_deadline = false;
+
+    // The actual task queue containing pending tasks. Its mutable state is aligned to separate cache lines
     tasks queue;
 
-    // Pointers to worker threads that can execute tasks from this queue
-    std::vector<worker_thread_data *> workers_data;
+    // Number of workers of this queue that are searching for tasks. Is read by every planning thread
+    alignas(std::hardware_constructive_interference_size) std::atomic_uint32_t num_searching{0};
+
+    // Index of the worker to start the next wakeup from
+    std::atomic_uint32_t wake_cursor{0};
+
+    // Whether workers of groups serve this queue, so tasks that found no worker to wake up can start one more thread
+    bool has_worker_groups = false;
+
+    // Workers of numa queues by their nodes. Empty for other queues. Read only after construction
+    std::vector<std::vector<worker_thread_data *>> node_workers;
+
+    // Index of the node worker to start the next node local wakeup from, one per node like node_workers
+    std::vector<std::atomic_uint32_t> node_wake_cursors;
   };
 
+  ASYNC_CORO_WARNINGS_MSVC_POP
+
+  // Resource for all allocations done while tasks are planned and executed
+  std::pmr::memory_resource *const _memory_resource;
+
+  // NUMA topology. Is used by numa queues, so it outlives them
+  std::unique_ptr<numa_topology> _numa;
+
   // Array of task queues, one for each execution queue mark
   // NOLINTNEXTLINE(*-avoid-c-arrays)
   std::unique_ptr<task_queue[]> _tasks_queues;
@@ -328,6 +1034,11 @@ class execution_system : public i_execution_system {
   // Pointers to task queues that the main thread can process
   std::vector<tasks *> _main_thread_queues;
 
+  // Weights of _main_thread_queues and numbers of tasks the main thread took from them
+  std::vector<std::uint32_t> _main_thread_weights;
+  // NOLINTNEXTLINE(*-avoid-c-arrays)
+  std::unique_ptr<std::atomic_uint64_t[]> _main_thread_num_served;
+
   // Array of worker thread data structures
   // NOLINTNEXTLINE(*-avoid-c-arrays)
   std::unique_ptr<worker_thread_data[]> _thread_data;
@@ -344,6 +1055,15 @@ class execution_system : public i_execution_system {
   // Maximum execution queue mark that this system can handle
   const execution_queue_mark _max_q;
 
+  // Whether tasks planned from workers go to their local deques
+  const bool _is_work_stealing;
+
+  // Whether tasks planned from workers go to their LIFO slots
+  const bool _is_lifo_slot;
+
+  // Max number of tasks executed from the LIFO slot in a row
+  const std::uint32_t _max_lifo_slot_hits;
+
   // Atomic flag indicating whether the system is in the process of shutting down
   std::atomic_bool _is_stopping{false};
 
@@ -351,9 +1071,73 @@ class execution_system : public i_execution_system {
   async_coro::mutex _delayed_mutex;
   async_coro::condition_variable _delayed_cv;
 
-  std::vector<delayed_task> _delayed_tasks CORO_THREAD_GUARDED_BY(_delayed_mutex);
+  internal::timing_wheel<delayed_task> _delayed_tasks CORO_THREAD_GUARDED_BY(_delayed_mutex);
+  std::chrono::steady_clock::time_point _timer_wakeup CORO_THREAD_GUARDED_BY(_delayed_mutex) = std::chrono::steady_clock::time_point::max();
+  // Copy of _timer_wakeup that the timer thread reads without lock while it spins
+  std::atomic<std::chrono::steady_clock::rep> _spin_wakeup{std::chrono::steady_clock::time_point::max().time_since_epoch().count()};
   std::thread _timer_thread;
-  t_task_id _delayed_task_id CORO_THREAD_GUARDED_BY(_delayed_mutex) = 1;
+
+  // Timer of the timer thread in high resolution mode, nullptr otherwise
+  std::unique_ptr<internal::high_resolution_timer> _high_res_timer;
+
+  // Final part of the wait that the timer thread spins in high resolution mode
+  const std::chrono::steady_clock::duration _timer_spin;
+
+  // Expired tasks that are pushed to their queues without lock. Used only by the timer thread
+  std::pmr::vector<delayed_task> _expired_tasks;
+  std::pmr::vector<task_function> _expired_funcs;
+
+  // Slack of delayed tasks planned without explicit timer_slack
+  const timer_slack _default_timer_slack;
+
+  // Source of the current time for workers
+  const clock_mode _clock_mode;
+
+  // Whether delayed tasks are owned by workers. Is false if there are no running workers
+  bool _is_worker_timers = false;
+
+  // Number of lower bits of delayed_task_id that store index of the timer owner: 0 for the timer thread, worker index + 1 otherwise
+  unsigned _timer_owner_bits = 0;
+
+  // Indexes of running workers that own timers of queues without workers
+  std::vector<std::uint32_t> _timer_workers;
+
+  // Round robin counter for selecting the owner of the next timer
+  std::atomic_uint32_t _timer_owner_cursor{0};
+
+  // Counters updated by threads that are not workers
+  stats_counters _stats;
+
+  // Elastic groups of workers
+  // NOLINTNEXTLINE(*-avoid-c-arrays)
+  std::unique_ptr<worker_group[]> _worker_groups;
+  std::uint32_t _num_worker_groups = 0;
+
+  // Thread that starts and retires threads of groups. Is started only if there are groups that can change number of threads
+  std::thread _groups_thread;
+  thread_notifier _groups_notifier;
+
+  // Whether the groups thread was already woken up by planning threads. Is kept true while it polls queues,
+  // so planning threads don't wake it up on every task
+  std::atomic_bool _groups_nudged{true};
+
+  // Threads for blocking tasks
+  internal::blocking_pool _blocking_pool;
+
+  // Settings that failed to apply to started threads
+  mutable async_coro::mutex _scheduling_errors_mutex;
+  std::vector<thread_scheduling_error> _scheduling_errors CORO_THREAD_GUARDED_BY(_scheduling_errors_mutex);
+
+  // Interval of polling queues of groups with waiting tasks
+  std::chrono::nanoseconds _groups_poll_interval = std::chrono::nanoseconds::max();
+
+  // Worker that runs on the current thread tagged with its execution system
+  struct current_worker {
+    const execution_system *owner = nullptr;
+    worker_thread_data *data = nullptr;
+  };
+
+  static thread_local current_worker _current_worker;
 };
 
 }  // namespace async_coro
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <async_coro/thread_index.h>
+
 #include <compare>
 #include <cstdint>
 #include <memory>
-#include <thread>
+#include <memory_resource>
 #include <type_traits>
 #include <typeindex>
 #include <vector>
@@ -27,7 +29,7 @@ struct data_key {
 
   template <class T>
   static data_key get_key_for_class() noexcept {
-    return internal::key_static<T>::id_for_t;
+    return data_key{internal::key_static<T>::id_for_t};
   }
 };
 
@@ -38,15 +40,34 @@ struct data_key {
  * This class is not thread safe
  */
 class executor_data {
-  using destroyer_func_t = void (*)(void*) noexcept;
-  using data_ptr = std::unique_ptr<void, destroyer_func_t>;
-  using creator_func_t = data_ptr (*)();
+  using destroyer_func_t = void (*)(void*, std::pmr::memory_resource*) noexcept;
+
+  struct data_deleter {
+    destroyer_func_t destroyer;
+    std::pmr::memory_resource* resource;
+
+    void operator()(void* data) const noexcept { destroyer(data, resource); }
+  };
+
+  using data_ptr = std::unique_ptr<void, data_deleter>;
+  using creator_func_t = data_ptr (*)(std::pmr::memory_resource*);
 
  public:
   executor_data() noexcept;
+
+  /**
+   * @brief Construct executor data that allocates thread local data from the resource
+   * @param resource Memory resource for all allocations. Should outlive this object
+   */
+  explicit executor_data(std::pmr::memory_resource* resource) noexcept;
+
   executor_data(const executor_data&) = delete;
   executor_data(executor_data&&) noexcept;
   executor_data& operator=(const executor_data&) = delete;
+
+  /**
+   * @brief Move data of other executor data. This object takes over memory resource of other
+   */
   executor_data& operator=(executor_data&&) noexcept;
 
   ~executor_data() noexcept;
@@ -56,18 +77,20 @@ class executor_data {
   T& get_data() const {
     return *static_cast<T*>(find_data(
         data_key::get_key_for_class<T>(),
-        +[]() {
+        +[](std::pmr::memory_resource* resource) {
           return data_ptr{
-              new T(),
-              +[](void* data) noexcept {
-                delete static_cast<T*>(data);  // NOLINT(*owning-memory)
-              }};
+              std::pmr::polymorphic_allocator<T>{resource}.template new_object<T>(),
+              data_deleter{
+                  +[](void* data, std::pmr::memory_resource* res) noexcept {
+                    std::pmr::polymorphic_allocator<T>{res}.delete_object(static_cast<T*>(data));
+                  },
+                  resource}};
         }));
   }
 
-  [[nodiscard]] std::thread::id get_owning_thread() const noexcept { return _owning_thread; }
+  [[nodiscard]] thread_index get_owning_thread() const noexcept { return _owning_thread; }
 
-  void set_owning_thread(std::thread::id thread_id) noexcept { _owning_thread = thread_id; }
+  void set_owning_thread(thread_index thread_id) noexcept { _owning_thread = thread_id; }
 
  private:
   void* find_data(data_key key, creator_func_t creator) const;
@@ -78,8 +101,8 @@ class executor_data {
     data_ptr data;
   };
 
-  std::thread::id _owning_thread;
-  mutable std::vector<store> _data;
+  thread_index _owning_thread;
+  mutable std::pmr::vector<store> _data;
 };
 
 }  // namespace async_coro
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <async_coro/config.h>
 #include <async_coro/execution_queue_mark.h>
+#include <async_coro/thread_index.h>
 #include <async_coro/utils/unique_function.h>
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <thread>
+#include <span>
+#include <utility>
 
 namespace async_coro {
 
@@ -21,6 +25,56 @@ struct delayed_task_id {
   auto operator<=>(const delayed_task_id &) const noexcept = default;
 };
 
+/**
+ * @brief Tolerance of the time of a delayed task
+ *
+ * Delayed task with slack can be executed at any moment between its time point and time point + slack.
+ * Execution system can use it to group tasks with close time points into one timer wakeup
+ */
+struct timer_slack {
+  std::chrono::steady_clock::duration value{};
+};
+
+/**
+ * @brief Policy for ticks of a periodic task that were missed because the task or the timer were late
+ */
+enum class missed_tick_policy : std::uint8_t {
+  // Missed ticks are dropped. Task is executed once and continues with the next tick that is still ahead
+  skip,
+  // Missed ticks are executed one after another until the task catches up with its schedule
+  burst,
+};
+
+/**
+ * @brief Time point before which a task should be executed
+ *
+ * Deadline queues execute tasks in order of their deadlines. Other queues ignore deadlines.
+ * Default value means no deadline, such tasks are executed after all tasks with deadlines.
+ */
+struct task_deadline {
+  std::chrono::steady_clock::time_point value = std::chrono::steady_clock::time_point::max();
+
+  // Whether the task can be destroyed without execution by missed_deadline_policy::drop.
+  // Tasks that resume coroutines can't be dropped, otherwise the coroutines would never finish
+  bool can_drop = true;
+
+  [[nodiscard]] bool has_value() const noexcept { return value != std::chrono::steady_clock::time_point::max(); }
+
+  auto operator<=>(const task_deadline &) const noexcept = default;
+};
+
+/**
+ * @brief Policy for tasks of deadline queues that are taken after their deadline has passed
+ */
+enum class missed_deadline_policy : std::uint8_t {
+  // Task is executed in order of its deadline as if it wasn't missed
+  keep,
+  // Task loses its deadline and is executed after all tasks with deadlines
+  demote,
+  // Task is destroyed without execution. Tasks that can't be dropped are executed as with keep policy
+  drop,
+};
+
 class executor_data;
 
 /**
@@ -99,6 +153,41 @@ class i_execution_system {
    */
   virtual void plan_execution(task_function func, execution_queue_mark execution_queue) = 0;
 
+  /**
+   * @brief Schedules a task for execution on the specified queue before the deadline
+   *
+   * Deadline queues of implementations execute tasks with the earliest deadline first.
+   * Default implementation ignores the deadline.
+   *
+   * @param func The task function to be executed
+   * @param execution_queue The execution queue where the task should be scheduled
+   * @param deadline Time point before which the task should be executed
+   *
+   * @note This method is thread-safe and can be called from any thread
+   */
+  virtual void plan_execution(task_function func, execution_queue_mark execution_queue, task_deadline deadline) {
+    (void)deadline;
+    plan_execution(std::move(func), execution_queue);
+  }
+
+  /**
+   * @brief Schedules a batch of tasks for execution on the specified queue
+   *
+   * Behaves like a series of plan_execution() calls but lets implementations
+   * push all tasks at once and wake only as many threads as there are tasks.
+   * Default implementation simply calls plan_execution() for every task.
+   *
+   * @param funcs The task functions to be executed. All functions are moved out of the span
+   * @param execution_queue The execution queue where the tasks should be scheduled
+   *
+   * @note This method is thread-safe and can be called from any thread
+   */
+  virtual void plan_execution_bulk(std::span<task_function> funcs, execution_queue_mark execution_queue) {
+    for (auto &func : funcs) {
+      plan_execution(std::move(func), execution_queue);
+    }
+  }
+
   /**
    * @brief Schedules a task for execution on the specified queue at the given time
    *
@@ -111,16 +200,78 @@ class i_execution_system {
   virtual delayed_task_id plan_execution_after(task_function func, execution_queue_mark execution_queue,
                                                std::chrono::steady_clock::time_point when) = 0;
 
+  /**
+   * @brief Schedules a task for execution on the specified queue at the given time with tolerance
+   *
+   * The task will be executed no earlier than the provided time point. Implementations may delay it
+   * up to slack to execute it together with other delayed tasks.
+   * Default implementation ignores slack.
+   *
+   * @param func The task function to be executed
+   * @param execution_queue The execution queue where the task should be scheduled
+   * @param when The steady_clock time point when the task should be executed
+   * @param slack Max delay of the task after the time point
+   */
+  virtual delayed_task_id plan_execution_after(task_function func, execution_queue_mark execution_queue,
+                                               std::chrono::steady_clock::time_point when, timer_slack slack) {
+    (void)slack;
+    return plan_execution_after(std::move(func), execution_queue, when);
+  }
+
+  /**
+   * @brief Schedules a task for periodic execution on the specified queue
+   *
+   * The task is executed at first_time + N * period until it is cancelled with cancel_execution.
+   * Time points are absolute so late executions don't shift the schedule.
+   * Executions of the task never overlap: ticks that come while the previous execution is pending
+   * are handled according to the policy.
+   *
+   * @param func The task function to be executed on every tick
+   * @param execution_queue The execution queue where the task should be executed
+   * @param first_time The steady_clock time point of the first tick
+   * @param period Time between ticks. Should be positive
+   * @param policy What to do with ticks that were missed
+   * @return Id to cancel the task. Default implementation doesn't support periodic tasks:
+   * it asserts and returns empty id that cancel_execution ignores
+   */
+  virtual delayed_task_id plan_periodic(task_function func, execution_queue_mark execution_queue,
+                                        std::chrono::steady_clock::time_point first_time,
+                                        std::chrono::steady_clock::duration period, missed_tick_policy policy) {
+    (void)func;
+    (void)execution_queue;
+    (void)first_time;
+    (void)period;
+    (void)policy;
+    ASYNC_CORO_ASSERT(false && "Periodic tasks are not supported by this execution system");  // NOLINT(*-static-assert)
+    return {};
+  }
+
   /**
    * @brief Cancels execution of previously scheduled function
    *
-   * @param task_id delayed_task_id structure returned from 'plan_execution_after'
+   * @param task_id delayed_task_id structure returned from 'plan_execution_after' or 'plan_periodic'
    * @return true if task was cancelled false otherwise
    *
    * @note If this method returns false execution may still happen if task was already scheduled for asap execution on the queue
    */
   virtual bool cancel_execution(const delayed_task_id &task_id) = 0;
 
+  /**
+   * @brief Schedules a task that blocks its thread, e.g. in file or socket IO
+   *
+   * Implementations should execute such tasks on threads that don't serve execution queues,
+   * so blocked calls don't hold back other tasks.
+   * Default implementation plans the task on the worker queue.
+   *
+   * @param func The task function to be executed
+   *
+   * @note This method is thread-safe and can be called from any thread
+   * @note The task is executed on a thread that may not fit any execution queue
+   */
+  virtual void plan_blocking(task_function func) {
+    plan_execution(std::move(func), execution_queues::worker);
+  }
+
   /**
    * @brief Executes a task immediately if possible, otherwise schedules it
    *
@@ -165,7 +316,7 @@ class i_execution_system {
    * @note This method is useful for optimizing task execution by avoiding
    *       unnecessary queuing when immediate execution is possible
    */
-  [[nodiscard]] virtual bool is_thread_fits(execution_queue_mark execution_queue, std::thread::id thread_id) const noexcept = 0;
+  [[nodiscard]] virtual bool is_thread_fits(execution_queue_mark execution_queue, thread_index thread_id) const noexcept = 0;
 };
 
 }  // namespace async_coro
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace async_coro::internal {
+
+/**
+ * @brief Tells the CPU that the thread is spinning. Lowers power usage and frees resources for the sibling hyper thread
+ */
+inline void cpu_relax() noexcept {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Spin budget of an idle worker that is tuned online
+ *
+ * Parking costs the wakeup latency: time from the notification to the moment the parked thread runs again.
+ * Spinning longer than this latency can't win more than parking, so the budget is limited by the average
+ * observed wakeup latency. Inside this limit the budget grows while idle periods are short enough
+ * to be covered by spinning, and is halved on long idle periods where spinning only burns CPU.
+ */
+class adaptive_spin {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  adaptive_spin() noexcept = default;
+
+  /**
+   * @brief Creates spin with the budget bounds. Budget starts from min_spin
+   */
+  adaptive_spin(clock::duration min_spin, clock::duration max_spin) noexcept
+      : _min_spin(min_spin),
+        _max_spin(std::max(min_spin, max_spin)),
+        _budget(min_spin),
+        _wake_latency(_max_spin) {}
+
+  /**
+   * @brief Spins one step of exponential backoff: a growing number of pause instructions, then thread yields
+   */
+  void backoff() noexcept {
+    if (_backoff_step > max_pause_step) {
+      std::this_thread::yield();
+      return;
+    }
+
+    for (std::uint32_t i = 0, num_pauses = 1U << _backoff_step; i < num_pauses; i++) {
+      cpu_relax();
+    }
+    _backoff_step++;
+  }
+
+  /**
+   * @brief Starts backoff from the shortest step. Is called when a new spin starts
+   */
+  void reset_backoff() noexcept { _backoff_step = 0; }
+
+  /**
+   * @brief Returns the current spin budget
+   */
+  [[nodiscard]] clock::duration get_budget() const noexcept { return _budget; }
+
+  /**
+   * @brief Returns the average observed wakeup latency
+   */
+  [[nodiscard]] clock::duration get_wake_latency() const noexcept { return _wake_latency; }
+
+  /**
+   * @brief Records time from the notification of the parked thread to its resume
+   */
+  void on_wake_latency(clock::duration latency) noexcept {
+    // exponential moving average over the last ~8 wakeups
+    _wake_latency += (latency - _wake_latency) / wake_latency_weight;
+  }
+
+  /**
+   * @brief Records the duration of the finished idle period: from the first empty loop until a task was found
+   */
+  void on_idle_end(clock::duration idle_duration) noexcept {
+    const auto target = std::clamp(_wake_latency, _min_spin, _max_spin);
+
+    if (idle_duration <= target * 2) {
+      // spinning a bit longer covers such idle periods. Additive increase keeps the budget stable near the target
+      _budget = std::min(_budget + (target / budget_increase_parts), target);
+    } else {
+      _budget = std::max(_budget / 2, _min_spin);
+    }
+  }
+
+ private:
+  static constexpr std::uint32_t max_pause_step = 6;
+  static constexpr std::int64_t wake_latency_weight = 8;
+  static constexpr std::int64_t budget_increase_parts = 4;
+
+  clock::duration _min_spin{};
+  clock::duration _max_spin{};
+  clock::duration _budget{};
+  clock::duration _wake_latency{};
+  std::uint32_t _backoff_step = 0;
+};
+
+}  // namespace async_coro::internal
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <async_coro/base_handle.h>
+#include <async_coro/config.h>
+#include <async_coro/execution_queue_mark.h>
+#include <async_coro/executor_data.h>
+#include <async_coro/i_execution_system.h>
+#include <async_coro/scheduler.h>
+
+#include <concepts>
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#if ASYNC_CORO_WITH_EXCEPTIONS && ASYNC_CORO_COMPILE_WITH_EXCEPTIONS
+#include <exception>
+#endif
+
+namespace async_coro::internal {
+
+/**
+ * @brief Awaitable that executes a blocking function on the blocking pool of the execution system
+ *
+ * This awaitable is intended to be used via `async_coro::run_blocking(...)`.
+ *
+ * Behavior summary:
+ * - When awaited, the coroutine is suspended and the function is planned with i_execution_system::plan_blocking().
+ * - After the function returns, the coroutine is planned on the execution queue it was suspended on
+ *   and receives the result of the function. Exceptions of the function are rethrown in the coroutine.
+ * - Cancellation of the coroutine doesn't interrupt the function, the cancel logic runs after it returns.
+ */
+template <typename TFunc>
+class await_blocking {
+  using result_type = std::invoke_result_t<TFunc&>;
+  using store_type = std::conditional_t<std::is_void_v<result_type>, bool, std::optional<result_type>>;
+
+ public:
+  explicit await_blocking(TFunc func) noexcept(std::is_nothrow_move_constructible_v<TFunc>)
+      : _func(std::move(func)) {}
+
+  await_blocking(const await_blocking&) = delete;
+  await_blocking(await_blocking&&) = delete;
+
+  ~await_blocking() noexcept = default;
+
+  await_blocking& operator=(await_blocking&&) = delete;
+  await_blocking& operator=(const await_blocking&) = delete;
+
+  [[nodiscard]] bool await_ready() const noexcept { return false; }  // NOLINT(*-static)
+
+  template <typename U>
+    requires(std::derived_from<U, base_handle>)
+  void await_suspend(std::coroutine_handle<U> handle) {
+    auto& promise = handle.promise();
+
+    // self destroy protection
+    auto ptr = promise.get_owning_ptr();
+
+    promise.plan_sleep_on_queue(_execution_queue, base_handle::cancel_callback_ptr{nullptr});
+    _deadline = task_deadline{.value = promise.get_deadline(), .can_drop = false};
+
+    _execution_system = std::addressof(promise.get_scheduler().get_execution_system());
+    _execution_system->plan_blocking([this, ptr = std::move(ptr)](const executor_data&) mutable {
+      execute();
+
+      // continuation is planned as pool threads don't fit execution queues
+      i_execution_system::task_function continue_func{[ptr = std::move(ptr)](const executor_data& data) {
+        ptr->continue_after_sleep(data.get_owning_thread());
+      }};
+
+      if (_deadline.has_value()) {
+        _execution_system->plan_execution(std::move(continue_func), _execution_queue, _deadline);
+      } else {
+        _execution_system->plan_execution(std::move(continue_func), _execution_queue);
+      }
+    });
+  }
+
+  auto await_resume() {
+#if ASYNC_CORO_WITH_EXCEPTIONS && ASYNC_CORO_COMPILE_WITH_EXCEPTIONS
+    if (_exception) [[unlikely]] {
+      std::rethrow_exception(_exception);
+    }
+#endif
+    if constexpr (!std::is_void_v<result_type>) {
+      return std::move(*_result);
+    }
+  }
+
+  await_blocking& coro_await_transform(base_handle& parent) noexcept {
+    _execution_queue = parent.get_execution_queue();
+    return *this;
+  }
+
+ private:
+  void execute() noexcept {
+#if ASYNC_CORO_WITH_EXCEPTIONS && ASYNC_CORO_COMPILE_WITH_EXCEPTIONS
+    try {
+#endif
+      if constexpr (std::is_void_v<result_type>) {
+        _func();
+        _result = true;
+      } else {
+        _result.emplace(_func());
+      }
+#if ASYNC_CORO_WITH_EXCEPTIONS && ASYNC_CORO_COMPILE_WITH_EXCEPTIONS
+    } catch (...) {
+      _exception = std::current_exception();
+    }
+#endif
+  }
+
+ private:
+  TFunc _func;
+  store_type _result{};
+#if ASYNC_CORO_WITH_EXCEPTIONS && ASYNC_CORO_COMPILE_WITH_EXCEPTIONS
+  std::exception_ptr _exception;
+#endif
+  i_execution_system* _execution_system = nullptr;
+  task_deadline _deadline;
+  execution_queue_mark _execution_queue = async_coro::execution_queues::any;
+};
+
+}  // namespace async_coro::internal
@@ -5,6 +5,7 @@
 #include <async_coro/execution_queue_mark.h>
 #include <async_coro/executor_data.h>
 #include <async_coro/i_execution_system.h>
+#include <async_coro/runtime_clock.h>
 #include <async_coro/scheduler.h>
 #include <async_coro/thread_safety/analysis.h>
 #include <async_coro/thread_safety/light_mutex.h>
@@ -14,6 +15,7 @@
 #include <atomic>
 #include <concepts>
 #include <memory>
+#include <optional>
 #include <utility>
 
 namespace async_coro::internal {
@@ -46,14 +48,24 @@ namespace async_coro::internal {
  * @code
  * co_await async_coro::sleep(std::chrono::milliseconds{100});
  * co_await async_coro::sleep(std::chrono::seconds{1}, execution_queues::worker);
+ * co_await async_coro::sleep(std::chrono::seconds{1}, async_coro::timer_slack{std::chrono::milliseconds{50}});
  * @endcode
  */
 struct await_sleep {
   explicit await_sleep(std::chrono::steady_clock::duration sleep_duration) noexcept
-      : _time(std::chrono::steady_clock::now() + sleep_duration),
+      : _time(runtime_clock::now() + sleep_duration),
         _use_parent_q(true) {}
   await_sleep(std::chrono::steady_clock::duration sleep_duration, execution_queue_mark execution_q) noexcept
-      : _time(std::chrono::steady_clock::now() + sleep_duration),
+      : _time(runtime_clock::now() + sleep_duration),
+        _execution_queue(execution_q),
+        _use_parent_q(false) {}
+  await_sleep(std::chrono::steady_clock::duration sleep_duration, timer_slack slack) noexcept
+      : _time(runtime_clock::now() + sleep_duration),
+        _slack(slack),
+        _use_parent_q(true) {}
+  await_sleep(std::chrono::steady_clock::duration sleep_duration, execution_queue_mark execution_q, timer_slack slack) noexcept
+      : _time(runtime_clock::now() + sleep_duration),
+        _slack(slack),
         _execution_queue(execution_q),
         _use_parent_q(false) {}
 
@@ -81,11 +93,12 @@ struct await_sleep {
 
     auto& execution_system = _promise->get_scheduler().get_execution_system();
 
-    _t_id.store(execution_system.plan_execution_after(
-                    [ptr = std::move(ptr)](const executor_data& data) {
-                      ptr->continue_after_sleep(data.get_owning_thread());
-                    },
-                    _execution_queue, _time),
+    i_execution_system::task_function continue_func{[ptr = std::move(ptr)](const executor_data& data) {
+      ptr->continue_after_sleep(data.get_owning_thread());
+    }};
+
+    _t_id.store(_slack ? execution_system.plan_execution_after(std::move(continue_func), _execution_queue, _time, *_slack)
+                       : execution_system.plan_execution_after(std::move(continue_func), _execution_queue, _time),
                 std::memory_order::release);
 
     if (_was_cancelled.load(std::memory_order::acquire)) {
@@ -134,6 +147,7 @@ struct await_sleep {
   base_handle* _promise = nullptr;
   cancel_callback _on_cancel;
   std::chrono::steady_clock::time_point _time;
+  std::optional<timer_slack> _slack;
   std::atomic<delayed_task_id> _t_id;
   std::atomic_bool _was_cancelled{false};
   execution_queue_mark _execution_queue = async_coro::execution_queues::any;
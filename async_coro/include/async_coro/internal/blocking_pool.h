@@ -0,0 +1,87 @@
+#pragma once
+
+#include <async_coro/i_execution_system.h>
+#include <async_coro/thread_safety/analysis.h>
+#include <async_coro/thread_safety/condition_variable.h>
+#include <async_coro/thread_safety/mutex.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <thread>
+
+namespace async_coro::internal {
+
+/**
+ * @brief Elastic pool of threads for tasks that block in system calls
+ *
+ * Threads are started on demand when a task finds no waiting thread, up to max_threads.
+ * Threads that wait for tasks longer than idle_timeout exit. Tasks that don't find a thread
+ * at max_threads wait in FIFO order. Pool threads are not workers, so they don't fit any execution queue.
+ */
+class blocking_pool {
+ public:
+  using task_function = i_execution_system::task_function;
+
+  /**
+   * @param max_threads Max number of threads. Zero turns the pool off, it doesn't take tasks
+   * @param idle_timeout Time a thread waits for tasks before it exits
+   * @param name Name of pool threads
+   * @param resource Memory resource for executor data of pool threads. Should outlive the pool
+   */
+  blocking_pool(std::uint32_t max_threads, std::chrono::nanoseconds idle_timeout, std::string name, std::pmr::memory_resource* resource);
+
+  blocking_pool(const blocking_pool&) = delete;
+  blocking_pool(blocking_pool&&) = delete;
+
+  ~blocking_pool() noexcept;
+
+  blocking_pool& operator=(const blocking_pool&) = delete;
+  blocking_pool& operator=(blocking_pool&&) = delete;
+
+  /**
+   * @brief Plans the task on a pool thread. Starts a new thread if all threads are busy
+   *
+   * @return false if the pool is turned off or stopped, the caller should execute the task elsewhere. func is untouched in this case
+   */
+  bool try_plan(task_function& func);
+
+  /**
+   * @brief Waits until pool threads execute running and pending tasks and stops them. The pool doesn't take tasks after stop
+   */
+  void stop() noexcept;
+
+  /**
+   * @brief Returns number of running threads
+   */
+  [[nodiscard]] std::uint32_t get_num_threads() const noexcept;
+
+ private:
+  struct pool_thread {
+    std::thread thread;
+    bool is_exited = false;
+  };
+
+  void thread_loop(std::list<pool_thread>::iterator self);
+
+  // Joins threads that exited after idle timeout
+  void join_exited() CORO_THREAD_REQUIRES(_mutex);
+
+ private:
+  mutable async_coro::mutex _mutex;
+  async_coro::condition_variable _cv;
+  std::deque<task_function> _tasks CORO_THREAD_GUARDED_BY(_mutex);
+  std::list<pool_thread> _threads CORO_THREAD_GUARDED_BY(_mutex);
+  std::uint32_t _num_threads CORO_THREAD_GUARDED_BY(_mutex) = 0;
+  std::uint32_t _num_waiting CORO_THREAD_GUARDED_BY(_mutex) = 0;
+  bool _is_stopping CORO_THREAD_GUARDED_BY(_mutex) = false;
+  const std::uint32_t _max_threads;
+  const std::chrono::nanoseconds _idle_timeout;
+  const std::string _name;
+  std::pmr::memory_resource* const _resource;
+};
+
+}  // namespace async_coro::internal
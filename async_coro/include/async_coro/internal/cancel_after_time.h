@@ -4,6 +4,7 @@
 #include <async_coro/config.h>
 #include <async_coro/execution_queue_mark.h>
 #include <async_coro/i_execution_system.h>
+#include <async_coro/runtime_clock.h>
 #include <async_coro/internal/advanced_awaiter_fwd.h>
 #include <async_coro/scheduler.h>
 #include <async_coro/utils/callback_on_stack.h>
@@ -11,6 +12,7 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <optional>
 
 namespace async_coro::internal {
 
@@ -18,15 +20,24 @@ struct cancel_after_time : public advanced_awaiter<cancel_after_time> {
   using result_type = void;
 
   explicit cancel_after_time(std::chrono::steady_clock::duration sleep_duration) noexcept
-      : _time(std::chrono::steady_clock::now() + sleep_duration) {}
+      : _time(runtime_clock::now() + sleep_duration) {}
 
   cancel_after_time(std::chrono::steady_clock::duration sleep_duration, execution_queue_mark execution_q) noexcept
-      : _time(std::chrono::steady_clock::now() + sleep_duration),
+      : _time(runtime_clock::now() + sleep_duration),
+        _execution_queue(execution_q) {}
+
+  cancel_after_time(std::chrono::steady_clock::duration sleep_duration, timer_slack slack) noexcept
+      : _time(runtime_clock::now() + sleep_duration),
+        _slack(slack) {}
+
+  cancel_after_time(std::chrono::steady_clock::duration sleep_duration, execution_queue_mark execution_q, timer_slack slack) noexcept
+      : _time(runtime_clock::now() + sleep_duration),
+        _slack(slack),
         _execution_queue(execution_q) {}
 
   cancel_after_time(const cancel_after_time&) = delete;
   cancel_after_time(cancel_after_time&& other) noexcept
-      : _time(other._time), _execution_queue(other._execution_queue) {
+      : _time(other._time), _slack(other._slack), _execution_queue(other._execution_queue) {
     ASYNC_CORO_ASSERT(other._handler == nullptr && "cancel_after_time should not be moved after awaiting");
   }
 
@@ -58,19 +69,20 @@ struct cancel_after_time : public advanced_awaiter<cancel_after_time> {
 
     auto& system = handle.get_scheduler().get_execution_system();
 
-    _t_id.store(system.plan_execution_after(
-                    [this](const executor_data&) {
-                      _t_id.exchange(delayed_task_id{}, std::memory_order::acquire);
+    i_execution_system::task_function cancel_func{[this](const executor_data&) {
+      _t_id.exchange(delayed_task_id{}, std::memory_order::acquire);
+
+      auto ptr = _handler->get_owning_ptr();
 
-                      auto ptr = _handler->get_owning_ptr();
+      // continue execution of our && or || combined task
+      _continue_f.execute_and_destroy(true);
 
-                      // continue execution of our && or || combined task
-                      _continue_f.execute_and_destroy(true);
+      // cancel our task
+      _handler->request_cancel();
+    }};
 
-                      // cancel our task
-                      _handler->request_cancel();
-                    },
-                    _execution_queue, _time),
+    _t_id.store(_slack ? system.plan_execution_after(std::move(cancel_func), _execution_queue, _time, *_slack)
+                       : system.plan_execution_after(std::move(cancel_func), _execution_queue, _time),
                 std::memory_order::release);
   }
 
@@ -84,6 +96,7 @@ struct cancel_after_time : public advanced_awaiter<cancel_after_time> {
   continue_callback_ptr _continue_f = nullptr;
   async_coro::base_handle* _handler = nullptr;
   std::chrono::steady_clock::time_point _time;
+  std::optional<timer_slack> _slack;
   std::atomic<delayed_task_id> _t_id;
   execution_queue_mark _execution_queue = async_coro::execution_queues::any;
 };
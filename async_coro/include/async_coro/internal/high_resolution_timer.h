@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+
+namespace async_coro::internal {
+
+/**
+ * @brief Waitable timer with absolute CLOCK_MONOTONIC deadlines based on timerfd
+ *
+ * One thread waits for the timer, any thread can move the deadline or wake the waiting thread up.
+ * Wakeup jitter is limited by the kernel timer slack of the waiting thread, which is lowered by prepare_waiting_thread.
+ * Is not valid on platforms without timerfd, users should fall back to a condition variable in this case.
+ */
+class high_resolution_timer {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  high_resolution_timer() noexcept;
+
+  high_resolution_timer(const high_resolution_timer&) = delete;
+  high_resolution_timer(high_resolution_timer&&) = delete;
+
+  ~high_resolution_timer() noexcept;
+
+  high_resolution_timer& operator=(const high_resolution_timer&) = delete;
+  high_resolution_timer& operator=(high_resolution_timer&&) = delete;
+
+  /**
+   * @brief Checks if the timer was created. Is false on platforms without timerfd
+   */
+  [[nodiscard]] bool is_valid() const noexcept { return _fd >= 0; }
+
+  /**
+   * @brief Arms the timer on the time point, replacing the previous deadline. time_point::max() disarms the timer
+   */
+  void set_deadline(clock::time_point time) noexcept;
+
+  /**
+   * @brief Makes the current or the next wait return immediately
+   */
+  void wake() noexcept;
+
+  /**
+   * @brief Blocks until the deadline is reached or wake is called
+   */
+  void wait() noexcept;
+
+  /**
+   * @brief Lowers the kernel timer slack of the calling thread so its timer wakeups are not deferred
+   */
+  static void prepare_waiting_thread() noexcept;
+
+ private:
+  int _fd = -1;
+};
+
+}  // namespace async_coro::internal
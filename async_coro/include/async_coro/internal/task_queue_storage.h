@@ -0,0 +1,572 @@
+#pragma once
+
+#include <async_coro/atomic_queue.h>
+#include <async_coro/bounded_atomic_queue.h>
+#include <async_coro/config.h>
+#include <async_coro/i_execution_system.h>
+#include <async_coro/internal/hardware_interference_size.h>
+#include <async_coro/numa_topology.h>
+#include <async_coro/runtime_clock.h>
+#include <async_coro/sharded_atomic_queue.h>
+#include <async_coro/thread_safety/analysis.h>
+#include <async_coro/thread_safety/mutex.h>
+#include <async_coro/thread_safety/unique_lock.h>
+#include <async_coro/warnings.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace async_coro::internal {
+
+ASYNC_CORO_WARNINGS_MSVC_PUSH
+ASYNC_CORO_WARNINGS_MSVC_IGNORE(4324)
+
+/**
+ * @brief Container of tasks for a single execution queue with implementation selected at runtime.
+ *
+ * By default tasks are stored in unbounded atomic_queue. Queue can be switched to another
+ * implementation before the first push (usually in constructor of execution system).
+ * @tparam T The type of the values to be stored in the queue.
+ */
+template <typename T>
+class task_queue_storage {
+  using single_consumer_queue = atomic_queue<T, 64, atomic_queue_policy::mpsc>;  // NOLINT(*-magic-*)
+
+  // Lock free ring buffer with unbounded queue for values that didn't fit in the ring
+  class bounded_store {
+   public:
+    bounded_store(std::uint32_t capacity, std::pmr::memory_resource* resource)
+        : _ring(capacity, resource),
+          _overflow(resource) {}
+
+    template <typename... U>
+    void push(U&&... val) {
+      // keep FIFO order while overflow is not drained
+      if (_overflow.has_value() || !_ring.try_push(std::forward<U>(val)...)) {
+        _overflow.push(std::forward<U>(val)...);  // NOLINT(*-use-after-move) try_push doesn't touch values on fail
+      }
+    }
+
+    template <std::ranges::sized_range R>
+    void push_bulk(R&& range) {
+      auto it = std::ranges::begin(range);
+      const auto end = std::ranges::end(range);
+
+      // ring has no bulk reservation so values are pushed one by one until it is full
+      if (!_overflow.has_value()) {
+        for (; it != end; ++it) {
+          if (!_ring.try_push(std::ranges::iter_move(it))) {
+            break;
+          }
+        }
+      }
+
+      if (it != end) {
+        _overflow.push_bulk(std::ranges::subrange(it, end));
+      }
+    }
+
+    bool try_pop(T& val) noexcept {
+      return _ring.try_pop(val) || _overflow.try_pop(val);
+    }
+
+    template <typename F>
+    bool try_consume(F&& func) {
+      // ring cells are reused by producers, so values are moved out before invocation
+      T val;
+      if (!try_pop(val)) {
+        return false;
+      }
+      std::forward<F>(func)(val);
+      return true;
+    }
+
+    template <typename OutIt>
+    std::size_t try_pop_bulk(OutIt out, std::size_t max_values) noexcept {
+      std::size_t num_values = 0;
+      T val;
+      while (num_values < max_values && try_pop(val)) {
+        *out = std::move(val);
+        ++out;
+        num_values++;
+      }
+      return num_values;
+    }
+
+    [[nodiscard]] bool has_value() const noexcept {
+      return _ring.has_value() || _overflow.has_value();
+    }
+
+    void set_retained_capacity(std::size_t num_values) noexcept { _overflow.set_retained_capacity(num_values); }
+
+    void shrink_to_fit() noexcept { _overflow.shrink_to_fit(); }
+
+    [[nodiscard]] std::size_t get_num_banks() const noexcept { return _overflow.get_num_banks(); }
+
+   private:
+    bounded_atomic_queue<T> _ring;
+    atomic_queue<T> _overflow;
+  };
+
+  // Unbounded queue with a shard per NUMA node. Values are pushed to the node of the producer, consumers
+  // take values of their node first. Banks of a shard are allocated by producers of its node, so with first touch
+  // policy of the OS they are placed in the memory of the node
+  class numa_store {
+    struct alignas(std::hardware_constructive_interference_size) shard {
+      explicit shard(std::pmr::memory_resource* resource) noexcept : queue(resource) {}
+
+      atomic_queue<T> queue;
+    };
+
+   public:
+    numa_store(const numa_topology& topology, std::pmr::memory_resource* resource)
+        : _topology(std::addressof(topology)),
+          _num_shards(topology.get_num_nodes()),
+          _allocator(resource),
+          _shards(_allocator.allocate(_num_shards)) {
+      for (std::uint32_t i = 0; i < _num_shards; i++) {
+        _allocator.construct(std::addressof(_shards[i]), resource);
+      }
+    }
+
+    numa_store(const numa_store&) = delete;
+    numa_store(numa_store&&) = delete;
+
+    ~numa_store() noexcept {
+      std::destroy_n(_shards, _num_shards);
+      _allocator.deallocate(_shards, _num_shards);
+    }
+
+    numa_store& operator=(const numa_store&) = delete;
+    numa_store& operator=(numa_store&&) = delete;
+
+    template <typename... U>
+    void push(U&&... val) {
+      _shards[_topology->get_current_node()].queue.push(std::forward<U>(val)...);
+    }
+
+    template <std::ranges::sized_range R>
+    void push_bulk(R&& range) {
+      _shards[_topology->get_current_node()].queue.push_bulk(std::forward<R>(range));
+    }
+
+    bool try_pop(T& val) noexcept(std::is_nothrow_move_assignable_v<T>) {
+      // other nodes are checked only when the node of the consumer has no values
+      const auto node = _topology->get_current_node();
+      for (std::uint32_t i = 0; i < _num_shards; i++) {
+        if (_shards[(node + i) % _num_shards].queue.try_pop(val)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    template <typename F>
+    bool try_consume(F&& func) {
+      const auto node = _topology->get_current_node();
+      for (std::uint32_t i = 0; i < _num_shards; i++) {
+        if (_shards[(node + i) % _num_shards].queue.try_consume(func)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    template <typename OutIt>
+    std::size_t try_pop_bulk(OutIt out, std::size_t max_values) noexcept(std::is_nothrow_move_assignable_v<T>) {
+      std::size_t num_values = 0;
+      T val;
+      while (num_values < max_values && try_pop(val)) {
+        *out = std::move(val);
+        ++out;
+        num_values++;
+      }
+      return num_values;
+    }
+
+    [[nodiscard]] bool has_value() const noexcept {
+      for (std::uint32_t i = 0; i < _num_shards; i++) {
+        if (_shards[i].queue.has_value()) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void set_retained_capacity(std::size_t num_values) noexcept {
+      const auto num_by_shard = (num_values + _num_shards - 1) / _num_shards;
+      for (std::uint32_t i = 0; i < _num_shards; i++) {
+        _shards[i].queue.set_retained_capacity(num_by_shard);
+      }
+    }
+
+    void shrink_to_fit() noexcept {
+      for (std::uint32_t i = 0; i < _num_shards; i++) {
+        _shards[i].queue.shrink_to_fit();
+      }
+    }
+
+    [[nodiscard]] std::size_t get_num_banks() const noexcept {
+      std::size_t num_banks = 0;
+      for (std::uint32_t i = 0; i < _num_shards; i++) {
+        num_banks += _shards[i].queue.get_num_banks();
+      }
+      return num_banks;
+    }
+
+   private:
+    const numa_topology* _topology;
+    const std::uint32_t _num_shards;
+    std::pmr::polymorphic_allocator<shard> _allocator;
+    shard* const _shards;
+  };
+
+  // Binary heap of values ordered by deadlines under a mutex. Values with equal deadlines and values
+  // without deadline are taken in FIFO order. Values past their deadline are handled by the policy when they are taken
+  class deadline_store {
+    struct entry {
+      std::chrono::steady_clock::time_point deadline;
+      std::uint64_t order;
+      bool can_drop;
+      T value;
+    };
+
+    struct later {
+      bool operator()(const entry& left, const entry& right) const noexcept {
+        return left.deadline != right.deadline ? left.deadline > right.deadline : left.order > right.order;
+      }
+    };
+
+   public:
+    deadline_store(missed_deadline_policy policy, std::pmr::memory_resource* resource)
+        : _heap(resource),
+          _policy(policy) {}
+
+    template <typename... U>
+    void push(U&&... val) {
+      push_with_deadline(task_deadline{}, std::forward<U>(val)...);
+    }
+
+    template <typename... U>
+    void push_with_deadline(task_deadline deadline, U&&... val) {
+      unique_lock lock(_mutex);
+      push_entry(deadline, std::forward<U>(val)...);
+      _size.store(_heap.size(), std::memory_order::release);
+    }
+
+    template <std::ranges::sized_range R>
+    void push_bulk(R&& range) {
+      unique_lock lock(_mutex);
+      for (auto it = std::ranges::begin(range); it != std::ranges::end(range); ++it) {
+        push_entry(task_deadline{}, std::ranges::iter_move(it));
+      }
+      _size.store(_heap.size(), std::memory_order::release);
+    }
+
+    bool try_pop(T& val) noexcept(std::is_nothrow_move_assignable_v<T>) {
+      unique_lock lock(_mutex);
+
+      std::chrono::steady_clock::time_point now{};
+      while (!_heap.empty()) {
+        auto& top = _heap.front();
+
+        if (_policy != missed_deadline_policy::keep && top.deadline != std::chrono::steady_clock::time_point::max()) {
+          if (now == std::chrono::steady_clock::time_point{}) {
+            now = runtime_clock::now();
+          }
+
+          if (top.deadline < now) {
+            _num_missed.fetch_add(1, std::memory_order::relaxed);
+
+            if (_policy == missed_deadline_policy::demote) {
+              std::ranges::pop_heap(_heap, later{});
+              _heap.back().deadline = std::chrono::steady_clock::time_point::max();
+              _heap.back().order = _next_order++;
+              std::ranges::push_heap(_heap, later{});
+              continue;
+            }
+
+            // values that can't be dropped are taken as with keep policy
+            if (top.can_drop) {
+              std::ranges::pop_heap(_heap, later{});
+              {
+                // dropped value is destroyed without lock as its destructor can push to this queue
+                [[maybe_unused]] T dropped = std::move(_heap.back().value);
+                _heap.pop_back();
+                _size.store(_heap.size(), std::memory_order::release);
+                lock.unlock();
+              }
+              lock.lock();
+              continue;
+            }
+          }
+        }
+
+        std::ranges::pop_heap(_heap, later{});
+        val = std::move(_heap.back().value);
+        _heap.pop_back();
+        _size.store(_heap.size(), std::memory_order::release);
+        return true;
+      }
+      return false;
+    }
+
+    template <typename F>
+    bool try_consume(F&& func) {
+      // values are moved out of the heap as it is reordered by producers
+      T val;
+      if (!try_pop(val)) {
+        return false;
+      }
+      std::forward<F>(func)(val);
+      return true;
+    }
+
+    template <typename OutIt>
+    std::size_t try_pop_bulk(OutIt out, std::size_t max_values) noexcept(std::is_nothrow_move_assignable_v<T>) {
+      std::size_t num_values = 0;
+      T val;
+      while (num_values < max_values && try_pop(val)) {
+        *out = std::move(val);
+        ++out;
+        num_values++;
+      }
+      return num_values;
+    }
+
+    [[nodiscard]] bool has_value() const noexcept {
+      return _size.load(std::memory_order::acquire) != 0;
+    }
+
+    void set_retained_capacity(std::size_t /*num_values*/) noexcept {}
+
+    void shrink_to_fit() noexcept {
+      unique_lock lock(_mutex);
+      if (_heap.empty()) {
+        _heap.shrink_to_fit();
+      }
+    }
+
+    [[nodiscard]] std::size_t get_num_banks() const noexcept { return 0; }
+
+    [[nodiscard]] std::uint64_t get_num_missed_deadlines() const noexcept {
+      return _num_missed.load(std::memory_order::relaxed);
+    }
+
+   private:
+    template <typename... U>
+    void push_entry(task_deadline deadline, U&&... val) CORO_THREAD_REQUIRES(_mutex) {
+      _heap.push_back(entry{deadline.value, _next_order++, deadline.can_drop, T(std::forward<U>(val)...)});
+      std::ranges::push_heap(_heap, later{});
+    }
+
+   private:
+    mutable async_coro::mutex _mutex;
+    std::pmr::vector<entry> _heap CORO_THREAD_GUARDED_BY(_mutex);
+    std::uint64_t _next_order CORO_THREAD_GUARDED_BY(_mutex) = 0;
+    std::atomic_size_t _size{0};
+    std::atomic_uint64_t _num_missed{0};
+    const missed_deadline_policy _policy;
+  };
+
+ public:
+  task_queue_storage() noexcept = default;
+
+  /**
+   * @brief Construct storage that allocates all memory from the resource
+   * @param resource Memory resource for the storage. Should outlive the storage
+   */
+  explicit task_queue_storage(std::pmr::memory_resource* resource) noexcept
+      : _resource(resource),
+        _queue(std::in_place_type<atomic_queue<T>>, resource) {}
+
+  task_queue_storage(const task_queue_storage&) = delete;
+  task_queue_storage(task_queue_storage&&) = delete;
+
+  ~task_queue_storage() noexcept = default;
+
+  task_queue_storage& operator=(const task_queue_storage&) = delete;
+  task_queue_storage& operator=(task_queue_storage&&) = delete;
+
+  /**
+   * @brief Sets memory resource for all allocations of the storage and resets it to the default unbounded queue.
+   * @note Should be called before any push and before selecting other storage type
+   * @param resource Memory resource for the storage. Should outlive the storage
+   */
+  void set_memory_resource(std::pmr::memory_resource* resource) {
+    ASYNC_CORO_ASSERT(!has_value());
+
+    _resource = resource;
+    _queue.template emplace<atomic_queue<T>>(resource);
+  }
+
+  /**
+   * @brief Switches storage to the lock free bounded ring buffer.
+   * Values that don't fit in the ring are stored in an unbounded overflow queue.
+   * @note Should be called before any push
+   * @param capacity Capacity of the ring buffer
+   */
+  void make_bounded(std::uint32_t capacity) {
+    ASYNC_CORO_ASSERT(!has_value());
+
+    _queue.template emplace<bounded_store>(capacity, _resource);
+  }
+
+  /**
+   * @brief Switches storage to the unbounded queue with lock free consumer side.
+   * @note Should be called before any push. Only one thread can pop values after this call
+   */
+  void make_single_consumer() {
+    ASYNC_CORO_ASSERT(!has_value());
+
+    _queue.template emplace<single_consumer_queue>(_resource);
+  }
+
+  /**
+   * @brief Switches storage to the queue sharded by producer threads.
+   * @note Should be called before any push
+   * @param num_shards Number of shards. If 0 number of hardware threads is used
+   */
+  void make_sharded(std::uint32_t num_shards) {
+    ASYNC_CORO_ASSERT(!has_value());
+
+    _queue.template emplace<sharded_atomic_queue<T>>(num_shards, _resource);
+  }
+
+  /**
+   * @brief Switches storage to the queue sharded by NUMA nodes of producer threads.
+   * @note Should be called before any push
+   * @param topology Topology of the machine. Should outlive the storage
+   */
+  void make_numa(const numa_topology& topology) {
+    ASYNC_CORO_ASSERT(!has_value());
+
+    _queue.template emplace<numa_store>(topology, _resource);
+  }
+
+  /**
+   * @brief Switches storage to the queue ordered by deadlines of values (earliest deadline first).
+   * @note Should be called before any push
+   * @param policy What to do with values that are taken after their deadline
+   */
+  void make_deadline(missed_deadline_policy policy) {
+    ASYNC_CORO_ASSERT(!has_value());
+
+    _queue.template emplace<deadline_store>(policy, _resource);
+  }
+
+  /**
+   * @brief Pushes a new value to the queue.
+   */
+  template <typename... U>
+  void push(U&&... val) {
+    std::visit([&](auto& queue) { queue.push(std::forward<U>(val)...); }, _queue);
+  }
+
+  /**
+   * @brief Pushes a new value with deadline to the queue. Storages other than deadline one ignore the deadline.
+   */
+  template <typename... U>
+  void push_with_deadline(task_deadline deadline, U&&... val) {
+    std::visit([&](auto& queue) {
+      if constexpr (std::is_same_v<std::remove_cvref_t<decltype(queue)>, deadline_store>) {
+        queue.push_with_deadline(deadline, std::forward<U>(val)...);
+      } else {
+        queue.push(std::forward<U>(val)...);
+      }
+    },
+               _queue);
+  }
+
+  /**
+   * @brief Pushes all values of the range to the queue.
+   */
+  template <std::ranges::sized_range R>
+  void push_bulk(R&& range) {
+    std::visit([&](auto& queue) { queue.push_bulk(std::forward<R>(range)); }, _queue);
+  }
+
+  /**
+   * @brief Tries to pop a value from the queue.
+   * @return true if a value was popped successfully, false otherwise.
+   */
+  bool try_pop(T& val) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    return std::visit([&](auto& queue) { return queue.try_pop(val); }, _queue);
+  }
+
+  /**
+   * @brief Tries to pop a value and invokes func with it without moving the value out of unbounded storages.
+   * @return true if a value was consumed, false otherwise.
+   * @note func must not pop values from the same queue.
+   */
+  template <typename F>
+  bool try_consume(F&& func) {
+    return std::visit([&](auto& queue) { return queue.try_consume(std::forward<F>(func)); }, _queue);
+  }
+
+  /**
+   * @brief Tries to pop up to max_values values from the queue.
+   * @return number of popped values.
+   */
+  template <std::output_iterator<T&&> OutIt>
+  std::size_t try_pop_bulk(OutIt out, std::size_t max_values) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    return std::visit([&](auto& queue) { return queue.try_pop_bulk(out, max_values); }, _queue);
+  }
+
+  /**
+   * @brief Checks if the queue has any values.
+   */
+  [[nodiscard]] bool has_value() const noexcept {
+    return std::visit([](const auto& queue) { return queue.has_value(); }, _queue);
+  }
+
+  /**
+   * @brief Sets number of values that unbounded storage keeps allocated after it was drained.
+   */
+  void set_retained_capacity(std::size_t num_values) noexcept {
+    std::visit([&](auto& queue) { queue.set_retained_capacity(num_values); }, _queue);
+  }
+
+  /**
+   * @brief Releases all fully free banks of unbounded storage.
+   */
+  void shrink_to_fit() noexcept {
+    std::visit([](auto& queue) { queue.shrink_to_fit(); }, _queue);
+  }
+
+  /**
+   * @brief Returns number of allocated banks of unbounded storage. Ring buffer of bounded storage is not counted.
+   */
+  [[nodiscard]] std::size_t get_num_banks() const noexcept {
+    return std::visit([](const auto& queue) { return queue.get_num_banks(); }, _queue);
+  }
+
+  /**
+   * @brief Returns number of values of deadline storage that were taken after their deadline. Zero for other storages.
+   */
+  [[nodiscard]] std::uint64_t get_num_missed_deadlines() const noexcept {
+    if (const auto* queue = std::get_if<deadline_store>(&_queue)) {
+      return queue->get_num_missed_deadlines();
+    }
+    return 0;
+  }
+
+ private:
+  std::pmr::memory_resource* _resource = std::pmr::get_default_resource();
+  std::variant<atomic_queue<T>, bounded_store, single_consumer_queue, sharded_atomic_queue<T>, numa_store, deadline_store> _queue;
+};
+
+ASYNC_CORO_WARNINGS_MSVC_POP
+
+}  // namespace async_coro::internal
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <async_coro/config.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace async_coro::internal {
+
+/**
+ * @brief Lock free storage for a single value. Only the owner thread can put values, any thread can take them.
+ * @tparam T The type of the stored value.
+ */
+template <typename T>
+class task_slot {
+  static_assert(std::is_nothrow_destructible_v<T>, "Values of task_slot should be nothrow destructible");
+  static_assert(std::is_nothrow_move_assignable_v<T>, "Values of task_slot should be nothrow move assignable");
+
+  union union_store {
+    T value;
+    char tmp_byte;
+
+    union_store() noexcept {}  // NOLINT(*member-init)
+    union_store(const union_store&) = delete;
+    union_store(union_store&&) = delete;
+    ~union_store() noexcept {}
+
+    union_store& operator=(const union_store&) = delete;
+    union_store& operator=(union_store&&) = delete;
+  };
+
+ public:
+  task_slot() noexcept = default;
+
+  task_slot(const task_slot&) = delete;
+  task_slot(task_slot&&) = delete;
+
+  ~task_slot() noexcept {
+    if (_state.load(std::memory_order::acquire) == state_full) {
+      std::destroy_at(std::addressof(_store.value));
+    }
+  }
+
+  task_slot& operator=(const task_slot&) = delete;
+  task_slot& operator=(task_slot&&) = delete;
+
+  /**
+   * @brief Puts a value to the empty slot. Can be called only by the owner thread.
+   * @return true if the value was put, false if slot is not empty. Arguments are not touched in this case.
+   */
+  template <typename... U>
+  bool try_put(U&&... val) noexcept {
+    static_assert(std::is_nothrow_constructible_v<T, U&&...>, "Values of task_slot should be nothrow constructible");
+
+    // acquire pairs with release in try_take so previous value is fully moved out
+    if (_state.load(std::memory_order::acquire) != state_empty) {
+      return false;
+    }
+
+    new (std::addressof(_store.value)) T{std::forward<U>(val)...};
+    _state.store(state_full, std::memory_order::release);
+    return true;
+  }
+
+  /**
+   * @brief Takes a value from the slot. Can be called from any thread.
+   * @return true if the value was taken, false if slot is empty or another thread is taking the value.
+   */
+  bool try_take(T& val) noexcept {
+    auto expected = state_full;
+    if (!_state.compare_exchange_strong(expected, state_taking, std::memory_order::acquire, std::memory_order::relaxed)) {
+      return false;
+    }
+
+    val = std::move(_store.value);
+    std::destroy_at(std::addressof(_store.value));
+
+    _state.store(state_empty, std::memory_order::release);
+    return true;
+  }
+
+  /**
+   * @brief Checks if the slot has a value.
+   */
+  [[nodiscard]] bool has_value() const noexcept {
+    return _state.load(std::memory_order::relaxed) == state_full;
+  }
+
+ private:
+  static constexpr std::uint8_t state_empty = 0;
+  static constexpr std::uint8_t state_full = 1;
+  static constexpr std::uint8_t state_taking = 2;
+
+  std::atomic<std::uint8_t> _state{state_empty};
+  union_store _store;
+};
+
+}  // namespace async_coro::internal
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <async_coro/config.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace async_coro::internal {
+
+/**
+ * @brief Hierarchical timing wheel with O(1) insert and cancel.
+ *
+ * Time is split to ticks of fixed resolution. Every level has 64 slots, a slot of level N covers 64^N ticks,
+ * so 6 levels cover 64^6 ticks (about 2 years with 1 ms resolution). Timers are stored in intrusive lists of slots
+ * and are moved to lower levels when time reaches their slot. Timers are never fired before their time point:
+ * it is rounded up to the next tick.
+ * Periodic timers are re-armed in place after they fire and keep their id until they are cancelled.
+ * Every timer gets an id that can be used to cancel it. Ids of fired and cancelled timers are never reused
+ * until the generation counter of the node wraps. Ids can be limited to lower bits so the owner can use the rest.
+ * This class is not thread safe.
+ * @tparam T The type of the values stored with timers.
+ */
+template <typename T>
+class timing_wheel {
+  static constexpr std::uint32_t slot_bits = 6;
+  static constexpr std::uint32_t num_slots = 1U << slot_bits;
+  static constexpr std::uint32_t num_levels = 6;
+  static constexpr std::uint64_t max_ticks = (std::uint64_t{1} << (slot_bits * num_levels)) - 1;
+  static constexpr std::uint32_t npos = ~std::uint32_t{0};
+  static constexpr unsigned index_bits = sizeof(std::size_t) >= sizeof(std::uint64_t) ? 32 : 24;  // NOLINT(*-magic-*)
+
+  struct node {
+    std::optional<T> value;
+    std::uint64_t when_tick = 0;
+    std::uint32_t prev = npos;
+    std::uint32_t next = npos;
+    std::uint32_t generation = 1;
+    std::uint16_t list = 0;
+    bool is_periodic = false;
+  };
+
+  struct expiration {
+    std::uint32_t level;
+    std::uint32_t slot;
+    std::uint64_t deadline;
+  };
+
+ public:
+  using clock = std::chrono::steady_clock;
+  using id_type = std::size_t;
+
+  // Callback for wheels without periodic timers
+  struct no_periodic {
+    std::optional<clock::time_point> operator()(T& /*val*/) const noexcept { return std::nullopt; }
+  };
+
+  /**
+   * @brief Construct a new timing wheel
+   * @param resolution Duration of one tick. Timers fire no later than one tick after their time point
+   * @param start Time point of the tick 0. Timers before this point fire on the first advance
+   * @param resource Memory resource for timer nodes. Should outlive the wheel
+   * @param id_bits Number of lower bits that ids of timers can use. Bits above index are used by generation counter
+   */
+  timing_wheel(clock::duration resolution, clock::time_point start, std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+               unsigned id_bits = sizeof(id_type) * 8)  // NOLINT(*-magic-*)
+      : _resolution(std::max(resolution, clock::duration{1})),
+        _start(start),
+        _generation_mask(id_bits >= sizeof(id_type) * 8 ? ~id_type{0} >> index_bits : (id_type{1} << (id_bits - index_bits)) - 1),  // NOLINT(*-magic-*)
+        _nodes(resource) {
+    ASYNC_CORO_ASSERT(id_bits > index_bits);
+    _heads.fill(npos);
+  }
+
+  timing_wheel(const timing_wheel&) = delete;
+  timing_wheel(timing_wheel&&) = delete;
+
+  ~timing_wheel() noexcept = default;
+
+  timing_wheel& operator=(const timing_wheel&) = delete;
+  timing_wheel& operator=(timing_wheel&&) = delete;
+
+  /**
+   * @brief Adds a new timer
+   * @param when Time point when the timer should fire
+   * @param val The arguments to be forwarded to the constructor of T
+   * @return Id of the timer. Never 0
+   */
+  template <typename... U>
+  id_type insert(clock::time_point when, U&&... val) {
+    return insert_at_tick(std::max(to_tick_ceil(when), _elapsed), std::forward<U>(val)...);
+  }
+
+  /**
+   * @brief Adds a new timer that can fire at any moment between when and when + slack
+   *
+   * Timer gets the tick with the most trailing zero bits inside its window, so timers with overlapping
+   * windows fire on the same tick.
+   * @param when Time point when the timer should fire
+   * @param slack Max delay of the timer after when
+   * @param val The arguments to be forwarded to the constructor of T
+   * @return Id of the timer. Never 0
+   */
+  template <typename... U>
+  id_type insert_with_slack(clock::time_point when, clock::duration slack, U&&... val) {
+    const auto first_tick = std::max(to_tick_ceil(when), _elapsed);
+    auto last_tick = first_tick;
+    if (slack > clock::duration::zero()) {
+      // end of the window saturates, so huge slack doesn't overflow the time point
+      const auto last_time = when > clock::time_point::max() - slack ? clock::time_point::max() : when + slack;
+      last_tick = std::max(to_tick_floor(last_time), first_tick);
+    }
+
+    if (first_tick == last_tick) {
+      return insert_at_tick(first_tick, std::forward<U>(val)...);
+    }
+
+    // keep common high bits of the window and clear the rest
+    const auto low_mask = std::bit_floor(first_tick ^ last_tick) - 1;
+    const auto tick = (first_tick & low_mask) == 0 ? first_tick : (last_tick & ~low_mask);
+
+    return insert_at_tick(tick, std::forward<U>(val)...);
+  }
+
+  /**
+   * @brief Adds a new periodic timer. After every fire the time of the next one is requested from advance's on_periodic
+   * @param when Time point when the timer should fire first time
+   * @param val The arguments to be forwarded to the constructor of T
+   * @return Id of the timer. Stays valid until the timer is cancelled or on_periodic stops it. Never 0
+   */
+  template <typename... U>
+  id_type insert_periodic(clock::time_point when, U&&... val) {
+    const auto index = allocate_node();
+    _nodes[index].is_periodic = true;
+
+    return insert_node(index, std::max(to_tick_ceil(when), _elapsed), std::forward<U>(val)...);
+  }
+
+  /**
+   * @brief Cancels the timer and moves its value out
+   * @param id Id returned from insert
+   * @param val Reference to the value where value of the timer will be moved to
+   * @return true if the timer was cancelled, false if it has already fired or was cancelled
+   */
+  bool cancel(id_type id, T& val) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    const auto index = static_cast<std::uint32_t>(id & ((id_type{1} << index_bits) - 1));
+    if (index >= _nodes.size()) {
+      return false;
+    }
+
+    auto& timer = _nodes[index];
+    if (!timer.value.has_value() || make_id(index, timer.generation) != id) {
+      return false;
+    }
+
+    unlink(index);
+    val = std::move(*timer.value);
+    free_node(index);
+    return true;
+  }
+
+  /**
+   * @brief Fires all timers with time point before now
+   * @param now Current time
+   * @param on_expired Function that is invoked with value (T&&) of every fired timer in order of their ticks.
+   * Should not modify the wheel
+   * @param on_periodic Function that is invoked with value (T&) of every fired periodic timer. Returns time point of the next fire
+   * or std::nullopt to destroy the timer. Timer with next time point before now fires again in this advance. Should not modify the wheel
+   * @return Number of fired timers
+   */
+  template <typename F, typename P = no_periodic>
+  std::size_t advance(clock::time_point now, F&& on_expired, P&& on_periodic = P{}) {
+    const auto now_tick = to_tick_floor(now);
+    std::size_t num_expired = 0;
+
+    while (const auto exp = next_expiration()) {
+      if (exp->deadline > now_tick) {
+        break;
+      }
+
+      const auto list = (exp->level * num_slots) + exp->slot;
+      auto index = _heads[list];
+      _heads[list] = npos;
+      _occupied[exp->level] &= ~(std::uint64_t{1} << exp->slot);
+
+      _elapsed = exp->deadline;
+
+      while (index != npos) {
+        auto& timer = _nodes[index];
+        const auto next = timer.next;
+
+        if (timer.when_tick > _elapsed) {
+          // slot of higher level was reached, move timer to lower level
+          link(index);
+        } else if (timer.is_periodic) {
+          num_expired++;
+          if (const auto next_time = on_periodic(*timer.value)) {
+            // re-armed in place so id of the timer stays the same
+            timer.when_tick = std::max(to_tick_ceil(*next_time), _elapsed);
+            link(index);
+          } else {
+            free_node(index);
+          }
+        } else {
+          T val = std::move(*timer.value);
+          free_node(index);
+          on_expired(std::move(val));
+          num_expired++;
+        }
+
+        index = next;
+      }
+    }
+
+    // all timers before now_tick are fired so remaining timers stay valid relative to now_tick
+    _elapsed = std::max(_elapsed, now_tick);
+
+    return num_expired;
+  }
+
+  /**
+   * @brief Returns time point when the wheel should be advanced next time or std::nullopt if there are no timers.
+   * Returned time can be earlier than the time of any timer when timers should be moved to lower level.
+   */
+  [[nodiscard]] std::optional<clock::time_point> next_deadline() const noexcept {
+    if (const auto exp = next_expiration()) {
+      return _start + (_resolution * static_cast<clock::rep>(exp->deadline));
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Destroys all timers
+   */
+  void clear() noexcept {
+    _nodes.clear();
+    _heads.fill(npos);
+    _occupied.fill(0);
+    _free_head = npos;
+    _size = 0;
+  }
+
+  /**
+   * @brief Reserves memory for the number of timers
+   */
+  void reserve(std::size_t num_timers) { _nodes.reserve(num_timers); }
+
+  /**
+   * @brief Returns number of active timers
+   */
+  [[nodiscard]] std::size_t size() const noexcept { return _size; }
+
+  [[nodiscard]] bool empty() const noexcept { return _size == 0; }
+
+ private:
+  template <typename... U>
+  id_type insert_at_tick(std::uint64_t tick, U&&... val) {
+    return insert_node(allocate_node(), tick, std::forward<U>(val)...);
+  }
+
+  template <typename... U>
+  id_type insert_node(std::uint32_t index, std::uint64_t tick, U&&... val) {
+    auto& timer = _nodes[index];
+
+    timer.value.emplace(std::forward<U>(val)...);
+    timer.when_tick = tick;
+
+    link(index);
+    _size++;
+
+    return make_id(index, timer.generation);
+  }
+
+  [[nodiscard]] id_type make_id(std::uint32_t index, std::uint32_t generation) const noexcept {
+    return ((static_cast<id_type>(generation) & _generation_mask) << index_bits) | index;
+  }
+
+  [[nodiscard]] std::uint64_t to_tick_ceil(clock::time_point time) const noexcept {
+    if (time <= _start) {
+      return 0;
+    }
+    return static_cast<std::uint64_t>((time - _start + _resolution - clock::duration{1}) / _resolution);
+  }
+
+  [[nodiscard]] std::uint64_t to_tick_floor(clock::time_point time) const noexcept {
+    if (time <= _start) {
+      return 0;
+    }
+    return static_cast<std::uint64_t>((time - _start) / _resolution);
+  }
+
+  [[nodiscard]] std::optional<expiration> next_expiration() const noexcept {
+    // timers on lower levels are always earlier than timers on higher levels
+    for (std::uint32_t level = 0; level < num_levels; level++) {
+      const auto occupied = _occupied[level];
+      if (occupied == 0) {
+        continue;
+      }
+
+      const auto shift = level * slot_bits;
+      const auto slot_range = std::uint64_t{1} << shift;
+      const auto level_range = slot_range << slot_bits;
+      const auto now_slot = static_cast<std::uint32_t>((_elapsed >> shift) & (num_slots - 1));
+
+      const auto slot = (now_slot + static_cast<std::uint32_t>(std::countr_zero(std::rotr(occupied, static_cast<int>(now_slot))))) % num_slots;
+
+      auto deadline = (_elapsed & ~(level_range - 1)) + (slot * slot_range);
+      if (deadline < _elapsed || (level != 0 && deadline == _elapsed)) {
+        // timers that are too far are stored in the top level and can wrap around
+        deadline += level_range;
+      }
+
+      return expiration{.level = level, .slot = slot, .deadline = deadline};
+    }
+    return std::nullopt;
+  }
+
+  std::uint32_t allocate_node() {
+    if (_free_head != npos) {
+      const auto index = _free_head;
+      _free_head = _nodes[index].next;
+      return index;
+    }
+
+    ASYNC_CORO_ASSERT(_nodes.size() < (std::size_t{1} << index_bits) - 1);
+
+    _nodes.emplace_back();
+    return static_cast<std::uint32_t>(_nodes.size() - 1);
+  }
+
+  void free_node(std::uint32_t index) noexcept {
+    auto& timer = _nodes[index];
+    timer.value.reset();
+    timer.is_periodic = false;
+    timer.prev = npos;
+    timer.next = _free_head;
+
+    // id should never be 0 and should change for the next timer of this node
+    do {
+      timer.generation++;
+    } while ((make_id(0, timer.generation) >> index_bits) == 0);
+
+    _free_head = index;
+    _size--;
+  }
+
+  void link(std::uint32_t index) noexcept {
+    auto& timer = _nodes[index];
+
+    const auto tick = timer.when_tick - _elapsed > max_ticks ? _elapsed + max_ticks : timer.when_tick;
+    const auto masked = std::min((_elapsed ^ tick) | (num_slots - 1), max_ticks);
+    const auto level = static_cast<std::uint32_t>((std::bit_width(masked) - 1) / slot_bits);
+    const auto slot = static_cast<std::uint32_t>((tick >> (level * slot_bits)) & (num_slots - 1));
+    const auto list = (level * num_slots) + slot;
+
+    timer.list = static_cast<std::uint16_t>(list);
+    timer.prev = npos;
+    timer.next = _heads[list];
+    if (timer.next != npos) {
+      _nodes[timer.next].prev = index;
+    }
+    _heads[list] = index;
+    _occupied[level] |= std::uint64_t{1} << slot;
+  }
+
+  void unlink(std::uint32_t index) noexcept {
+    auto& timer = _nodes[index];
+
+    if (timer.prev != npos) {
+      _nodes[timer.prev].next = timer.next;
+    } else {
+      _heads[timer.list] = timer.next;
+    }
+    if (timer.next != npos) {
+      _nodes[timer.next].prev = timer.prev;
+    }
+
+    if (_heads[timer.list] == npos) {
+      _occupied[timer.list / num_slots] &= ~(std::uint64_t{1} << (timer.list % num_slots));
+    }
+  }
+
+ private:
+  const clock::duration _resolution;
+  const clock::time_point _start;
+  const id_type _generation_mask;
+  std::uint64_t _elapsed = 0;
+  std::pmr::vector<node> _nodes;
+  std::array<std::uint32_t, num_levels * num_slots> _heads{};
+  std::array<std::uint64_t, num_levels> _occupied{};
+  std::uint32_t _free_head = npos;
+  std::size_t _size = 0;
+};
+
+}  // namespace async_coro::internal
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace async_coro {
+
+/**
+ * @brief NUMA node with the CPUs that belong to it
+ */
+struct numa_node {
+  // Id of the node in the OS, ids can have gaps
+  std::uint32_t id = 0;
+
+  // CPUs of the node in ascending order
+  std::vector<std::uint32_t> cpus;
+};
+
+/**
+ * @brief NUMA topology of the machine
+ *
+ * Nodes are read from /sys/devices/system/node. Machines without this directory or without NUMA
+ * are described by a single node with all hardware threads. Nodes are addressed by their index
+ * in get_nodes(), not by OS id.
+ */
+class numa_topology {
+ public:
+  // Node index of threads whose node is not set
+  static constexpr std::uint32_t no_node = ~std::uint32_t{0};
+
+  // Upper bound of CPU ids in CPU lists, equals max NR_CPUS of the linux kernel
+  static constexpr std::uint32_t max_cpus = 8192;
+
+  /**
+   * @brief Creates topology with a single node that has all hardware threads
+   */
+  numa_topology();
+
+  /**
+   * @brief Creates topology from the nodes. Empty list gives a single node topology
+   */
+  explicit numa_topology(std::vector<numa_node> nodes);
+
+  /**
+   * @brief Reads topology of the machine, falls back to a single node
+   */
+  [[nodiscard]] static numa_topology discover();
+
+  /**
+   * @brief Reads topology from node directories (node0, node1...) with cpulist files in the directory.
+   * Falls back to a single node if there are no readable nodes
+   */
+  [[nodiscard]] static numa_topology read_from(const std::string &node_directory);
+
+  /**
+   * @brief Parses CPU list in the kernel format, like "0-3,8,10-11"
+   * @return false if the list is malformed or has CPUs not below max_cpus. cpus are left in an unspecified state in this case
+   */
+  static bool parse_cpu_list(std::string_view list, std::vector<std::uint32_t> &cpus);
+
+  [[nodiscard]] const std::vector<numa_node> &get_nodes() const noexcept { return _nodes; }
+
+  [[nodiscard]] std::uint32_t get_num_nodes() const noexcept { return static_cast<std::uint32_t>(_nodes.size()); }
+
+  /**
+   * @brief Returns index of the node of the CPU. CPUs that are not in any node belong to the first one
+   */
+  [[nodiscard]] std::uint32_t get_node_of_cpu(std::uint32_t cpu) const noexcept;
+
+  /**
+   * @brief Returns index of the node the calling thread belongs to
+   *
+   * Workers assigned to a node return it, other threads return node of the CPU they run on now.
+   */
+  [[nodiscard]] std::uint32_t get_current_node() const noexcept;
+
+  /**
+   * @brief Assigns the calling thread to the node. no_node removes assignment
+   */
+  static void set_current_thread_node(std::uint32_t node_index) noexcept;
+
+  /**
+   * @brief Returns the node assigned to the calling thread or no_node
+   */
+  [[nodiscard]] static std::uint32_t get_current_thread_node() noexcept;
+
+  /**
+   * @brief Returns the CPU the calling thread runs on now, 0 if it is unknown
+   */
+  [[nodiscard]] static std::uint32_t get_current_cpu() noexcept;
+
+ private:
+  std::vector<numa_node> _nodes;
+
+  // Node index of every CPU
+  std::vector<std::uint32_t> _cpu_nodes;
+};
+
+}  // namespace async_coro
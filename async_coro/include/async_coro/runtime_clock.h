@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace async_coro {
+
+/**
+ * @brief Source of the current time for delayed tasks and time based awaitables
+ */
+enum class clock_mode : std::uint8_t {
+  // steady_clock is read on every request
+  precise,
+  // Workers read steady_clock once per loop iteration. Code executed by workers sees time of the iteration start
+  cached,
+  // Like cached but workers read CLOCK_MONOTONIC_COARSE where it is available. Reading is much cheaper
+  // but resolution is a kernel tick (1-4 ms). Falls back to steady_clock on other platforms
+  coarse,
+};
+
+/**
+ * @brief Clock of the runtime with per thread cache of the current time
+ *
+ * Time points are compatible with std::chrono::steady_clock. Workers of execution systems with
+ * cached or coarse clock_mode refresh the cache of their thread once per loop iteration, other threads
+ * read steady_clock. Cached time can be behind the real time up to the duration of the current iteration
+ * (plus resolution in coarse mode), so delays counted from it can end a bit earlier than from the real time.
+ */
+class runtime_clock {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Returns the cached time of the current thread or the time of steady_clock if there is no cache
+   */
+  [[nodiscard]] static clock::time_point now() noexcept;
+
+  /**
+   * @brief Reads the clock of the mode without using the cache
+   */
+  [[nodiscard]] static clock::time_point read(clock_mode mode) noexcept;
+
+  /**
+   * @brief Updates the cache of the current thread. Cache is turned off for precise mode
+   * @return The new time
+   */
+  static clock::time_point refresh(clock_mode mode) noexcept;
+
+  /**
+   * @brief Turns off the cache of the current thread
+   */
+  static void reset() noexcept;
+
+  /**
+   * @brief Returns max delay of coarse clock from steady_clock. Is zero if coarse clock isn't available
+   */
+  [[nodiscard]] static clock::duration coarse_resolution() noexcept;
+};
+
+}  // namespace async_coro
@@ -13,6 +13,7 @@
 #if ASYNC_CORO_WITH_EXCEPTIONS
 #include <exception>
 #endif
+#include <memory_resource>
 #include <utility>
 #include <vector>
 
@@ -44,8 +45,9 @@ class scheduler {
   /**
    * @brief Constructs a scheduler with a provided execution system.
    * @param system The execution system to use for scheduling tasks.
+   * @param resource Memory resource for internal allocations of the scheduler. Should outlive the scheduler.
    */
-  explicit scheduler(i_execution_system::ptr system) noexcept;
+  explicit scheduler(i_execution_system::ptr system, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept;
 
   /**
    * @brief Destroys the scheduler, destroying all managed coroutines.
@@ -71,6 +73,7 @@ class scheduler {
     auto handle = coro.release_handle(passkey{this});
     task_handle<R> result{handle, transfer_ownership{}};
     if (!handle.done()) [[likely]] {
+      handle.promise().set_deadline(launcher.get_deadline().value);
       add_coroutine(handle.promise(), launcher.get_start_function(), launcher.get_execution_queue());
       return result;
     }
@@ -87,7 +90,14 @@ class scheduler {
   template <typename... RArgs>
     requires(is_task_launchable<RArgs...>)
   auto start_task(RArgs&&... launcher_args) {
-    return start_task(task_launcher{std::forward<RArgs>(launcher_args)...});
+    if constexpr (sizeof...(RArgs) == 1 && is_task_launchable<RArgs..., execution_queue_mark, std::pmr::memory_resource&>) {
+      // start functions are allocated from the resource of the scheduler
+      return start_task(task_launcher{std::forward<RArgs>(launcher_args)..., execution_queues::main, *_memory_resource});
+    } else if constexpr (is_task_launchable<RArgs..., std::pmr::memory_resource&>) {
+      return start_task(task_launcher{std::forward<RArgs>(launcher_args)..., *_memory_resource});
+    } else {
+      return start_task(task_launcher{std::forward<RArgs>(launcher_args)...});
+    }
   }
 
   /**
@@ -111,6 +121,14 @@ class scheduler {
     return *_execution_system.get();
   }
 
+  /**
+   * @brief Gets memory resource used for internal allocations.
+   * Start functions of start_task and continuations of task_handle::continue_with are allocated from it.
+   */
+  [[nodiscard]] std::pmr::memory_resource* get_memory_resource() const noexcept {
+    return _memory_resource;
+  }
+
 #if ASYNC_CORO_WITH_EXCEPTIONS && ASYNC_CORO_COMPILE_WITH_EXCEPTIONS
   void set_unhandled_exception_handler(unique_function<void(std::exception_ptr)> handler) noexcept;
 #endif
@@ -124,7 +142,7 @@ class scheduler {
    * thread is suitable, or schedule it for later execution.
    * @param handle_impl The handle of the coroutine to continue.
    */
-  void continue_execution(base_handle& handle_impl, std::thread::id current_thread, passkey_any<internal::coroutine_suspender, base_handle>);
+  void continue_execution(base_handle& handle_impl, thread_index current_thread, passkey_any<internal::coroutine_suspender, base_handle>);
 
   /**
    * @brief Embed coroutine. Parent and child coroutines switch to suspended state, child will be continued after parent suspension point
@@ -134,9 +152,9 @@ class scheduler {
   void on_child_coro_added(base_handle& parent, base_handle& child, passkey<task_base>);
 
  private:
-  bool is_thread_fits(execution_queue_mark execution_queue, std::thread::id thread_id) noexcept;
+  bool is_thread_fits(execution_queue_mark execution_queue, thread_index thread_id) noexcept;
   void add_coroutine(base_handle& handle_impl, callback_base_ptr<false> start_function, execution_queue_mark execution_queue);
-  void continue_execution_impl(base_handle& handle_impl, std::thread::id current_thread);
+  void continue_execution_impl(base_handle& handle_impl, thread_index current_thread);
   void plan_continue_on_thread(base_handle& handle_impl, execution_queue_mark execution_queue);
   void change_execution_queue(base_handle& handle_impl, execution_queue_mark execution_queue);
   base_handle_ptr cleanup_coroutine(base_handle& handle_impl, bool cancelled);
@@ -144,7 +162,8 @@ class scheduler {
  private:
   mutex _mutex;
   i_execution_system::ptr _execution_system;
-  std::vector<base_handle_ptr> CORO_THREAD_GUARDED_BY(_mutex) _managed_coroutines;
+  std::pmr::memory_resource* _memory_resource;
+  std::pmr::vector<base_handle_ptr> CORO_THREAD_GUARDED_BY(_mutex) _managed_coroutines;
   bool _is_destroying CORO_THREAD_GUARDED_BY(_mutex) = false;
 
 #if ASYNC_CORO_WITH_EXCEPTIONS && ASYNC_CORO_COMPILE_WITH_EXCEPTIONS
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <async_coro/atomic_queue.h>
+#include <async_coro/config.h>
+#include <async_coro/internal/hardware_interference_size.h>
+#include <async_coro/warnings.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace async_coro {
+
+namespace internal {
+
+/**
+ * @brief Returns index of the current thread that is stable during the whole thread lifetime.
+ * Indices are given out sequentially in the order of the first call.
+ */
+inline std::uint32_t get_producer_slot() noexcept {
+  static std::atomic_uint32_t next_slot{0};
+  thread_local const std::uint32_t slot = next_slot.fetch_add(1, std::memory_order::relaxed);
+  return slot;
+}
+
+}  // namespace internal
+
+ASYNC_CORO_WARNINGS_MSVC_PUSH
+ASYNC_CORO_WARNINGS_MSVC_IGNORE(4324)
+
+/**
+ * @brief A thread safe unbounded queue split into several atomic_queue shards.
+ * Every producer thread always pushes to the same shard selected by its thread slot, so producers
+ * from different threads rarely contend on the same locks. Consumers scan shards round-robin.
+ * Values pushed by one thread are popped in FIFO order, there is no ordering between different producers.
+ * @tparam T The type of the values to be stored in the queue.
+ */
+template <typename T>
+class sharded_atomic_queue {
+  struct alignas(std::hardware_constructive_interference_size) shard {
+    shard(std::pmr::memory_resource* resource, std::uint32_t index) noexcept : queue(resource), consumer_cursor(index) {}
+
+    atomic_queue<T> queue;
+
+    // Shard where consumers with the slot of this shard continue scanning. Consumers start from different shards and keep own position.
+    // Threads whose slots map to the same shard share it, their races only change the shard to start from
+    std::atomic_uint32_t consumer_cursor;
+  };
+
+ public:
+  /**
+   * @brief Construct a new sharded atomic queue object
+   * @param num_shards Number of shards. If 0 number of hardware threads is used.
+   * @param resource Memory resource used to allocate shards and their banks. Should outlive the queue.
+   */
+  explicit sharded_atomic_queue(std::uint32_t num_shards, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : _num_shards(num_shards != 0 ? num_shards : std::max(1U, std::thread::hardware_concurrency())),
+        _allocator(resource),
+        _shards(_allocator.allocate(_num_shards)) {
+    for (std::uint32_t i = 0; i < _num_shards; i++) {
+      _allocator.construct(std::addressof(_shards[i]), resource, i);
+    }
+  }
+
+  sharded_atomic_queue(const sharded_atomic_queue&) = delete;
+  sharded_atomic_queue(sharded_atomic_queue&&) = delete;
+
+  ~sharded_atomic_queue() noexcept {
+    std::destroy_n(_shards, _num_shards);
+    _allocator.deallocate(_shards, _num_shards);
+  }
+
+  sharded_atomic_queue& operator=(const sharded_atomic_queue&) = delete;
+  sharded_atomic_queue& operator=(sharded_atomic_queue&&) = delete;
+
+  /**
+   * @brief Pushes a new value to the shard of the current thread.
+   */
+  template <typename... U>
+  void push(U&&... val) {
+    producer_shard().push(std::forward<U>(val)...);
+  }
+
+  /**
+   * @brief Pushes all values of the range to the shard of the current thread.
+   */
+  template <std::ranges::sized_range R>
+  void push_bulk(R&& range) {
+    producer_shard().push_bulk(std::forward<R>(range));
+  }
+
+  /**
+   * @brief Tries to pop a value from any shard.
+   * @return true if a value was popped successfully, false if all shards are empty.
+   */
+  bool try_pop(T& val) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    auto& cursor = consumer_cursor();
+    const auto start = cursor.load(std::memory_order::relaxed);
+
+    for (std::uint32_t i = 0; i < _num_shards; i++) {
+      const auto index = (start + i) % _num_shards;
+      if (_shards[index].queue.try_pop(val)) {
+        // continue from the next shard to be fair to all producers
+        cursor.store(index + 1, std::memory_order::relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Tries to pop a value from any shard and invokes func with it in place.
+   * @return true if a value was consumed, false if all shards are empty.
+   */
+  template <typename F>
+  bool try_consume(F&& func) noexcept(std::is_nothrow_invocable_v<F&, T&>) {
+    auto& cursor = consumer_cursor();
+    const auto start = cursor.load(std::memory_order::relaxed);
+
+    for (std::uint32_t i = 0; i < _num_shards; i++) {
+      const auto index = (start + i) % _num_shards;
+      if (_shards[index].queue.try_consume(func)) {
+        cursor.store(index + 1, std::memory_order::relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Tries to pop up to max_values values from shards.
+   * @return number of popped values.
+   */
+  template <std::output_iterator<T&&> OutIt>
+  std::size_t try_pop_bulk(OutIt out, std::size_t max_values) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    auto& cursor = consumer_cursor();
+    const auto start = cursor.load(std::memory_order::relaxed);
+
+    std::size_t num_values = 0;
+    for (std::uint32_t i = 0; i < _num_shards && num_values < max_values; i++) {
+      const auto index = (start + i) % _num_shards;
+      const auto num_popped = _shards[index].queue.try_pop_bulk(out, max_values - num_values);
+      if (num_popped != 0) {
+        if constexpr (std::forward_iterator<OutIt>) {
+          // iterator was copied to the shard so skip already written values. Copies of other output iterators share position
+          std::ranges::advance(out, static_cast<std::iter_difference_t<OutIt>>(num_popped));
+        }
+        num_values += num_popped;
+        cursor.store(index + 1, std::memory_order::relaxed);
+      }
+    }
+    return num_values;
+  }
+
+  /**
+   * @brief Checks if any shard has values.
+   */
+  [[nodiscard]] bool has_value() const noexcept {
+    for (std::uint32_t i = 0; i < _num_shards; i++) {
+      if (_shards[i].queue.has_value()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Sets number of values that queue keeps allocated after it was drained. Capacity is split between shards.
+   */
+  void set_retained_capacity(std::size_t num_values) noexcept {
+    const auto num_by_shard = (num_values + _num_shards - 1) / _num_shards;
+    for (std::uint32_t i = 0; i < _num_shards; i++) {
+      _shards[i].queue.set_retained_capacity(num_by_shard);
+    }
+  }
+
+  /**
+   * @brief Releases all fully free banks of all shards.
+   */
+  void shrink_to_fit() noexcept {
+    for (std::uint32_t i = 0; i < _num_shards; i++) {
+      _shards[i].queue.shrink_to_fit();
+    }
+  }
+
+  /**
+   * @brief Returns total number of allocated banks of all shards.
+   */
+  [[nodiscard]] std::size_t get_num_banks() const noexcept {
+    std::size_t num_banks = 0;
+    for (std::uint32_t i = 0; i < _num_shards; i++) {
+      num_banks += _shards[i].queue.get_num_banks();
+    }
+    return num_banks;
+  }
+
+  /**
+   * @brief Returns number of shards.
+   */
+  [[nodiscard]] std::uint32_t get_num_shards() const noexcept { return _num_shards; }
+
+ private:
+  atomic_queue<T>& producer_shard() noexcept {
+    return _shards[internal::get_producer_slot() % _num_shards].queue;
+  }
+
+  // Cursor is kept per queue, so consuming from one queue doesn't move the position in others
+  std::atomic_uint32_t& consumer_cursor() noexcept {
+    return _shards[internal::get_producer_slot() % _num_shards].consumer_cursor;
+  }
+
+ private:
+  const std::uint32_t _num_shards;
+  std::pmr::polymorphic_allocator<shard> _allocator;
+  shard* const _shards;
+};
+
+ASYNC_CORO_WARNINGS_MSVC_POP
+
+}  // namespace async_coro
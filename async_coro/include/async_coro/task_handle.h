@@ -111,7 +111,7 @@ class task_handle final {
     if (done()) {
       func(promise, false);
     } else {
-      auto* continue_f = callback_ptr::allocate(std::forward<Fx>(func)).release();
+      auto* continue_f = callback_ptr::allocate(std::forward<Fx>(func), *promise.get_memory_resource()).release();
       promise.set_continuation_functor(callback_ptr{continue_f}, passkey{this});
       auto [state, cancelled] = promise.get_coroutine_state_and_cancelled(std::memory_order::acquire);
       if (state == async_coro::coroutine_state::finished || cancelled) {
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <async_coro/execution_queue_mark.h>
+#include <async_coro/i_execution_system.h>
 #include <async_coro/internal/type_traits.h>
 #include <async_coro/task.h>
 #include <async_coro/utils/allocate_callback.h>
 #include <async_coro/utils/callback_ptr.h>
 
+#include <memory_resource>
 #include <type_traits>
 
 namespace async_coro {
@@ -74,6 +76,18 @@ class task_launcher {
   task_launcher(T&& start_function, execution_queue_mark execution_queue)
       : task_launcher(allocate_callback(std::forward<T>(start_function)), execution_queue) {}
 
+  /**
+   * @brief Constructs a task launcher with any callable that returns a task<R>, allocated from the memory resource.
+   *
+   * @param start_function A callable that returns a task<R> when invoked
+   * @param execution_queue The execution queue where the task should be scheduled
+   * @param resource Memory resource for the start function. Should outlive the launched task
+   */
+  template <typename T>
+    requires(std::is_invocable_r_v<task<R>, T> && !std::is_convertible_v<T &&, task<R> (*)()>)
+  task_launcher(T&& start_function, execution_queue_mark execution_queue, std::pmr::memory_resource& resource)
+      : task_launcher(allocate_callback(std::forward<T>(start_function), resource), execution_queue) {}
+
   /**
    * @brief Constructs a task launcher with any callable that returns a task<R> and execution queue.
    *
@@ -151,10 +165,25 @@ class task_launcher {
     return _execution_queue;
   }
 
+  /**
+   * @brief Sets deadline of the task. It is used when the task is planned on deadline queues
+   */
+  void set_deadline(task_deadline deadline) noexcept {
+    _deadline = deadline;
+  }
+
+  /**
+   * @brief Gets deadline of the task.
+   */
+  [[nodiscard]] task_deadline get_deadline() const noexcept {
+    return _deadline;
+  }
+
  private:
   callback_ptr<task<R>()> _start_function = nullptr;
   task<R> _coro;
   execution_queue_mark _execution_queue;
+  task_deadline _deadline;
 };
 
 template <typename R>
@@ -180,6 +209,10 @@ template <typename T>
   requires(std::is_invocable_v<T> && internal::is_task_v<std::invoke_result_t<T>>)
 task_launcher(T&&, execution_queue_mark) -> task_launcher<internal::unwrap_task_t<std::invoke_result_t<T>>>;
 
+template <typename T>
+  requires(std::is_invocable_v<T> && internal::is_task_v<std::invoke_result_t<T>>)
+task_launcher(T&&, execution_queue_mark, std::pmr::memory_resource&) -> task_launcher<internal::unwrap_task_t<std::invoke_result_t<T>>>;
+
 template <typename... TArgs>
 concept is_task_launchable = requires(TArgs&&... task) { task_launcher{std::forward<TArgs>(task)...}; };
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace async_coro {
+
+/**
+ * @brief Compact process wide index of a thread
+ *
+ * Replaces std::thread::id in hot paths of the scheduler: it fits in 4 bytes and is read
+ * from a thread local variable. Every thread gets a unique index on the first call of current().
+ * Default constructed index doesn't belong to any thread.
+ */
+class thread_index {
+ public:
+  constexpr thread_index() noexcept = default;
+
+  /**
+   * @brief Returns the index of the calling thread
+   */
+  [[nodiscard]] static thread_index current() noexcept;
+
+  [[nodiscard]] constexpr std::uint32_t get_value() const noexcept { return _value; }
+
+  constexpr bool operator==(const thread_index&) const noexcept = default;
+
+ private:
+  constexpr explicit thread_index(std::uint32_t value) noexcept
+      : _value(value) {}
+
+ private:
+  std::uint32_t _value = 0;
+};
+
+}  // namespace async_coro
@@ -2,8 +2,15 @@
 
 #include <async_coro/config.h>
 
+#if !defined(__linux__)
+#include <async_coro/thread_safety/condition_variable.h>
+#include <async_coro/thread_safety/mutex.h>
+#endif
+
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <type_traits>
 
 namespace async_coro {
 
@@ -21,11 +28,24 @@ class thread_notifier {
 
   // Notifies sleeping thread or will force to skip next sleep of the thread.
   // Returns true if sleeping thread was awaken.
+  // Lock free on linux for both sleep and sleep_until, so it can be called from lock free planning paths.
   bool notify() noexcept {
-    if (_state.exchange(state_signalled, std::memory_order::relaxed) == state_sleeping) {
+    if (const auto state = _state.load(std::memory_order::relaxed); state == state_sleeping || state == state_sleeping_until) {
+      // thread will likely be woken up by this call, its wake latency is counted from here.
+      // Published by release of the exchange below
+      _notify_time.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order::relaxed);
+    }
+
+    // release pairs with acquire in reset_notification so woken thread sees all data pushed before notification
+    const auto prev_state = _state.exchange(state_signalled, std::memory_order::release);
+    if (prev_state == state_sleeping) {
       _state.notify_one();
       return true;
     }
+    if (prev_state == state_sleeping_until) {
+      wake_timed();
+      return true;
+    }
     return false;
   }
 
@@ -44,22 +64,68 @@ class thread_notifier {
     }
   }
 
+  // Puts current thread in sleep until receive notification or time point is reached.
+  // If we got notification after reset_notification but before sleep, this sleep will be ignored.
+  template <class TClock, class TDuration>
+  void sleep_until(const std::chrono::time_point<TClock, TDuration>& time) noexcept {
+    auto expected = state_idle;
+    if (_state.compare_exchange_strong(expected, state_sleeping_until, std::memory_order::relaxed)) {
+      if constexpr (std::is_same_v<TClock, std::chrono::steady_clock>) {
+        wait_timed(std::chrono::time_point_cast<std::chrono::steady_clock::duration>(time));
+      } else {
+        wait_timed(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(time - TClock::now()));
+      }
+
+      // state is still sleeping if time is out
+      _state.exchange(state_idle, std::memory_order::acq_rel);
+    } else if (expected == state_signalled) {
+      reset_notification();
+    } else {
+      ASYNC_CORO_ASSERT(false && "Unexpected state");  // NOLINT(*-static-assert)
+    }
+  }
+
+  // Returns time of the last notification that found the thread sleeping and resets it.
+  // Called by owning thread right after sleep to get latency of its wakeup. Returns zero time point if there was no notification.
+  std::chrono::steady_clock::time_point take_notify_time() noexcept {
+    return std::chrono::steady_clock::time_point{std::chrono::steady_clock::duration{_notify_time.exchange(0, std::memory_order::relaxed)}};
+  }
+
   // Can be called by owning thread (who calls sleep) to reset any previous notifications.
   void reset_notification() noexcept {
-    ASYNC_CORO_ASSERT(_state.load(std::memory_order::relaxed) != state_sleeping);
+    // Synchronizes with notify, as lock free queues don't give any other synchronization between producer and consumer
+    ASYNC_CORO_ASSERT_VARIABLE const auto prev_state = _state.exchange(state_idle, std::memory_order::acq_rel);
 
-    // No real acq_rel synchronization of data, just to prevent any reordering
-    _state.store(state_idle, std::memory_order::release);
+    ASYNC_CORO_ASSERT(prev_state != state_sleeping && prev_state != state_sleeping_until);
   }
 
  private:
-  static constexpr uint8_t state_idle = 0;
-  static constexpr uint8_t state_sleeping = 1;
-  static constexpr uint8_t state_signalled = 2;
+  // Blocks until state leaves state_sleeping_until or time is reached.
+  void wait_timed(std::chrono::steady_clock::time_point time) noexcept;
+
+  // Wakes thread blocked in wait_timed. Called after state was changed from state_sleeping_until.
+  void wake_timed() noexcept;
+
+  static constexpr uint32_t state_idle = 0;
+  static constexpr uint32_t state_sleeping = 1;
+  static constexpr uint32_t state_signalled = 2;
+  static constexpr uint32_t state_sleeping_until = 3;
+
+  // 32 bit wide as on linux timed sleep waits on it with futex
+  std::atomic<uint32_t> _state = state_idle;
+
+  // Time since epoch of the last notification that found the thread sleeping
+  std::atomic<std::chrono::steady_clock::rep> _notify_time = 0;
 
-  std::atomic<uint8_t> _state = state_idle;
+#if !defined(__linux__)
+  // Used only by sleep_until as atomic wait has no timeout and there is no futex.
+  // Here notify of timed sleeper takes the lock to not lose the wake up.
+  async_coro::mutex _mutex;
+  async_coro::condition_variable _timed_cv;
+#endif
 
-  static_assert(std::atomic<uint8_t>::is_always_lock_free, "Wrong platform");
+  static_assert(std::atomic<uint32_t>::is_always_lock_free, "Wrong platform");
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Wrong platform");
 };
 
 }  // namespace async_coro
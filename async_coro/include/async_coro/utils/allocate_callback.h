@@ -3,6 +3,8 @@
 #include <async_coro/internal/deduce_function_signature.h>
 #include <async_coro/utils/callback_ptr.h>
 
+#include <memory_resource>
+
 namespace async_coro {
 
 /**
@@ -24,4 +26,20 @@ auto allocate_callback(Fx&& func) {
   return ptr::allocate(std::forward<Fx>(func));
 }
 
+/**
+ * @brief Allocates a new concrete callback from the memory resource.
+ *
+ * @tparam Fx The type of the callable to wrap.
+ * @param fx The callable object to be wrapped.
+ * @param resource Memory resource for the callback. Should outlive the callback.
+ * @return A callback_ptr to the newly allocated callback.
+ */
+template <class Fx>
+auto allocate_callback(Fx&& func, std::pmr::memory_resource& resource) {
+  using callback_type = typename internal::deduce_function_signature<std::remove_cvref_t<Fx>>::callback_type;
+  using ptr = callback_ptr<typename callback_type::callback_signature>;
+
+  return ptr::allocate(std::forward<Fx>(func), resource);
+}
+
 }  // namespace async_coro
@@ -5,9 +5,11 @@
 #include <async_coro/utils/always_false.h>
 #include <async_coro/utils/callback_base_ptr.h>
 #include <async_coro/utils/callback_fwd.h>
+#include <async_coro/utils/no_unique_address.h>
 
 #include <atomic>
 #include <cstddef>
+#include <memory_resource>
 #include <optional>
 #include <type_traits>
 #include <utility>
@@ -101,6 +103,11 @@ class callback_ptr<R(TArgs...)> : public callback_base_ptr<false> {
   template <class Fx>
     requires(internal::is_runnable<std::remove_cvref_t<Fx>, R, TArgs...>)
   static callback_ptr allocate(Fx&& func) noexcept(std::is_nothrow_constructible_v<std::remove_cvref_t<Fx>, Fx&&>);
+
+  // allocates callback from the memory resource. Resource should outlive the callback
+  template <class Fx>
+    requires(internal::is_runnable<std::remove_cvref_t<Fx>, R, TArgs...>)
+  static callback_ptr allocate(Fx&& func, std::pmr::memory_resource& resource);
 };
 
 // Callback_base_ptr with ability to execute callback
@@ -166,6 +173,11 @@ class callback_ptr<R(TArgs...) noexcept> : public callback_base_ptr<true> {
   template <class Fx>
     requires(internal::is_noexcept_runnable<std::remove_cvref_t<Fx>, R, TArgs...>)
   static callback_ptr allocate(Fx&& func) noexcept(std::is_nothrow_constructible_v<std::remove_cvref_t<Fx>, Fx&&>);
+
+  // allocates callback from the memory resource. Resource should outlive the callback
+  template <class Fx>
+    requires(internal::is_noexcept_runnable<std::remove_cvref_t<Fx>, R, TArgs...>)
+  static callback_ptr allocate(Fx&& func, std::pmr::memory_resource& resource);
 };
 
 // Thread safe variant of callback_ptr
@@ -316,21 +328,38 @@ inline callback_ptr<R(TArgs...) noexcept>::operator callback_atomic_ptr<R(TArgs.
   return callback_atomic_ptr<R(TArgs...)>{clb};
 }
 
-template <class Fx, class TCallback>
+// Callback allocated with new or from memory resource if WithResource is true
+template <class Fx, class TCallback, bool WithResource = false>
 class callback_on_heap final : public TCallback {
+  struct no_resource {};
+
  public:
   template <class FxRef>
-    requires(!std::is_convertible_v<FxRef &&, callback_on_heap> && std::is_convertible_v<FxRef &&, Fx>)
+    requires(!WithResource && !std::is_convertible_v<FxRef &&, callback_on_heap> && std::is_convertible_v<FxRef &&, Fx>)
   explicit callback_on_heap(FxRef&& func) noexcept(std::is_nothrow_constructible_v<Fx, FxRef&&>)  // NOLINT(*not-moved*)
       : TCallback(&execute),
         _fx(std::forward<FxRef>(func)) {}
 
+  template <class FxRef>
+    requires(WithResource && std::is_convertible_v<FxRef &&, Fx>)
+  callback_on_heap(FxRef&& func, std::pmr::memory_resource& resource) noexcept(std::is_nothrow_constructible_v<Fx, FxRef&&>)  // NOLINT(*not-moved*)
+      : TCallback(&execute),
+        _fx(std::forward<FxRef>(func)),
+        _resource(&resource) {}
+
+  // allocates callback from the resource
+  template <class FxRef>
+    requires(WithResource)
+  static callback_on_heap* allocate(FxRef&& func, std::pmr::memory_resource& resource) {
+    return std::pmr::polymorphic_allocator<callback_on_heap>{&resource}.template new_object<callback_on_heap>(std::forward<FxRef>(func), resource);
+  }
+
  private:
   static void execute(internal::callback_execute_command& cmd, callback_base<TCallback::is_noexcept>& clb) noexcept(TCallback::is_noexcept) {
     auto& self = static_cast<callback_on_heap&>(clb);
 
     if (cmd.execute == internal::callback_execute_type::destroy) {
-      delete &self;  // NOLINT(*owning*)
+      destroy_self(self);
     } else {
       auto& args = cmd.get_arguments<typename TCallback::execute_signature>();
 
@@ -349,13 +378,22 @@ class callback_on_heap final : public TCallback {
       }
 
       if (cmd.execute == internal::callback_execute_type::execute_and_destroy) {
-        delete &self;  // NOLINT(*owning*)
+        destroy_self(self);
       }
     }
   }
 
+  static void destroy_self(callback_on_heap& self) noexcept {
+    if constexpr (WithResource) {
+      std::pmr::polymorphic_allocator<callback_on_heap>{self._resource}.delete_object(&self);
+    } else {
+      delete &self;  // NOLINT(*owning*)
+    }
+  }
+
  private:
   Fx _fx;
+  ASYNC_CORO_NO_UNIQUE_ADDRESS std::conditional_t<WithResource, std::pmr::memory_resource*, no_resource> _resource;
 };
 
 template <typename R, typename... TArgs>
@@ -376,4 +414,18 @@ inline callback_ptr<R(TArgs...)> callback_ptr<R(TArgs...)>::allocate(Fx&& func)
   return callback_ptr{ptr};
 }
 
+template <typename R, typename... TArgs>
+template <class Fx>
+  requires(internal::is_noexcept_runnable<std::remove_cvref_t<Fx>, R, TArgs...>)
+inline callback_ptr<R(TArgs...) noexcept> callback_ptr<R(TArgs...) noexcept>::allocate(Fx&& func, std::pmr::memory_resource& resource) {
+  return callback_ptr{callback_on_heap<std::remove_cvref_t<Fx>, callback_t, true>::allocate(std::forward<Fx>(func), resource)};
+}
+
+template <typename R, typename... TArgs>
+template <class Fx>
+  requires(internal::is_runnable<std::remove_cvref_t<Fx>, R, TArgs...>)
+inline callback_ptr<R(TArgs...)> callback_ptr<R(TArgs...)>::allocate(Fx&& func, std::pmr::memory_resource& resource) {
+  return callback_ptr{callback_on_heap<std::remove_cvref_t<Fx>, callback_t, true>::allocate(std::forward<Fx>(func), resource)};
+}
+
 }  // namespace async_coro
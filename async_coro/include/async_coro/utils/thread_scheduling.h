@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace async_coro {
+
+/**
+ * @brief Scheduling policy of a thread. Values map to SCHED_* policies of Linux
+ */
+enum class thread_sched_policy : std::uint8_t {
+  // Policy is inherited from the creating thread
+  inherit,
+  // SCHED_OTHER, default time sharing policy
+  other,
+  // SCHED_BATCH, time sharing for CPU bound threads that don't need low latency
+  batch,
+  // SCHED_IDLE, runs only when CPU has nothing else to run
+  idle,
+  // SCHED_FIFO, real time policy. Needs priority from 1 to 99 and privileges
+  fifo,
+  // SCHED_RR, real time policy with time slices. Needs priority from 1 to 99 and privileges
+  round_robin,
+};
+
+/**
+ * @brief OS level tuning of a thread applied when it starts
+ *
+ * Default values leave the thread as it was created.
+ */
+struct thread_scheduling {
+  // CPUs the thread is allowed to run on. Empty set doesn't change affinity
+  std::vector<std::uint32_t> cpu_set{};
+
+  // Scheduling policy of the thread
+  thread_sched_policy policy = thread_sched_policy::inherit;
+
+  // Static priority for fifo and round_robin policies, should be 0 for others
+  int priority = 0;
+
+  // Nice value of the thread from -20 to 19. Lower values need privileges
+  std::optional<int> nice_value{};
+
+  /**
+   * @brief Checks if any setting differs from the default
+   */
+  [[nodiscard]] bool is_default() const noexcept {
+    return cpu_set.empty() && policy == thread_sched_policy::inherit && !nice_value.has_value();
+  }
+};
+
+/**
+ * @brief Failure of one setting of thread_scheduling
+ */
+struct thread_scheduling_error {
+  // Name of the thread
+  std::string thread_name;
+
+  // Setting that failed: "cpu_set", "policy" or "nice_value"
+  std::string setting;
+
+  // errno like error code of the failed call
+  int error_code = 0;
+};
+
+/**
+ * @brief Applies the scheduling settings to the calling thread
+ *
+ * Settings are applied independently, every failed one is added to errors and the rest are still applied.
+ * On platforms without support of a setting ENOTSUP is reported for it.
+ *
+ * @param scheduling Settings to apply
+ * @param thread_name Name of the thread used in errors
+ * @param errors Container where errors are added to
+ */
+void apply_thread_scheduling(const thread_scheduling &scheduling, std::string_view thread_name, std::vector<thread_scheduling_error> &errors);
+
+}  // namespace async_coro
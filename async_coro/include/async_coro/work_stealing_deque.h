@@ -0,0 +1,204 @@
+#pragma once
+
+#include <async_coro/config.h>
+#include <async_coro/internal/hardware_interference_size.h>
+#include <async_coro/warnings.h>
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace async_coro {
+
+ASYNC_CORO_WARNINGS_MSVC_PUSH
+ASYNC_CORO_WARNINGS_MSVC_IGNORE(4324)
+
+/**
+ * @brief A bounded Chase-Lev work stealing deque.
+ * The owner thread pushes and pops values at the bottom (LIFO), any other thread can steal values from the top (FIFO).
+ * Owner operations don't take locks and need a CAS only when competing for the last value with a thief.
+ * Unlike the classic algorithm the deque doesn't grow: values are moved in place, so a cell is reused by the owner
+ * only after the thief that took it has finished moving the value out. try_push fails if the deque is full.
+ * @tparam T The type of the values to be stored in the deque.
+ */
+template <typename T>
+class work_stealing_deque {
+  static_assert(std::is_nothrow_destructible_v<T>, "Values of work_stealing_deque should be nothrow destructible");
+  static_assert(std::is_nothrow_move_assignable_v<T>, "Values of work_stealing_deque should be nothrow move assignable");
+
+  union union_store {
+    T value;
+    char tmp_byte;
+
+    union_store() noexcept {}  // NOLINT(*member-init)
+    union_store(const union_store&) = delete;
+    union_store(union_store&&) = delete;
+    ~union_store() noexcept {}
+
+    union_store& operator=(const union_store&) = delete;
+    union_store& operator=(union_store&&) = delete;
+  };
+
+  struct cell {
+    // true while the cell holds a value that wasn't moved out yet
+    std::atomic_bool is_busy{false};
+    union_store val;
+  };
+
+  using t_index = std::int64_t;
+
+ public:
+  /**
+   * @brief Construct a new work stealing deque object
+   * @param capacity Max number of values in the deque. Will be rounded up to the next power of 2.
+   * @param resource Memory resource used to allocate cells. Should outlive the deque.
+   */
+  explicit work_stealing_deque(std::uint32_t capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : _mask(std::bit_ceil(capacity < 2 ? 2U : capacity) - 1),
+        _allocator(resource),
+        _cells(_allocator.allocate(_mask + 1)) {
+    for (std::size_t i = 0; i <= _mask; i++) {
+      _allocator.construct(std::addressof(_cells[i]));
+    }
+  }
+
+  work_stealing_deque(const work_stealing_deque&) = delete;
+  work_stealing_deque(work_stealing_deque&&) = delete;
+
+  /**
+   * @brief Destroy the deque and all the values that are still in it.
+   */
+  ~work_stealing_deque() noexcept {
+    for (std::size_t i = 0; i <= _mask; i++) {
+      if (_cells[i].is_busy.load(std::memory_order::acquire)) {
+        std::destroy_at(std::addressof(_cells[i].val.value));
+      }
+    }
+
+    std::destroy_n(_cells, _mask + 1);
+    _allocator.deallocate(_cells, _mask + 1);
+  }
+
+  work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+  work_stealing_deque& operator=(work_stealing_deque&&) = delete;
+
+  /**
+   * @brief Tries to push a new value to the bottom of the deque. Can be called only by the owner thread.
+   * @param val The arguments to be forwarded to the constructor of T. Arguments are not touched if push fails.
+   * @return true if the value was pushed successfully, false if the deque is full.
+   */
+  template <typename... U>
+  bool try_push(U&&... val) noexcept {
+    static_assert(std::is_nothrow_constructible_v<T, U&&...>, "Values of work_stealing_deque should be nothrow constructible");
+
+    const auto bottom = _bottom.load(std::memory_order::relaxed);
+    const auto top = _top.load(std::memory_order::acquire);
+
+    if (bottom - top > static_cast<t_index>(_mask)) {
+      return false;
+    }
+
+    auto& cell = _cells[static_cast<std::size_t>(bottom) & _mask];
+    if (cell.is_busy.load(std::memory_order::acquire)) {
+      // thief still moves value from this cell
+      return false;
+    }
+
+    new (std::addressof(cell.val.value)) T{std::forward<U>(val)...};
+    cell.is_busy.store(true, std::memory_order::relaxed);
+
+    _bottom.store(bottom + 1, std::memory_order::release);
+    return true;
+  }
+
+  /**
+   * @brief Tries to pop the last pushed value. Can be called only by the owner thread.
+   * @param val The reference to the value where the popped value will be moved to.
+   * @return true if a value was popped successfully, false otherwise.
+   */
+  bool try_pop(T& val) noexcept {
+    const auto bottom = _bottom.load(std::memory_order::relaxed) - 1;
+
+    // seq_cst store/load pair orders bottom publication before reading top, as in the original algorithm
+    _bottom.store(bottom, std::memory_order::seq_cst);
+    auto top = _top.load(std::memory_order::seq_cst);
+
+    if (top > bottom) {
+      // deque is empty
+      _bottom.store(bottom + 1, std::memory_order::relaxed);
+      return false;
+    }
+
+    if (top == bottom) {
+      // the last value, compete with thieves
+      const bool is_won = _top.compare_exchange_strong(top, top + 1, std::memory_order::seq_cst, std::memory_order::relaxed);
+      _bottom.store(bottom + 1, std::memory_order::relaxed);
+      if (!is_won) {
+        return false;
+      }
+    }
+
+    take_value(_cells[static_cast<std::size_t>(bottom) & _mask], val);
+    return true;
+  }
+
+  /**
+   * @brief Tries to steal the oldest value of the deque. Can be called from any thread.
+   * @param val The reference to the value where the stolen value will be moved to.
+   * @return true if a value was stolen successfully, false if the deque is empty or another thread won the race.
+   */
+  bool try_steal(T& val) noexcept {
+    auto top = _top.load(std::memory_order::seq_cst);
+    const auto bottom = _bottom.load(std::memory_order::seq_cst);
+
+    if (top >= bottom) {
+      return false;
+    }
+
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order::seq_cst, std::memory_order::relaxed)) {
+      return false;
+    }
+
+    // owner doesn't reuse the cell until is_busy is reset
+    take_value(_cells[static_cast<std::size_t>(top) & _mask], val);
+    return true;
+  }
+
+  /**
+   * @brief Checks if the deque has any values. The result is approximate when called not from the owner thread.
+   */
+  [[nodiscard]] bool has_value() const noexcept {
+    return _top.load(std::memory_order::relaxed) < _bottom.load(std::memory_order::relaxed);
+  }
+
+  /**
+   * @brief Returns max number of values that can be stored in the deque.
+   */
+  [[nodiscard]] std::size_t capacity() const noexcept { return _mask + 1; }
+
+ private:
+  static void take_value(cell& cell, T& val) noexcept {
+    val = std::move(cell.val.value);
+    std::destroy_at(std::addressof(cell.val.value));
+
+    cell.is_busy.store(false, std::memory_order::release);
+  }
+
+ private:
+  const std::size_t _mask;
+  std::pmr::polymorphic_allocator<cell> _allocator;
+  cell* const _cells;
+
+  // top is modified by thieves, bottom only by the owner
+  alignas(std::hardware_constructive_interference_size) std::atomic<t_index> _top{0};
+  alignas(std::hardware_constructive_interference_size) std::atomic<t_index> _bottom{0};
+};
+
+ASYNC_CORO_WARNINGS_MSVC_POP
+
+}  // namespace async_coro
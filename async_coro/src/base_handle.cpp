@@ -4,10 +4,11 @@
 #include <async_coro/internal/base_handle_ptr.h>
 #include <async_coro/internal/scheduled_run_data.h>
 #include <async_coro/scheduler.h>
+#include <async_coro/thread_index.h>
 #include <async_coro/utils/passkey.h>
 
 #include <atomic>
-#include <thread>
+#include <memory_resource>
 #include <utility>
 
 namespace async_coro {
@@ -17,6 +18,10 @@ base_handle::~base_handle() noexcept {
   ASYNC_CORO_ASSERT(!_on_cancel);
 }
 
+std::pmr::memory_resource* base_handle::get_memory_resource() const noexcept {
+  return _scheduler != nullptr ? _scheduler->get_memory_resource() : std::pmr::get_default_resource();
+}
+
 void base_handle::set_owning_by_task(bool owning) {
   if (owning) {
     inc_num_owners();
@@ -74,7 +79,7 @@ base_handle_ptr base_handle::get_owning_ptr() {
   return base_handle_ptr{this};
 }
 
-base_handle::defer_leave base_handle::enter_update_loop(internal::scheduled_run_data& run_data, internal::scheduled_run_data*& current_data, std::thread::id current_thread) noexcept {
+base_handle::defer_leave base_handle::enter_update_loop(internal::scheduled_run_data& run_data, internal::scheduled_run_data*& current_data, thread_index current_thread) noexcept {
   if (is_execution_thread_same(current_thread)) {
     current_data = _run_data.load(std::memory_order::relaxed);
     if (current_data != nullptr && is_execution_thread_same(current_thread)) {
@@ -118,7 +123,7 @@ bool base_handle::request_cancel() {
 
     internal::scheduled_run_data run_data{};
     internal::scheduled_run_data* current_data = nullptr;
-    auto current_thread = std::this_thread::get_id();
+    auto current_thread = thread_index::current();
 
     auto leave = enter_update_loop(run_data, current_data, current_thread);
 
@@ -136,7 +141,7 @@ bool base_handle::request_cancel() {
   return was_requested;
 }
 
-void base_handle::continue_after_sleep(std::thread::id current_thread) {
+void base_handle::continue_after_sleep(thread_index current_thread) {
   // reset our cancel
   _on_cancel = cancel_callback_ptr{nullptr};
 
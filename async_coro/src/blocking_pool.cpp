@@ -0,0 +1,116 @@
+#include <async_coro/executor_data.h>
+#include <async_coro/internal/blocking_pool.h>
+#include <async_coro/thread_index.h>
+#include <async_coro/thread_safety/unique_lock.h>
+#include <async_coro/utils/set_thread_name.h>
+
+#include <utility>
+
+namespace async_coro::internal {
+
+blocking_pool::blocking_pool(std::uint32_t max_threads, std::chrono::nanoseconds idle_timeout, std::string name, std::pmr::memory_resource* resource)
+    : _max_threads(max_threads),
+      _idle_timeout(idle_timeout),
+      _name(std::move(name)),
+      _resource(resource) {}
+
+blocking_pool::~blocking_pool() noexcept {
+  stop();
+}
+
+bool blocking_pool::try_plan(task_function& func) {
+  unique_lock lock(_mutex);
+
+  if (_is_stopping || _max_threads == 0) {
+    return false;
+  }
+
+  _tasks.push_back(std::move(func));
+
+  if (_tasks.size() <= _num_waiting) {
+    lock.unlock();
+    _cv.notify_one();
+    return true;
+  }
+
+  if (_num_threads < _max_threads) {
+    join_exited();
+
+    _num_threads++;
+    auto self = _threads.emplace(_threads.end());
+    self->thread = std::thread([this, self]() { thread_loop(self); });
+    set_thread_name(self->thread, _name);
+  }
+  // otherwise the task waits for a busy thread
+  return true;
+}
+
+void blocking_pool::stop() noexcept {
+  std::list<pool_thread> threads;
+  {
+    unique_lock lock(_mutex);
+    _is_stopping = true;
+    threads = std::move(_threads);
+  }
+  _cv.notify_all();
+
+  for (auto& pool_thread : threads) {
+    if (pool_thread.thread.joinable()) {
+      pool_thread.thread.join();
+    }
+  }
+}
+
+std::uint32_t blocking_pool::get_num_threads() const noexcept {
+  unique_lock lock(_mutex);
+  return _num_threads;
+}
+
+void blocking_pool::join_exited() {
+  for (auto it = _threads.begin(); it != _threads.end();) {
+    if (it->is_exited) {
+      // thread doesn't take the lock after it marked itself exited
+      it->thread.join();
+      it = _threads.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void blocking_pool::thread_loop(std::list<pool_thread>::iterator self) {
+  executor_data data{_resource};
+  data.set_owning_thread(thread_index::current());
+
+  unique_lock lock(_mutex);
+  while (true) {
+    // pending tasks are executed on stop too, as their awaiters wait for them
+    if (!_tasks.empty()) {
+      auto func = std::move(_tasks.front());
+      _tasks.pop_front();
+
+      lock.unlock();
+      func(data);
+      func = nullptr;
+      lock.lock();
+      continue;
+    }
+
+    if (_is_stopping) {
+      return;
+    }
+
+    _num_waiting++;
+    const bool has_task = _cv.wait_for(lock, _idle_timeout, [this]() CORO_THREAD_REQUIRES(_mutex) { return _is_stopping || !_tasks.empty(); });
+    _num_waiting--;
+
+    if (!has_task) {
+      // the list is moved out on stop, so the entry is marked only while the pool owns it
+      _num_threads--;
+      self->is_exited = true;
+      return;
+    }
+  }
+}
+
+}  // namespace async_coro::internal
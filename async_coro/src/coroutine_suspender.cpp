@@ -3,10 +3,10 @@
 #include <async_coro/internal/coroutine_suspender.h>
 #include <async_coro/internal/scheduled_run_data.h>
 #include <async_coro/scheduler.h>
+#include <async_coro/thread_index.h>
 #include <async_coro/utils/passkey.h>
 
 #include <atomic>
-#include <thread>
 
 namespace async_coro::internal {
 
@@ -66,7 +66,7 @@ void coroutine_suspender::dec_num_suspends() {
       return;
     }
 
-    handle->get_scheduler().continue_execution(*handle, std::this_thread::get_id(), passkey{this});
+    handle->get_scheduler().continue_execution(*handle, thread_index::current(), passkey{this});
   }
 }
 
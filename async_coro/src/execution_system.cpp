@@ -1,33 +1,138 @@
 #include <async_coro/config.h>
 #include <async_coro/execution_system.h>
+#include <async_coro/runtime_clock.h>
+#include <async_coro/thread_index.h>
 #include <async_coro/thread_safety/analysis.h>
 #include <async_coro/thread_safety/unique_lock.h>
 #include <async_coro/utils/set_thread_name.h>
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace async_coro {
 
+namespace {
+
+// Adds the duration to the counter that is written only by one thread
+void add_duration(std::atomic<std::int64_t>& counter, std::chrono::steady_clock::duration duration) noexcept {
+  counter.store(counter.load(std::memory_order::relaxed) + std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+                std::memory_order::relaxed);
+}
+
+// Number of worker slots including slots of all threads of groups
+std::uint32_t count_workers(const execution_system_config& config) noexcept {
+  auto num_workers = config.worker_configs.size();
+  for (const auto& group_config : config.worker_groups) {
+    num_workers += group_config.max_workers;
+  }
+  return static_cast<std::uint32_t>(num_workers);
+}
+
+}  // namespace
+
+std::vector<execution_thread_config> make_numa_worker_configs(const numa_topology& topology, std::uint32_t workers_per_node,
+                                                              execution_thread_mask allowed_tasks, const std::string& name_prefix) {
+  std::vector<execution_thread_config> configs;
+  configs.reserve(static_cast<std::size_t>(topology.get_num_nodes()) * workers_per_node);
+
+  for (std::uint32_t node = 0; node < topology.get_num_nodes(); node++) {
+    for (std::uint32_t i = 0; i < workers_per_node; i++) {
+      auto& worker_config = configs.emplace_back(name_prefix + "_" + std::to_string(topology.get_nodes()[node].id) + "_" + std::to_string(i), allowed_tasks);
+      worker_config.numa_node = node;
+    }
+  }
+  return configs;
+}
+
+thread_local execution_system::current_worker execution_system::_current_worker{};
+
 execution_system::execution_system(const execution_system_config& config, const execution_queue_mark max_queue)
-    : _main_thread_mask(config.main_thread_allowed_tasks),
-      _num_workers(static_cast<std::uint32_t>(config.worker_configs.size())),
-      _max_q(max_queue) {
+    : _memory_resource(config.memory_resource != nullptr ? config.memory_resource : std::pmr::get_default_resource()),
+      _main_thread_data(_memory_resource),
+      _main_thread_mask(config.main_thread_allowed_tasks),
+      _num_workers(count_workers(config)),
+      _max_q(max_queue),
+      _is_work_stealing(config.work_stealing),
+      _is_lifo_slot(config.lifo_slot),
+      _max_lifo_slot_hits(config.max_lifo_slot_hits),
+      _delayed_tasks(config.timer_resolution, std::chrono::steady_clock::now(), _memory_resource),
+      _timer_spin(config.timer_spin_duration),
+      _expired_tasks(_memory_resource),
+      _expired_funcs(_memory_resource),
+      _default_timer_slack{config.default_timer_slack},
+      _clock_mode(config.clock),
+      _blocking_pool(config.blocking_pool.max_threads, config.blocking_pool.idle_timeout, config.blocking_pool.name, _memory_resource) {
   std::atomic<std::size_t> num_threads_to_wait_start = 0;
 
   // NOLINTBEGIN(*-avoid-c-arrays)
   _thread_data = std::make_unique<worker_thread_data[]>(_num_workers);
 
   _tasks_queues = std::make_unique<task_queue[]>(max_queue.get_value() + 1);
+
+  _num_worker_groups = static_cast<std::uint32_t>(config.worker_groups.size());
+  _worker_groups = std::make_unique<worker_group[]>(_num_worker_groups);
   // NOLINTEND(*-avoid-c-arrays)
 
+  // configuration of every worker slot. Slots of groups follow worker_configs
+  std::vector<const execution_thread_config*> slot_configs;
+  slot_configs.reserve(_num_workers);
+  for (const auto& worker_config : config.worker_configs) {
+    slot_configs.push_back(std::addressof(worker_config));
+  }
+  for (std::uint32_t group_index = 0; group_index < _num_worker_groups; group_index++) {
+    const auto& group_config = config.worker_groups[group_index];
+    auto& group = _worker_groups[group_index];
+
+    group.max_workers = group_config.max_workers;
+    group.min_workers = std::min(group_config.min_workers, group_config.max_workers);
+    group.spawn_delay = group_config.spawn_delay;
+    group.idle_timeout = group_config.idle_timeout;
+
+    for (std::uint32_t i = 0; i < group.max_workers; i++) {
+      auto& thread_data = _thread_data[slot_configs.size()];
+      thread_data.group = std::addressof(group);
+      thread_data.name = group_config.worker.name + "_" + std::to_string(i);
+      group.workers.push_back(std::addressof(thread_data));
+      slot_configs.push_back(std::addressof(group_config.worker));
+    }
+  }
+
+  std::vector<execution_queue_config> queue_configs;
+  queue_configs.reserve(max_queue.get_value() + 1);
+  for (uint8_t q_id = 0; q_id <= max_queue.get_value(); q_id++) {
+    queue_configs.push_back({.queue = execution_queue_mark{q_id}});
+  }
+
+  for (const auto& queue_config : config.queue_configs) {
+    if (queue_config.queue.get_value() <= max_queue.get_value()) {
+      queue_configs[queue_config.queue.get_value()] = queue_config;
+    }
+  }
+
+  // topology is read from the system only if it is used
+  const bool is_numa_used = std::ranges::any_of(queue_configs, [](const auto& queue_config) { return queue_config.type == execution_queue_type::numa; }) ||
+                            std::ranges::any_of(slot_configs, [](const auto* worker_config) { return worker_config->numa_node != numa_topology::no_node; });
+  if (config.topology) {
+    _numa = std::make_unique<numa_topology>(*config.topology);
+  } else {
+    _numa = std::make_unique<numa_topology>(is_numa_used ? numa_topology::discover() : numa_topology{});
+  }
+
   for (std::uint32_t i = 0; i < _num_workers; i++) {
-    const auto& worker_config = config.worker_configs[i];
+    const auto& worker_config = *slot_configs[i];
     auto& thread_data = _thread_data[i];
 
     for (uint8_t q_id = 0; q_id <= max_queue.get_value(); q_id++) {
@@ -35,55 +140,185 @@ execution_system::execution_system(const execution_system_config& config, const
       if (mask.allowed(worker_config.allowed_tasks)) {
         auto& task_q = _tasks_queues[q_id];
         thread_data.task_queues.push_back(std::addressof(task_q.queue));
+        thread_data.served_queues.push_back(std::addressof(task_q));
         task_q.workers_data.push_back(std::addressof(thread_data));
+        task_q.has_worker_groups |= thread_data.group != nullptr;
       }
     }
+    // NOLINTNEXTLINE(*-avoid-c-arrays)
+    thread_data.num_served = std::make_unique<std::atomic_uint64_t[]>(thread_data.task_queues.size());
 
+    if (thread_data.group == nullptr) {
+      thread_data.name = worker_config.name;
+    }
+    thread_data.scheduling = worker_config.scheduling;
+
+    if (worker_config.numa_node < _numa->get_num_nodes()) {
+      thread_data.numa_node = worker_config.numa_node;
+      if (thread_data.scheduling.cpu_set.empty()) {
+        thread_data.scheduling.cpu_set = _numa->get_nodes()[worker_config.numa_node].cpus;
+      }
+    }
+
+    thread_data.data = executor_data{_memory_resource};
     thread_data.mask = worker_config.allowed_tasks;
     thread_data.num_loops_before_sleep = worker_config.num_loops_before_sleep;
+    thread_data.idle_policy = worker_config.idle_policy;
+    if (thread_data.idle_policy == worker_idle_policy::adaptive) {
+      thread_data.spin = internal::adaptive_spin{worker_config.min_spin_duration, worker_config.max_spin_duration};
+      thread_data.spin_budget.store(std::chrono::nanoseconds{thread_data.spin.get_budget()}.count(), std::memory_order::relaxed);
+    }
 
     if (!thread_data.task_queues.empty()) {
-      num_threads_to_wait_start.fetch_add(1, std::memory_order::relaxed);
+      if (_is_work_stealing) {
+        thread_data.local_tasks = std::make_unique<work_stealing_deque<task_function>>(config.local_queue_capacity, _memory_resource);
+      }
     }
   }
 
+  if (_is_work_stealing || _is_lifo_slot) {
+    // stolen task should fit the thief so only workers with the same mask are peers
+    for (std::uint32_t i = 0; i < _num_workers; i++) {
+      auto& thread_data = _thread_data[i];
+      if (thread_data.task_queues.empty()) {
+        continue;
+      }
+
+      for (std::uint32_t j = 0; j < _num_workers; j++) {
+        auto& peer = _thread_data[j];
+        if (i != j && !peer.task_queues.empty() && peer.mask == thread_data.mask) {
+          thread_data.peers.push_back(std::addressof(peer));
+        }
+      }
+      thread_data.steal_cursor = i;
+    }
+  }
+
+  if (config.worker_timers) {
+    for (std::uint32_t i = 0; i < _num_workers; i++) {
+      // threads of groups can exit, so their slots don't own timers
+      if (!_thread_data[i].task_queues.empty() && _thread_data[i].group == nullptr) {
+        _timer_workers.push_back(i);
+      }
+    }
+
+    // without running workers delayed tasks are handled by the timer thread
+    if (!_timer_workers.empty()) {
+      _is_worker_timers = true;
+      _timer_owner_bits = static_cast<unsigned>(std::bit_width(_num_workers));
+
+      const auto start = std::chrono::steady_clock::now();
+      for (const auto index : _timer_workers) {
+        _thread_data[index].timers = std::make_unique<worker_timers>(config.timer_resolution, start, _memory_resource,
+                                                                     (sizeof(delayed_task_id::task_id) * 8) - _timer_owner_bits);  // NOLINT(*-magic-*)
+      }
+    }
+  }
+
+  // storage should be selected before any worker starts
+  for (const auto& queue_config : queue_configs) {
+    auto& queue = _tasks_queues[queue_config.queue.get_value()].queue;
+
+    queue.set_memory_resource(_memory_resource);
+    _tasks_queues[queue_config.queue.get_value()].weight = std::max(queue_config.weight, std::uint32_t{1});
+
+    if (queue_config.type == execution_queue_type::bounded) {
+      queue.make_bounded(queue_config.capacity);
+    } else if (queue_config.type == execution_queue_type::sharded) {
+      queue.make_sharded(queue_config.num_shards);
+    } else if (queue_config.type == execution_queue_type::numa) {
+      queue.make_numa(*_numa);
+
+      auto& task_q = _tasks_queues[queue_config.queue.get_value()];
+      task_q.node_workers.resize(_numa->get_num_nodes());
+      task_q.node_wake_cursors = std::vector<std::atomic_uint32_t>(_numa->get_num_nodes());
+      for (auto* worker : task_q.workers_data) {
+        if (worker->numa_node != numa_topology::no_node) {
+          task_q.node_workers[worker->numa_node].push_back(worker);
+        }
+      }
+    } else if (queue_config.type == execution_queue_type::deadline) {
+      queue.make_deadline(queue_config.missed_deadline);
+      _tasks_queues[queue_config.queue.get_value()].is_deadline = true;
+    } else if (get_num_workers_for_queue(queue_config.queue) == 1) {
+      // queues with only one consumer can use cheaper lock free queue
+      queue.make_single_consumer();
+    }
+
+    queue.set_retained_capacity(queue_config.retained_capacity);
+  }
+
   for (std::uint32_t i = 0; i < _num_workers; i++) {
     auto& thread_data = _thread_data[i];
 
-    if (!thread_data.task_queues.empty()) {
-      const auto& worker_config = config.worker_configs[i];
+    if (thread_data.group == nullptr && !thread_data.task_queues.empty()) {
+      start_worker(thread_data, &num_threads_to_wait_start);
+    }
+  }
 
-      thread_data.thread = std::thread([this, &thread_data, &num_threads_to_wait_start]() -> void {
-        thread_data.data.set_owning_thread(std::this_thread::get_id());
+  bool has_elastic_groups = false;
+  for (std::uint32_t group_index = 0; group_index < _num_worker_groups; group_index++) {
+    auto& group = _worker_groups[group_index];
+    if (group.workers.empty() || group.workers.front()->task_queues.empty()) {
+      // group without queues never runs threads
+      group.min_workers = 0;
+      group.max_workers = 0;
+      continue;
+    }
 
-        if (num_threads_to_wait_start.fetch_sub(1, std::memory_order::release) == 1) {
-          num_threads_to_wait_start.notify_one();
-        }
+    for (std::uint32_t i = 0; i < group.min_workers; i++) {
+      group.num_active.fetch_add(1, std::memory_order::relaxed);
+      start_worker(*group.workers[i], &num_threads_to_wait_start);
+    }
 
-        worker_loop(thread_data);
-      });
-      set_thread_name(thread_data.thread, worker_config.name);
+    if (group.min_workers < group.max_workers) {
+      has_elastic_groups = true;
+      _groups_poll_interval = std::min(_groups_poll_interval, group.spawn_delay);
     }
   }
 
+  if (has_elastic_groups) {
+    // planning threads can wake the groups thread up from now
+    _groups_nudged.store(false, std::memory_order::relaxed);
+
+    _groups_thread = std::thread([this]() { groups_loop(); });
+    set_thread_name(_groups_thread, "worker_groups_loop");
+  }
+
   for (uint8_t q_id = 0; q_id <= max_queue.get_value(); q_id++) {
     execution_thread_mask mask{execution_queue_mark{q_id}};
     if (mask.allowed(_main_thread_mask)) {
       _main_thread_queues.push_back(std::addressof(_tasks_queues[q_id].queue));
+      _main_thread_weights.push_back(_tasks_queues[q_id].weight);
     }
   }
+  // NOLINTNEXTLINE(*-avoid-c-arrays)
+  _main_thread_num_served = std::make_unique<std::atomic_uint64_t[]>(_main_thread_queues.size());
+
+  if (!_is_worker_timers) {
+    if (config.high_resolution_timers) {
+      _high_res_timer = std::make_unique<internal::high_resolution_timer>();
+      if (!_high_res_timer->is_valid()) {
+        // timer thread falls back to the condition variable
+        _high_res_timer.reset();
+      }
+    }
 
-  // start timer thread for delayed tasks
-  num_threads_to_wait_start.fetch_add(1, std::memory_order::relaxed);
+    // start timer thread for delayed tasks
+    num_threads_to_wait_start.fetch_add(1, std::memory_order::relaxed);
 
-  _timer_thread = std::thread([this, &num_threads_to_wait_start]() {
-    if (num_threads_to_wait_start.fetch_sub(1, std::memory_order::release) == 1) {
-      num_threads_to_wait_start.notify_one();
-    }
+    _timer_thread = std::thread([this, &num_threads_to_wait_start, &scheduling = config.timer_thread_scheduling]() {
+      // settings are applied before the constructor returns, so errors are visible right after it
+      apply_scheduling(scheduling, "delayed_tasks_loop");
 
-    timer_loop();
-  });
-  set_thread_name(_timer_thread, "delayed_tasks_loop");
+      if (num_threads_to_wait_start.fetch_sub(1, std::memory_order::release) == 1) {
+        num_threads_to_wait_start.notify_one();
+      }
+
+      timer_loop();
+    });
+    set_thread_name(_timer_thread, "delayed_tasks_loop");
+  }
 
   auto num_started = num_threads_to_wait_start.load(std::memory_order::acquire);
   while (num_started != 0) {
@@ -93,8 +328,17 @@ execution_system::execution_system(const execution_system_config& config, const
 }
 
 execution_system::~execution_system() noexcept {
+  // running and pending blocking tasks are finished first, as they can still plan their continuations to the queues
+  _blocking_pool.stop();
+
   _is_stopping.store(true, std::memory_order::release);
 
+  // groups thread is stopped first so it doesn't start new workers
+  _groups_notifier.notify();
+  if (_groups_thread.joinable()) {
+    _groups_thread.join();
+  }
+
   for (std::uint32_t i = 0; i < _num_workers; i++) {
     _thread_data[i].notifier.notify();
   }
@@ -105,6 +349,9 @@ execution_system::~execution_system() noexcept {
     _delayed_tasks.clear();
   }
   _delayed_cv.notify_one();
+  if (_high_res_timer) {
+    _high_res_timer->wake();
+  }
   if (_timer_thread.joinable()) {
     _timer_thread.join();
   }
@@ -116,41 +363,154 @@ execution_system::~execution_system() noexcept {
   }
 }
 
+void execution_system::start_worker(worker_thread_data& data, std::atomic<std::size_t>* num_threads_to_wait_start) {
+  if (num_threads_to_wait_start != nullptr) {
+    num_threads_to_wait_start->fetch_add(1, std::memory_order::relaxed);
+  }
+
+  data.is_running.store(true, std::memory_order::relaxed);
+  data.thread = std::thread([this, &data, num_threads_to_wait_start]() -> void {
+    data.thread_id.store(thread_index::current(), std::memory_order::relaxed);
+    data.data.set_owning_thread(thread_index::current());
+    _current_worker = {.owner = this, .data = std::addressof(data)};
+    numa_topology::set_current_thread_node(data.numa_node);
+
+    apply_scheduling(data.scheduling, data.name);
+
+    if (num_threads_to_wait_start != nullptr && num_threads_to_wait_start->fetch_sub(1, std::memory_order::release) == 1) {
+      num_threads_to_wait_start->notify_one();
+    }
+
+    worker_loop(data);
+
+    _current_worker = {};
+    runtime_clock::reset();
+    numa_topology::set_current_thread_node(numa_topology::no_node);
+
+    data.thread_id.store({}, std::memory_order::relaxed);
+    data.is_running.store(false, std::memory_order::release);
+  });
+  set_thread_name(data.thread, data.name);
+}
+
+void execution_system::apply_scheduling(const thread_scheduling& scheduling, const std::string& thread_name) {
+  if (scheduling.is_default()) {
+    return;
+  }
+
+  std::vector<thread_scheduling_error> errors;
+  apply_thread_scheduling(scheduling, thread_name, errors);
+
+  if (!errors.empty()) {
+    unique_lock lock(_scheduling_errors_mutex);
+    _scheduling_errors.insert(_scheduling_errors.end(), std::make_move_iterator(errors.begin()), std::make_move_iterator(errors.end()));
+  }
+}
+
+std::vector<thread_scheduling_error> execution_system::get_scheduling_errors() const {
+  unique_lock lock(_scheduling_errors_mutex);
+  return _scheduling_errors;
+}
+
 delayed_task_id execution_system::plan_execution_after(task_function func, execution_queue_mark execution_queue,
                                                        std::chrono::steady_clock::time_point when) {
+  return plan_execution_after(std::move(func), execution_queue, when, _default_timer_slack);
+}
+
+delayed_task_id execution_system::plan_execution_after(task_function func, execution_queue_mark execution_queue,
+                                                       std::chrono::steady_clock::time_point when, timer_slack slack) {
   ASYNC_CORO_ASSERT(execution_queue.get_value() <= _max_q.get_value());
   if (!func) [[unlikely]] {
     return {};
   }
 
   // if time is now or in the past, push directly
-  if (when <= std::chrono::steady_clock::now()) {
+  if (when <= runtime_clock::now()) {
     plan_execution(std::move(func), execution_queue);
     return {};
   }
 
+  return insert_delayed_task(delayed_task{std::move(func), execution_queue}, when, slack);
+}
+
+delayed_task_id execution_system::plan_periodic(task_function func, execution_queue_mark execution_queue,
+                                                std::chrono::steady_clock::time_point first_time,
+                                                std::chrono::steady_clock::duration period, missed_tick_policy policy) {
+  ASYNC_CORO_ASSERT(execution_queue.get_value() <= _max_q.get_value());
+  ASYNC_CORO_ASSERT(period > std::chrono::steady_clock::duration::zero());
+  if (!func) [[unlikely]] {
+    return {};
+  }
+
+  // state is allocated once and is shared with pending executions so ticks don't allocate
+  auto periodic = std::allocate_shared<periodic_task>(std::pmr::polymorphic_allocator<periodic_task>{_memory_resource},
+                                                      std::move(func), first_time, period, policy);
+
+  return insert_delayed_task(delayed_task{std::move(periodic), execution_queue}, first_time, {});
+}
+
+delayed_task_id execution_system::insert_delayed_task(delayed_task&& task, std::chrono::steady_clock::time_point when, timer_slack slack) {
+  const auto insert = [&](internal::timing_wheel<delayed_task>& wheel) {
+    return task.periodic ? wheel.insert_periodic(when, std::move(task)) : wheel.insert_with_slack(when, slack.value, std::move(task));
+  };
+
   bool need_notify = false;
-  t_task_id task_id = 0;
+  delayed_task_id task_id;
+
+  if (_is_worker_timers) {
+    const auto owner_index = select_timer_owner(task.queue);
+    auto& owner = _thread_data[owner_index];
+    auto& timers = *owner.timers;
+    {
+      unique_lock lock(timers.mutex);
+
+      task_id.task_id = (insert(timers.tasks) << _timer_owner_bits) | (owner_index + 1);
+
+      // notify only if the worker should wake up earlier than it planned
+      const auto deadline = timers.tasks.next_deadline().value_or(when).time_since_epoch().count();
+      if (deadline < timers.deadline.load(std::memory_order::relaxed)) {
+        timers.deadline.store(deadline, std::memory_order::relaxed);
+        need_notify = true;
+      }
+    }
+
+    if (need_notify && std::addressof(owner) != get_current_worker()) {
+      owner.notifier.notify();
+    }
+
+    return task_id;
+  }
+
   {
     unique_lock lock(_delayed_mutex);
 
-    task_id = _delayed_task_id++;
-    if (_delayed_task_id == 0) [[unlikely]] {
-      _delayed_task_id = 1;
-    }
+    task_id.task_id = insert(_delayed_tasks);
 
-    _delayed_tasks.emplace_back(std::move(func), when, execution_queue, task_id);
-    std::ranges::push_heap(_delayed_tasks, std::greater<delayed_task>{});
+    // notify only if timer thread should wake up earlier than it planned
+    const auto next_deadline = _delayed_tasks.next_deadline();
+    if (next_deadline && *next_deadline < _timer_wakeup) {
+      set_timer_wakeup(*next_deadline);
 
-    // notify only if our value goes on top of the heap
-    need_notify = _delayed_tasks.front().id == task_id;
+      if (_high_res_timer) {
+        // timer is armed under the lock, otherwise a later deadline of a concurrent planner could replace this one
+        _high_res_timer->set_deadline(*next_deadline - _timer_spin);
+      } else {
+        need_notify = true;
+      }
+    }
   }
 
   if (need_notify) {
     _delayed_cv.notify_one();
   }
 
-  return {.task_id = task_id};
+  return task_id;
+}
+
+void execution_system::plan_blocking(task_function func) {
+  if (!_blocking_pool.try_plan(func)) {
+    i_execution_system::plan_blocking(std::move(func));  // NOLINT(*-use-after-move) try_plan doesn't touch func on fail
+  }
 }
 
 bool execution_system::cancel_execution(const delayed_task_id& task_id) {
@@ -158,17 +518,31 @@ bool execution_system::cancel_execution(const delayed_task_id& task_id) {
     return false;
   }
 
-  unique_lock lock(_delayed_mutex);
+  // task is destroyed after unlock
+  delayed_task task;
+  bool is_cancelled = false;
 
-  const auto task_it = std::ranges::find_if(_delayed_tasks, [t_id = task_id.task_id](const delayed_task& task) {
-    return task.id == t_id;
-  });
+  if (_is_worker_timers) {
+    const auto owner = task_id.task_id & ((std::size_t{1} << _timer_owner_bits) - 1);
+    if (owner == 0 || owner > _num_workers || !_thread_data[owner - 1].timers) {
+      return false;
+    }
 
-  if (task_it != _delayed_tasks.end()) {
-    task_it->cancel_execution = true;
-    return true;
+    auto& timers = *_thread_data[owner - 1].timers;
+
+    unique_lock lock(timers.mutex);
+    is_cancelled = timers.tasks.cancel(task_id.task_id >> _timer_owner_bits, task);
+  } else {
+    unique_lock lock(_delayed_mutex);
+    is_cancelled = _delayed_tasks.cancel(task_id.task_id, task);
   }
-  return false;
+
+  if (task.periodic) {
+    // execution of pending ticks can be already planned, it will skip them
+    task.periodic->is_cancelled.store(true, std::memory_order::relaxed);
+  }
+
+  return is_cancelled;
 }
 
 void execution_system::plan_execution(task_function func, execution_queue_mark execution_queue) {
@@ -177,15 +551,47 @@ void execution_system::plan_execution(task_function func, execution_queue_mark e
     return;
   }
 
+  if (try_plan_local(func, execution_queue)) {
+    return;
+  }
+
+  plan_shared(std::move(func), execution_queue);  // NOLINT(*-use-after-move) try_plan_local doesn't touch func on fail
+}
+
+void execution_system::plan_execution(task_function func, execution_queue_mark execution_queue, task_deadline deadline) {
+  ASYNC_CORO_ASSERT(execution_queue.get_value() <= _max_q.get_value());
+
   auto& task_q = _tasks_queues[execution_queue.get_value()];
-  task_q.queue.push(std::move(func));
+  if (!task_q.is_deadline) {
+    plan_execution(std::move(func), execution_queue);
+    return;
+  }
 
-  for (auto* worker : task_q.workers_data) {
-    if (worker->notifier.notify()) {
-      // leave others in sleeping state
-      return;
-    }
+  if (!func) [[unlikely]] {
+    return;
   }
+
+  task_q.queue.push_with_deadline(deadline, std::move(func));
+
+  notify_workers(task_q, 1);
+}
+
+void execution_system::plan_execution_bulk(std::span<task_function> funcs, execution_queue_mark execution_queue) {
+  ASYNC_CORO_ASSERT(execution_queue.get_value() <= _max_q.get_value());
+  if (funcs.empty()) [[unlikely]] {
+    return;
+  }
+
+  if (std::ranges::any_of(funcs, [](const task_function& func) { return !func; })) [[unlikely]] {
+    // empty functions should be skipped
+    i_execution_system::plan_execution_bulk(funcs, execution_queue);
+    return;
+  }
+
+  auto& task_q = _tasks_queues[execution_queue.get_value()];
+  task_q.queue.push_bulk(funcs);
+
+  notify_workers(task_q, funcs.size());
 }
 
 void execution_system::execute_or_plan_execution(task_function func, execution_queue_mark execution_queue, const executor_data& curent_data) {
@@ -199,32 +605,35 @@ void execution_system::execute_or_plan_execution(task_function func, execution_q
   }
 
   // plan execution
+  if (try_plan_local(func, execution_queue)) {
+    return;
+  }
+
+  plan_shared(std::move(func), execution_queue);  // NOLINT(*-use-after-move) try_plan_local doesn't touch func on fail
+}
+
+void execution_system::plan_shared(task_function&& func, execution_queue_mark execution_queue) {
   auto& task_q = _tasks_queues[execution_queue.get_value()];
   task_q.queue.push(std::move(func));
 
-  for (auto* worker : task_q.workers_data) {
-    if (worker->notifier.notify()) {
-      // leave others in sleeping state
-      return;
-    }
-  }
+  notify_workers(task_q, 1);
 }
 
-bool execution_system::is_thread_fits(execution_queue_mark execution_queue, std::thread::id thread_id) const noexcept {
+bool execution_system::is_thread_fits(execution_queue_mark execution_queue, thread_index thread_id) const noexcept {
   ASYNC_CORO_ASSERT(execution_queue.get_value() <= _max_q.get_value());
 
   if (_main_thread_data.get_owning_thread() == thread_id) {
-    if (_main_thread_mask.allowed(execution_queue)) {
-      return true;
-    }
+    return _main_thread_mask.allowed(execution_queue);
+  }
+
+  // callers check the thread they run on, its worker is found without scanning all workers
+  if (const auto& current = _current_worker; current.owner == this && current.data->data.get_owning_thread() == thread_id) {
+    return current.data->mask.allowed(execution_queue);
   }
 
   for (std::uint32_t i = 0; i < _num_workers; i++) {
-    if (_thread_data[i].thread.get_id() == thread_id) {
-      if (_thread_data[i].mask.allowed(execution_queue)) {
-        return true;
-      }
-      break;
+    if (_thread_data[i].thread_id.load(std::memory_order::relaxed) == thread_id) {
+      return _thread_data[i].mask.allowed(execution_queue);
     }
   }
 
@@ -232,17 +641,55 @@ bool execution_system::is_thread_fits(execution_queue_mark execution_queue, std:
 }
 
 void execution_system::update_from_main() {
-  ASYNC_CORO_ASSERT(_main_thread_data.get_owning_thread() == std::this_thread::get_id());
+  ASYNC_CORO_ASSERT(_main_thread_data.get_owning_thread() == thread_index::current());
 
   task_function func;
 
-  // trying to execute one task from each q
-  for (auto* task_q : _main_thread_queues) {
-    if (task_q->try_pop(func)) {
+  // trying to execute up to weight tasks from each q
+  // tasks are moved out of the queue as they may call update_from_main recursively
+  for (std::size_t i = 0; i < _main_thread_queues.size(); i++) {
+    std::uint32_t num_served = 0;
+    while (num_served < _main_thread_weights[i] && _main_thread_queues[i]->try_pop(func)) {
       func(_main_thread_data);
       func = nullptr;
+      num_served++;
+    }
+
+    if (num_served != 0) {
+      auto& counter = _main_thread_num_served[i];
+      counter.store(counter.load(std::memory_order::relaxed) + num_served, std::memory_order::relaxed);
+    }
+  }
+}
+
+std::uint64_t execution_system::get_num_missed_deadlines(execution_queue_mark execution_queue) const noexcept {
+  ASYNC_CORO_ASSERT(execution_queue.get_value() <= _max_q.get_value());
+
+  return _tasks_queues[execution_queue.get_value()].queue.get_num_missed_deadlines();
+}
+
+std::uint64_t execution_system::get_num_served_tasks(execution_queue_mark execution_queue) const noexcept {
+  ASYNC_CORO_ASSERT(execution_queue.get_value() <= _max_q.get_value());
+
+  const auto& task_q = _tasks_queues[execution_queue.get_value()];
+
+  std::uint64_t result = 0;
+  for (const auto* worker : task_q.workers_data) {
+    for (std::size_t i = 0; i < worker->served_queues.size(); i++) {
+      if (worker->served_queues[i] == std::addressof(task_q)) {
+        result += worker->num_served[i].load(std::memory_order::relaxed);
+        break;
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < _main_thread_queues.size(); i++) {
+    if (_main_thread_queues[i] == std::addressof(task_q.queue)) {
+      result += _main_thread_num_served[i].load(std::memory_order::relaxed);
+      break;
     }
   }
+  return result;
 }
 
 std::uint32_t execution_system::get_num_workers_for_queue(execution_queue_mark execution_queue) const noexcept {
@@ -253,19 +700,471 @@ std::uint32_t execution_system::get_num_workers_for_queue(execution_queue_mark e
   return static_cast<std::uint32_t>(task_q.workers_data.size()) + (_main_thread_mask.allowed(execution_queue) ? 1 : 0);
 }
 
+void execution_system::notify_workers(task_queue& task_q, std::size_t num_tasks) noexcept {
+  // pairs with the fence in end_searching: either the searcher sees pushed tasks or we see the searcher
+  std::atomic_thread_fence(std::memory_order::seq_cst);
+
+  // every searching worker takes one task without a wakeup
+  const std::size_t num_searching = task_q.num_searching.load(std::memory_order::relaxed);
+  const auto num_skipped = std::min(num_searching, num_tasks);
+  num_tasks -= num_skipped;
+
+  auto& stats = get_stats_counters();
+  if (num_skipped != 0) {
+    stats.num_skipped_wakeups.fetch_add(num_skipped, std::memory_order::relaxed);
+  }
+
+  const auto num_workers = task_q.workers_data.size();
+  if (num_tasks == 0 || num_workers == 0) {
+    return;
+  }
+
+  // workers are woken in turn so the first ones don't get all the load. Cursor is moved only on wakeups
+  // so busy workers don't make planning threads write to the shared cache line
+  const std::size_t start = task_q.wake_cursor.load(std::memory_order::relaxed);
+  std::uint64_t num_woken = 0;
+
+  if (!task_q.node_workers.empty()) {
+    // tasks of numa queues were pushed to the node of this thread, so its workers take them without cross node traffic
+    const auto node = _numa->get_current_node();
+    const auto& node_workers = task_q.node_workers[node];
+    auto& node_cursor = task_q.node_wake_cursors[node];
+    const std::size_t node_start = node_cursor.load(std::memory_order::relaxed);
+    for (std::size_t i = 0; i < node_workers.size() && num_woken < num_tasks; i++) {
+      const auto index = (node_start + i) % node_workers.size();
+      if (node_workers[index]->notifier.notify()) {
+        node_cursor.store(static_cast<std::uint32_t>(index + 1), std::memory_order::relaxed);
+        num_woken++;
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < num_workers && num_woken < num_tasks; i++) {
+    const auto index = (start + i) % num_workers;
+    if (task_q.workers_data[index]->notifier.notify()) {
+      task_q.wake_cursor.store(static_cast<std::uint32_t>(index + 1), std::memory_order::relaxed);
+      num_woken++;
+    }
+  }
+
+  if (num_woken != 0) {
+    stats.num_wakeups.fetch_add(num_woken, std::memory_order::relaxed);
+  }
+
+  if (num_woken < num_tasks && task_q.has_worker_groups) {
+    // all running workers are busy, groups may start more threads
+    nudge_groups();
+  }
+}
+
+void execution_system::on_task_found(worker_thread_data& data, bool& is_searching) noexcept {
+  // searching ends before the found task runs, so long tasks don't hold back wakeups that were skipped for this worker
+  if (is_searching) {
+    is_searching = false;
+    end_searching(data, true);
+  }
+}
+
+void execution_system::begin_searching(worker_thread_data& data) noexcept {
+  for (auto* task_q : data.served_queues) {
+    task_q->num_searching.fetch_add(1, std::memory_order::relaxed);
+  }
+}
+
+void execution_system::end_searching(worker_thread_data& data, bool found_task) noexcept {
+  for (auto* task_q : data.served_queues) {
+    const auto num_searching = task_q->num_searching.fetch_sub(1, std::memory_order::seq_cst);
+
+    // tasks planned while this worker was the only searcher didn't wake anyone, so the next worker is woken up to take them
+    if (found_task && num_searching == 1 && task_q->queue.has_value()) {
+      notify_workers(*task_q, 1);
+    }
+  }
+
+  // pairs with the fence in notify_workers. Worker checks the queues once more before sleep
+  std::atomic_thread_fence(std::memory_order::seq_cst);
+}
+
+execution_system::stats_counters& execution_system::get_stats_counters() noexcept {
+  auto* worker = get_current_worker();
+  return worker != nullptr ? worker->stats : _stats;
+}
+
+execution_system_stats execution_system::get_stats() const noexcept {
+  execution_system_stats result{
+      .num_wakeups = _stats.num_wakeups.load(std::memory_order::relaxed),
+      .num_skipped_wakeups = _stats.num_skipped_wakeups.load(std::memory_order::relaxed),
+  };
+
+  for (std::uint32_t i = 0; i < _num_workers; i++) {
+    const auto& stats = _thread_data[i].stats;
+    result.num_wakeups += stats.num_wakeups.load(std::memory_order::relaxed);
+    result.num_skipped_wakeups += stats.num_skipped_wakeups.load(std::memory_order::relaxed);
+  }
+  return result;
+}
+
+execution_system::worker_thread_data* execution_system::get_current_worker() const noexcept {
+  // current thread can be a worker of another execution system
+  return _current_worker.owner == this ? _current_worker.data : nullptr;
+}
+
+bool execution_system::try_plan_local(task_function& func, execution_queue_mark execution_queue) {
+  if (!_is_work_stealing && !_is_lifo_slot) {
+    return false;
+  }
+
+  auto* worker = get_current_worker();
+  if (worker == nullptr || !worker->mask.allowed(execution_queue) || _tasks_queues[execution_queue.get_value()].is_deadline) {
+    return false;
+  }
+
+  if (_is_lifo_slot) {
+    // the newest task takes the slot
+    slot_task prev_task;
+    const bool has_prev_task = worker->next_task.try_take(prev_task);
+
+    // put fails only if a peer is stealing the slot right now
+    if (worker->next_task.try_put(std::move(func), execution_queue)) {
+      if (has_prev_task) {
+        if (!try_push_local(*worker, prev_task.func)) {
+          plan_shared(std::move(prev_task.func), prev_task.queue);
+        }
+      } else if (worker->local_tasks && worker->local_tasks->has_value()) {
+        // worker executes its deque after the slot, so the task may wait for a while. Let a peer steal it
+        notify_peer(*worker);
+      }
+      return true;
+    }
+  }
+
+  return try_push_local(*worker, func);
+}
+
+bool execution_system::try_push_local(worker_thread_data& worker, task_function& func) noexcept {
+  if (!worker.local_tasks || !worker.local_tasks->try_push(std::move(func))) {
+    return false;
+  }
+
+  notify_peer(worker);
+  return true;
+}
+
+void execution_system::notify_peer(worker_thread_data& worker) noexcept {
+  // wake up one sleeping peer to steal the task, peers are woken in turn
+  const auto num_peers = worker.peers.size();
+  for (std::size_t i = 0; i < num_peers; i++) {
+    const auto index = (worker.wake_cursor + i) % num_peers;
+    if (worker.peers[index]->notifier.notify()) {
+      worker.wake_cursor = index + 1;
+      worker.stats.num_wakeups.fetch_add(1, std::memory_order::relaxed);
+      break;
+    }
+  }
+}
+
+bool execution_system::steal_and_execute(worker_thread_data& data, bool& is_searching) {
+  const auto num_peers = data.peers.size();
+
+  task_function func;
+  for (std::size_t i = 0; i < num_peers; i++) {
+    const auto index = (data.steal_cursor + i) % num_peers;
+    auto& peer = *data.peers[index];
+    if (peer.local_tasks && peer.local_tasks->try_steal(func)) {
+      data.steal_cursor = index + 1;
+      on_task_found(data, is_searching);
+      func(data.data);
+      return true;
+    }
+  }
+
+  // LIFO slots are checked last as their owners are likely to execute them soon
+  slot_task slot_func;
+  for (std::size_t i = 0; i < num_peers; i++) {
+    const auto index = (data.steal_cursor + i) % num_peers;
+    if (data.peers[index]->next_task.try_take(slot_func)) {
+      data.steal_cursor = index + 1;
+      on_task_found(data, is_searching);
+      slot_func.func(data.data);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::chrono::steady_clock::time_point execution_system::on_periodic_tick(delayed_task& task, std::chrono::steady_clock::time_point now,
+                                                                        std::pmr::vector<delayed_task>& expired) {
+  auto& periodic = *task.periodic;
+
+  // executions never overlap: the tick is merged to the pending execution or is added to the count of pending ticks
+  bool need_plan = false;
+  if (periodic.policy == missed_tick_policy::burst) {
+    need_plan = periodic.num_pending.fetch_add(1, std::memory_order::acq_rel) == 0;
+  } else {
+    std::uint32_t expected = 0;
+    need_plan = periodic.num_pending.compare_exchange_strong(expected, 1, std::memory_order::acq_rel, std::memory_order::relaxed);
+  }
+
+  if (need_plan) {
+    expired.emplace_back(task_function{[periodic = task.periodic](const executor_data& data) {
+                           run_periodic_task(*periodic, data);
+                         }},
+                         task.queue);
+  }
+
+  // time points are counted from the first one so the schedule doesn't drift
+  auto next_time = periodic.first_time + (periodic.period * periodic.next_tick);
+  if (periodic.policy == missed_tick_policy::skip && next_time <= now) {
+    periodic.next_tick = ((now - periodic.first_time) / periodic.period) + 1;
+    next_time = periodic.first_time + (periodic.period * periodic.next_tick);
+  }
+  periodic.next_tick++;
+
+  return next_time;
+}
+
+void execution_system::run_periodic_task(periodic_task& task, const executor_data& data) {
+  do {
+    if (!task.is_cancelled.load(std::memory_order::relaxed)) {
+      task.func(data);
+    }
+  } while (task.num_pending.fetch_sub(1, std::memory_order::acq_rel) != 1);
+}
+
+std::uint32_t execution_system::select_timer_owner(execution_queue_mark execution_queue) noexcept {
+  // timers planned from a worker stay on it, so it doesn't need to be woken up
+  if (auto* worker = get_current_worker(); worker != nullptr && worker->timers && worker->mask.allowed(execution_queue)) {
+    return static_cast<std::uint32_t>(worker - _thread_data.get());
+  }
+
+  const auto cursor = _timer_owner_cursor.fetch_add(1, std::memory_order::relaxed);
+
+  // workers of groups don't own timers
+  const auto& workers = _tasks_queues[execution_queue.get_value()].workers_data;
+  for (std::size_t i = 0; i < workers.size(); i++) {
+    if (const auto* worker = workers[(cursor + i) % workers.size()]; worker->timers) {
+      return static_cast<std::uint32_t>(worker - _thread_data.get());
+    }
+  }
+
+  // queue has no workers, any worker will push the task to the queue
+  return _timer_workers[cursor % _timer_workers.size()];
+}
+
+bool execution_system::run_expired_timers(worker_thread_data& data, bool& is_searching) {
+  auto& timers = *data.timers;
+
+  const auto deadline = timers.deadline.load(std::memory_order::relaxed);
+  if (deadline == worker_timers::no_deadline) {
+    return false;
+  }
+
+  // worker refreshes cached time right before this check
+  auto now = runtime_clock::now();
+  if (now.time_since_epoch().count() < deadline) {
+    // coarse time can be behind the real time up to its resolution. Precise time is read near the deadline
+    // so the worker doesn't spin waiting for the coarse clock after its sleep is over
+    if (_clock_mode != clock_mode::coarse || deadline - now.time_since_epoch().count() > runtime_clock::coarse_resolution().count()) {
+      return false;
+    }
+
+    now = runtime_clock::read(clock_mode::precise);
+    if (now.time_since_epoch().count() < deadline) {
+      return false;
+    }
+  }
+
+  {
+    unique_lock lock(timers.mutex);
+
+    timers.tasks.advance(
+        now,
+        [&timers](delayed_task&& task) {
+          timers.expired.push_back(std::move(task));
+        },
+        [&timers, now](delayed_task& task) {
+          return std::optional{on_periodic_tick(task, now, timers.expired)};
+        });
+
+    const auto next_deadline = timers.tasks.next_deadline();
+    timers.deadline.store(next_deadline ? next_deadline->time_since_epoch().count() : worker_timers::no_deadline, std::memory_order::relaxed);
+  }
+
+  if (timers.expired.empty()) {
+    // timers were only moved to lower levels of the wheel
+    return false;
+  }
+
+  for (auto& task : timers.expired) {
+    ASYNC_CORO_ASSERT(task.func);
+    if (data.mask.allowed(task.queue)) {
+      on_task_found(data, is_searching);
+      task.func(data.data);
+    } else {
+      plan_shared(std::move(task.func), task.queue);
+    }
+  }
+  timers.expired.clear();
+
+  return true;
+}
+
+void execution_system::sleep_worker(worker_thread_data& data, std::chrono::steady_clock::time_point& spin_start) noexcept {
+  const auto sleep_start = runtime_clock::read(clock_mode::precise);
+  add_duration(data.spin_time, sleep_start - spin_start);
+
+  // stale notification time could be left by notifications that didn't wake this worker
+  (void)data.notifier.take_notify_time();
+
+  bool is_sleep_until = false;
+  if (data.timers) {
+    const auto deadline = data.timers->deadline.load(std::memory_order::relaxed);
+    if (deadline != worker_timers::no_deadline) {
+      // timed sleep is woken by planning threads without locks, the same way as plain sleep
+      data.notifier.sleep_until(std::chrono::steady_clock::time_point{std::chrono::steady_clock::duration{deadline}});
+      is_sleep_until = true;
+    }
+  }
+
+  if (!is_sleep_until) {
+    if (data.group != nullptr) {
+      data.parked_since.store(sleep_start.time_since_epoch().count(), std::memory_order::relaxed);
+    }
+
+    data.notifier.sleep();
+
+    if (data.group != nullptr) {
+      data.parked_since.store(0, std::memory_order::relaxed);
+    }
+  }
+
+  spin_start = runtime_clock::read(clock_mode::precise);
+  add_duration(data.park_time, spin_start - sleep_start);
+  data.num_parks.store(data.num_parks.load(std::memory_order::relaxed) + 1, std::memory_order::relaxed);
+
+  if (const auto notify_time = data.notifier.take_notify_time(); notify_time > sleep_start && notify_time <= spin_start) {
+    data.spin.on_wake_latency(spin_start - notify_time);
+  }
+}
+
+bool execution_system::should_park(worker_thread_data& data, std::size_t num_empty_loops, std::chrono::steady_clock::time_point spin_start) noexcept {
+  if (data.idle_policy == worker_idle_policy::adaptive) {
+    return runtime_clock::read(clock_mode::precise) - spin_start >= data.spin.get_budget();
+  }
+  return num_empty_loops > data.num_loops_before_sleep;
+}
+
+void execution_system::end_idle(worker_thread_data& data, std::chrono::steady_clock::time_point idle_start,
+                                std::chrono::steady_clock::time_point spin_start) noexcept {
+  const auto now = runtime_clock::read(clock_mode::precise);
+  add_duration(data.spin_time, now - spin_start);
+
+  if (data.idle_policy == worker_idle_policy::adaptive) {
+    data.spin.on_idle_end(now - idle_start);
+    data.spin_budget.store(std::chrono::nanoseconds{data.spin.get_budget()}.count(), std::memory_order::relaxed);
+  }
+}
+
+std::uint32_t execution_system::get_num_running_workers() const noexcept {
+  std::uint32_t num_running = 0;
+  for (std::uint32_t i = 0; i < _num_workers; i++) {
+    if (_thread_data[i].is_running.load(std::memory_order::relaxed)) {
+      num_running++;
+    }
+  }
+  return num_running;
+}
+
+execution_worker_stats execution_system::get_worker_stats(std::uint32_t worker_index) const noexcept {
+  ASYNC_CORO_ASSERT(worker_index < _num_workers);
+
+  const auto& data = _thread_data[worker_index];
+  return {
+      .spin_time = std::chrono::nanoseconds{data.spin_time.load(std::memory_order::relaxed)},
+      .park_time = std::chrono::nanoseconds{data.park_time.load(std::memory_order::relaxed)},
+      .num_parks = data.num_parks.load(std::memory_order::relaxed),
+      .spin_budget = std::chrono::nanoseconds{data.spin_budget.load(std::memory_order::relaxed)},
+  };
+}
+
+std::size_t execution_system::get_num_allocated_banks(execution_queue_mark execution_queue) const noexcept {
+  ASYNC_CORO_ASSERT(execution_queue.get_value() <= _max_q.get_value());
+
+  return _tasks_queues[execution_queue.get_value()].queue.get_num_banks();
+}
+
+void execution_system::shrink_to_fit() noexcept {
+  for (std::uint32_t q_id = 0; q_id <= _max_q.get_value(); q_id++) {
+    _tasks_queues[q_id].queue.shrink_to_fit();
+  }
+}
+
 void execution_system::worker_loop(worker_thread_data& data) {
   std::size_t num_empty_loops = 0;
+  bool is_searching = false;
+
+  // Start of the current idle period and of its part after the last sleep. Zero if the worker isn't idle
+  std::chrono::steady_clock::time_point idle_start;
+  std::chrono::steady_clock::time_point spin_start;
+
+  task_function local_func;
+  slot_task slot_func;
 
   while (!_is_stopping.load(std::memory_order::relaxed)) {
     data.notifier.reset_notification();
 
-    task_function func;
+    if (_clock_mode != clock_mode::precise) {
+      runtime_clock::refresh(_clock_mode);
+    }
+
     bool is_empty_loop = true;
-    for (auto* task_q : data.task_queues) {
-      if (task_q->try_pop(func)) {
+
+    if (data.timers && run_expired_timers(data, is_searching)) {
+      is_empty_loop = false;
+    }
+
+    if (_is_lifo_slot) {
+      // continuations planned by the previous task are executed first while their data is still in cache.
+      // Number of such tasks in a row is limited so ping-pong tasks can't starve the queues
+      for (std::uint32_t num_hits = 0; num_hits < _max_lifo_slot_hits && data.next_task.try_take(slot_func); num_hits++) {
+        on_task_found(data, is_searching);
+        slot_func.func(data.data);
+        slot_func.func = nullptr;
+        is_empty_loop = false;
+      }
+    }
+
+    // the latest local task is executed first while its data is still in cache
+    if (data.local_tasks && data.local_tasks->try_pop(local_func)) {
+      on_task_found(data, is_searching);
+      local_func(data.data);
+      local_func = nullptr;
+      is_empty_loop = false;
+    }
+
+    // every queue gets up to its weight of tasks per round, so busy queues share the worker in proportion to weights
+    for (std::size_t i = 0; i < data.task_queues.size(); i++) {
+      auto* task_q = data.task_queues[i];
+      const auto weight = data.served_queues[i]->weight;
+
+      std::uint32_t num_served = 0;
+      // task is invoked right from the queue node to avoid extra moves of task_function
+      while (num_served < weight && task_q->try_consume([this, &data, &is_searching](task_function& func) {
+               on_task_found(data, is_searching);
+               func(data.data);
+             })) {
+        num_served++;
+
+        if (_is_stopping.load(std::memory_order::relaxed)) [[unlikely]] {
+          break;
+        }
+      }
+
+      if (num_served != 0) {
         is_empty_loop = false;
-        func(data.data);
-        func = nullptr;
+
+        auto& counter = data.num_served[i];
+        counter.store(counter.load(std::memory_order::relaxed) + num_served, std::memory_order::relaxed);
 
         if (_is_stopping.load(std::memory_order::relaxed)) [[unlikely]] {
           break;
@@ -273,60 +1172,309 @@ void execution_system::worker_loop(worker_thread_data& data) {
       }
     }
 
-    if (is_empty_loop && ++num_empty_loops > data.num_loops_before_sleep) {
-      if (_is_stopping.load(std::memory_order::relaxed)) [[unlikely]] {
-        break;
+    if (is_empty_loop && !data.peers.empty()) {
+      is_empty_loop = !steal_and_execute(data, is_searching);
+    }
+
+    if (!is_empty_loop) {
+
+      if (idle_start != std::chrono::steady_clock::time_point{}) {
+        end_idle(data, idle_start, spin_start);
+        idle_start = {};
+        num_empty_loops = 0;
       }
-      data.notifier.sleep();
-      num_empty_loops = 0;
+      continue;
+    }
+
+    if (idle_start == std::chrono::steady_clock::time_point{}) {
+      idle_start = runtime_clock::read(clock_mode::precise);
+      spin_start = idle_start;
+      data.spin.reset_backoff();
+    }
+
+    if (!should_park(data, ++num_empty_loops, spin_start)) {
+      if (!is_searching) {
+        // empty loops before sleep are spent searching for tasks
+        is_searching = true;
+        begin_searching(data);
+      }
+
+      if (data.idle_policy == worker_idle_policy::adaptive) {
+        data.spin.backoff();
+      }
+      continue;
     }
+
+    if (is_searching) {
+      // planning threads could skip wakeups while this worker was searching, so queues are checked once more
+      is_searching = false;
+      end_searching(data, false);
+      continue;
+    }
+
+    if (_is_stopping.load(std::memory_order::relaxed)) [[unlikely]] {
+      break;
+    }
+    sleep_worker(data, spin_start);
+    data.spin.reset_backoff();
+    num_empty_loops = 0;
+
+    if (data.retire_requested.load(std::memory_order::relaxed) && try_retire(data)) {
+      break;
+    }
+
+    // woken worker searches until it finds a task. Wakeups skipped while it searches are passed on
+    // by end_searching, so a burst of single task plans wakes workers one after another
+    is_searching = true;
+    begin_searching(data);
   }
 }
 
 void execution_system::timer_loop() {
+  if (_high_res_timer) {
+    internal::high_resolution_timer::prepare_waiting_thread();
+  }
+
   unique_lock lock(_delayed_mutex);
   while (!_is_stopping.load(std::memory_order::relaxed)) {
-    if (_delayed_tasks.empty()) {
+    // timer thread wakes up only on deadlines so it reads precise time to avoid extra wakeups
+    const auto now = runtime_clock::read(clock_mode::precise);
+    _delayed_tasks.advance(
+        now,
+        [this](delayed_task&& task) {
+          _expired_tasks.push_back(std::move(task));
+        },
+        [this, now](delayed_task& task) {
+          return std::optional{on_periodic_tick(task, now, _expired_tasks)};
+        });
+
+    if (!_expired_tasks.empty()) {
+      lock.unlock();
+
+      // tasks of one queue are pushed at once, keeping order of their time points
+      for (std::uint32_t q_id = 0; q_id <= _max_q.get_value(); q_id++) {
+        const execution_queue_mark queue{static_cast<std::uint8_t>(q_id)};
+        for (auto& task : _expired_tasks) {
+          if (task.queue == queue) {
+            ASYNC_CORO_ASSERT(task.func);
+            _expired_funcs.push_back(std::move(task.func));
+          }
+        }
+
+        if (!_expired_funcs.empty()) {
+          plan_execution_bulk(_expired_funcs, queue);
+          _expired_funcs.clear();
+        }
+      }
+      _expired_tasks.clear();
+
+      lock.lock();
+      continue;
+    }
+
+    const auto next_deadline = _delayed_tasks.next_deadline();
+
+    if (_high_res_timer) {
+      set_timer_wakeup(next_deadline.value_or(std::chrono::steady_clock::time_point::max()));
+      const auto time = _timer_wakeup;
+
+      // timer is armed under the lock so planning threads can only move it earlier
+      _high_res_timer->set_deadline(time == std::chrono::steady_clock::time_point::max() ? time : time - _timer_spin);
+
+      lock.unlock();
+      wait_high_resolution(time);
+      lock.lock();
+      continue;
+    }
+
+    if (!next_deadline) {
+      set_timer_wakeup(std::chrono::steady_clock::time_point::max());
       _delayed_cv.wait(lock);
       continue;
     }
 
-    {
-      auto now = std::chrono::steady_clock::now();
-      auto& top = _delayed_tasks.front();
-      if (!top.cancel_execution && top.when > now) {
-        const auto time = top.when;  // top may be freed and wait_until may do checks with this variable on spurious wakeup
-        _delayed_cv.wait_until(lock, time);
-        continue;
+    // deadline is copied as planning threads may change _timer_wakeup while we wait
+    set_timer_wakeup(*next_deadline);
+    const auto time = _timer_wakeup;
+    _delayed_cv.wait_until(lock, time);
+  }
+}
+
+void execution_system::set_timer_wakeup(std::chrono::steady_clock::time_point time) noexcept {
+  _timer_wakeup = time;
+  _spin_wakeup.store(time.time_since_epoch().count(), std::memory_order::relaxed);
+}
+
+void execution_system::wait_high_resolution(std::chrono::steady_clock::time_point time) {
+  // the end of the wait is spun so the wakeup doesn't depend on kernel latency
+  if (time != std::chrono::steady_clock::time_point::max() && time - runtime_clock::read(clock_mode::precise) <= _timer_spin) {
+    // planning threads can move the wakeup earlier while we spin, they don't re-arm the spin
+    const auto spin_end = [this, time] {
+      return std::min(time, std::chrono::steady_clock::time_point{std::chrono::steady_clock::duration{_spin_wakeup.load(std::memory_order::relaxed)}});
+    };
+    while (runtime_clock::read(clock_mode::precise) < spin_end() && !_is_stopping.load(std::memory_order::relaxed)) {
+      internal::cpu_relax();
+    }
+    return;
+  }
+
+  _high_res_timer->wait();
+}
+
+void execution_system::nudge_groups() noexcept {
+  // flag is read first so busy systems don't write to its cache line
+  if (!_groups_nudged.load(std::memory_order::relaxed) && !_groups_nudged.exchange(true, std::memory_order::relaxed)) {
+    _groups_notifier.notify();
+  }
+}
+
+bool execution_system::has_groups_backlog() const noexcept {
+  for (std::uint32_t group_index = 0; group_index < _num_worker_groups; group_index++) {
+    const auto& group = _worker_groups[group_index];
+    if (group.num_active.load(std::memory_order::relaxed) < group.max_workers &&
+        std::ranges::any_of(group.workers.front()->task_queues, [](const tasks* task_q) { return task_q->has_value(); })) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void execution_system::start_group_worker(worker_group& group) {
+  for (auto* worker : group.workers) {
+    // slot is free when its previous thread cleared the flag at exit
+    if (!worker->is_running.load(std::memory_order::acquire)) {
+      if (worker->thread.joinable()) {
+        worker->thread.join();
       }
+
+      worker->retire_requested.store(false, std::memory_order::relaxed);
+      group.num_active.fetch_add(1, std::memory_order::relaxed);
+      start_worker(*worker, nullptr);
+      return;
     }
+  }
+  // retired threads didn't exit yet, next poll will try again
+}
 
-    std::ranges::pop_heap(_delayed_tasks, std::greater<delayed_task>{});
+std::chrono::steady_clock::time_point execution_system::retire_idle_workers(worker_group& group, std::chrono::steady_clock::time_point now) noexcept {
+  auto next_check = std::chrono::steady_clock::time_point::max();
+  auto num_to_retire = group.num_active.load(std::memory_order::relaxed) - group.min_workers;
 
-    if (_delayed_tasks.back().cancel_execution) {
-      _delayed_tasks.pop_back();
+  for (auto* worker : group.workers) {
+    if (num_to_retire == 0) {
+      break;
+    }
+
+    if (!worker->is_running.load(std::memory_order::relaxed) || worker->retire_requested.load(std::memory_order::relaxed)) {
       continue;
     }
 
-    auto& target_task_q = _tasks_queues[_delayed_tasks.back().queue.get_value()];
-    task_function func{std::move(_delayed_tasks.back().func)};
+    const auto parked_since = worker->parked_since.load(std::memory_order::relaxed);
+    if (parked_since == 0) {
+      // running worker can park right after this check
+      next_check = std::min(next_check, now + group.idle_timeout);
+      continue;
+    }
 
-    _delayed_tasks.pop_back();
+    const auto deadline = std::chrono::steady_clock::time_point{std::chrono::steady_clock::duration{parked_since}} + group.idle_timeout;
+    if (deadline > now) {
+      next_check = std::min(next_check, deadline);
+      continue;
+    }
 
-    lock.unlock();
+    // worker decides itself as tasks could be planned right before the request
+    worker->retire_requested.store(true, std::memory_order::relaxed);
+    worker->notifier.notify();
+    num_to_retire--;
+  }
+
+  return next_check;
+}
 
-    ASYNC_CORO_ASSERT(func);
+bool execution_system::try_retire(worker_thread_data& data) noexcept {
+  ASYNC_CORO_ASSERT(data.group != nullptr);
 
-    target_task_q.queue.push(std::move(func));
+  data.retire_requested.store(false, std::memory_order::relaxed);
 
-    for (auto* worker : target_task_q.workers_data) {
-      if (worker->notifier.notify()) {
-        // leave others in sleeping state
-        break;
+  // tasks planned before the wakeup are visible after reset of the notifier. Tasks planned later don't count on this worker,
+  // as its notifier isn't sleeping
+  if (std::ranges::any_of(data.task_queues, [](const tasks* task_q) { return task_q->has_value(); })) {
+    return false;
+  }
+
+  auto& group = *data.group;
+  auto num_active = group.num_active.load(std::memory_order::relaxed);
+  do {
+    if (num_active <= group.min_workers) {
+      return false;
+    }
+  } while (!group.num_active.compare_exchange_weak(num_active, num_active - 1, std::memory_order::relaxed));
+
+  // group can start threads again, so planning threads should wake up the groups thread
+  _groups_nudged.store(false, std::memory_order::relaxed);
+  return true;
+}
+
+void execution_system::groups_loop() {
+  bool is_nudged = false;
+
+  while (!_is_stopping.load(std::memory_order::relaxed)) {
+    _groups_notifier.reset_notification();
+
+    const auto now = runtime_clock::read(clock_mode::precise);
+    auto next_check = std::chrono::steady_clock::time_point::max();
+    bool has_capacity = false;
+    bool has_backlog = false;
+    bool is_waiting_nudge = false;
+
+    for (std::uint32_t group_index = 0; group_index < _num_worker_groups; group_index++) {
+      auto& group = _worker_groups[group_index];
+      const auto num_active = group.num_active.load(std::memory_order::relaxed);
+
+      if (num_active > group.min_workers) {
+        next_check = std::min(next_check, retire_idle_workers(group, now));
+      }
+
+      if (num_active >= group.max_workers ||
+          std::ranges::none_of(group.workers.front()->task_queues, [](const tasks* task_q) { return task_q->has_value(); })) {
+        has_capacity |= num_active < group.max_workers;
+        group.backlog_since = {};
+        continue;
+      }
+
+      has_capacity = true;
+      has_backlog = true;
+
+      if (num_active == 0 || (group.backlog_since != std::chrono::steady_clock::time_point{} && now - group.backlog_since >= group.spawn_delay)) {
+        // tasks waited for a free worker too long. The next thread needs one more delay
+        start_group_worker(group);
+        group.backlog_since = now;
+      } else if (group.backlog_since == std::chrono::steady_clock::time_point{}) {
+        group.backlog_since = now;
       }
     }
 
-    lock.lock();
+    if (has_backlog || std::exchange(is_nudged, false)) {
+      // queues are polled while tasks wait. Nudged thread polls for one more interval so planning threads can't wake it up on every task
+      next_check = std::min(next_check, now + _groups_poll_interval);
+    } else if (has_capacity) {
+      _groups_nudged.store(false, std::memory_order::relaxed);
+
+      // pairs with the fence in notify_workers: either the planning thread sees reset flag or we see its task
+      std::atomic_thread_fence(std::memory_order::seq_cst);
+      if (has_groups_backlog()) {
+        continue;
+      }
+      is_waiting_nudge = true;
+    }
+
+    if (next_check == std::chrono::steady_clock::time_point::max()) {
+      _groups_notifier.sleep();
+    } else {
+      _groups_notifier.sleep_until(next_check);
+    }
+
+    is_nudged = is_waiting_nudge && _groups_nudged.load(std::memory_order::relaxed);
   }
 }
 
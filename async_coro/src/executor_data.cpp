@@ -2,8 +2,9 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
-#include <thread>
 #include <typeindex>
 #include <unordered_map>
 
@@ -35,12 +36,26 @@ uint32_t get_key_for_type(std::type_index type) {
 namespace async_coro {
 
 executor_data::executor_data() noexcept
-    : _owning_thread(std::this_thread::get_id()) {
+    : executor_data(std::pmr::get_default_resource()) {
+}
+
+executor_data::executor_data(std::pmr::memory_resource* resource) noexcept
+    : _owning_thread(thread_index::current()),
+      _data(resource) {
 }
 
 executor_data::executor_data(executor_data&&) noexcept = default;
 executor_data::~executor_data() noexcept = default;
-executor_data& executor_data::operator=(executor_data&&) noexcept = default;
+
+executor_data& executor_data::operator=(executor_data&& other) noexcept {
+  if (this != &other) {
+    _owning_thread = other._owning_thread;
+    // pmr containers don't propagate allocator on assignment, so rebuild storage to take over the resource of other
+    std::destroy_at(&_data);
+    std::construct_at(&_data, std::move(other._data));
+  }
+  return *this;
+}
 
 void* executor_data::find_data(data_key key, creator_func_t creator) const {
   constexpr size_t use_bin_search_after = 32;
@@ -53,7 +68,7 @@ void* executor_data::find_data(data_key key, creator_func_t creator) const {
     });
 
     if (pos == _data.end() || pos->key != key) {
-      pos = _data.emplace(pos, store{.key = key, .data = creator()});
+      pos = _data.emplace(pos, store{.key = key, .data = creator(_data.get_allocator().resource())});
     }
     result = pos->data.get();
   } else {
@@ -62,7 +77,7 @@ void* executor_data::find_data(data_key key, creator_func_t creator) const {
     });
 
     if (pos == _data.end()) {
-      _data.emplace_back(store{.key = key, .data = creator()});
+      _data.emplace_back(store{.key = key, .data = creator(_data.get_allocator().resource())});
       result = _data.back().data.get();
       if (_data.size() > use_bin_search_after) {
         std::ranges::sort(_data, [](const store& left, const store& right) noexcept { return left.key < right.key; });
@@ -0,0 +1,85 @@
+#include <async_coro/internal/high_resolution_timer.h>
+
+#if defined(__linux__)
+
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+
+#endif
+
+namespace async_coro::internal {
+
+#if defined(__linux__)
+
+namespace {
+
+void arm(int timer_fd, std::chrono::nanoseconds time) noexcept {
+  // zero it_value disarms timer, so time points at or before the clock origin are moved to 1ns
+  const auto nanoseconds = std::max<std::int64_t>(time.count(), 1);
+
+  itimerspec spec{};
+  spec.it_value.tv_sec = static_cast<time_t>(nanoseconds / 1000000000);    // NOLINT(*-magic-*)
+  spec.it_value.tv_nsec = static_cast<long>(nanoseconds % 1000000000);     // NOLINT(*-magic-*, *-runtime-int)
+  ::timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+}  // namespace
+
+high_resolution_timer::high_resolution_timer() noexcept
+    // steady_clock uses CLOCK_MONOTONIC, so deadlines are passed to the kernel as is
+    : _fd(::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC)) {}
+
+high_resolution_timer::~high_resolution_timer() noexcept {
+  if (_fd >= 0) {
+    ::close(_fd);
+  }
+}
+
+void high_resolution_timer::set_deadline(clock::time_point time) noexcept {
+  if (time == clock::time_point::max()) {
+    const itimerspec spec{};
+    ::timerfd_settime(_fd, TFD_TIMER_ABSTIME, &spec, nullptr);
+    return;
+  }
+
+  arm(_fd, std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()));
+}
+
+void high_resolution_timer::wake() noexcept {
+  // deadline in the past expires right away
+  arm(_fd, std::chrono::nanoseconds{1});
+}
+
+void high_resolution_timer::wait() noexcept {
+  std::uint64_t num_expirations = 0;
+  while (::read(_fd, &num_expirations, sizeof(num_expirations)) < 0 && errno == EINTR) {
+  }
+}
+
+void high_resolution_timer::prepare_waiting_thread() noexcept {
+  // default slack of 50us is added to every timer wakeup of normal threads
+  ::prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+}
+
+#else
+
+high_resolution_timer::high_resolution_timer() noexcept = default;
+
+high_resolution_timer::~high_resolution_timer() noexcept = default;
+
+void high_resolution_timer::set_deadline(clock::time_point /*time*/) noexcept {}
+
+void high_resolution_timer::wake() noexcept {}
+
+void high_resolution_timer::wait() noexcept {}
+
+void high_resolution_timer::prepare_waiting_thread() noexcept {}
+
+#endif
+
+}  // namespace async_coro::internal
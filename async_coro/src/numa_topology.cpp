@@ -0,0 +1,160 @@
+#include <async_coro/numa_topology.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace async_coro {
+
+namespace {
+
+thread_local std::uint32_t current_thread_node = numa_topology::no_node;
+
+std::vector<numa_node> make_single_node() {
+  numa_node node;
+  const auto num_cpus = std::max(1U, std::thread::hardware_concurrency());
+  for (std::uint32_t cpu = 0; cpu < num_cpus; cpu++) {
+    node.cpus.push_back(cpu);
+  }
+
+  std::vector<numa_node> nodes;
+  nodes.push_back(std::move(node));
+  return nodes;
+}
+
+bool parse_number(std::string_view str, std::uint32_t& value) noexcept {
+  const auto* const end = str.data() + str.size();
+  const auto [ptr, error] = std::from_chars(str.data(), end, value);
+  return error == std::errc{} && ptr == end;
+}
+
+}  // namespace
+
+numa_topology::numa_topology()
+    : numa_topology(std::vector<numa_node>{}) {}
+
+numa_topology::numa_topology(std::vector<numa_node> nodes)
+    : _nodes(nodes.empty() ? make_single_node() : std::move(nodes)) {
+  for (std::uint32_t index = 0; index < _nodes.size(); index++) {
+    auto& cpus = _nodes[index].cpus;
+    std::ranges::sort(cpus);
+
+    for (const auto cpu : cpus) {
+      if (cpu >= _cpu_nodes.size()) {
+        _cpu_nodes.resize(cpu + 1, 0);
+      }
+      _cpu_nodes[cpu] = index;
+    }
+  }
+}
+
+numa_topology numa_topology::discover() {
+#if defined(__linux__)
+  return read_from("/sys/devices/system/node");
+#else
+  return numa_topology{};
+#endif
+}
+
+numa_topology numa_topology::read_from(const std::string& node_directory) {
+  constexpr std::string_view node_prefix = "node";
+
+  std::vector<numa_node> nodes;
+
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator{node_directory, error}) {
+    const auto name = entry.path().filename().string();
+
+    numa_node node;
+    if (!name.starts_with(node_prefix) || !parse_number(std::string_view{name}.substr(node_prefix.size()), node.id)) {
+      continue;
+    }
+
+    std::ifstream file{entry.path() / "cpulist"};
+    std::string list;
+    if (!std::getline(file, list) || !parse_cpu_list(list, node.cpus) || node.cpus.empty()) {
+      // memory only nodes have no CPUs to run workers on
+      continue;
+    }
+
+    nodes.push_back(std::move(node));
+  }
+
+  std::ranges::sort(nodes, {}, &numa_node::id);
+  return numa_topology{std::move(nodes)};
+}
+
+bool numa_topology::parse_cpu_list(std::string_view list, std::vector<std::uint32_t>& cpus) {
+  cpus.clear();
+
+  while (!list.empty() && (list.back() == '\n' || list.back() == ' ')) {
+    list.remove_suffix(1);
+  }
+
+  while (!list.empty()) {
+    const auto comma = list.find(',');
+    const auto range = list.substr(0, comma);
+    list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+    std::uint32_t first = 0;
+    std::uint32_t last = 0;
+    if (const auto dash = range.find('-'); dash != std::string_view::npos) {
+      if (!parse_number(range.substr(0, dash), first) || !parse_number(range.substr(dash + 1), last) || last < first || last >= max_cpus) {
+        return false;
+      }
+    } else if (parse_number(range, first) && first < max_cpus) {
+      last = first;
+    } else {
+      return false;
+    }
+
+    // last is below max_cpus, so the counter can't wrap
+    for (auto cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return true;
+}
+
+std::uint32_t numa_topology::get_node_of_cpu(std::uint32_t cpu) const noexcept {
+  return cpu < _cpu_nodes.size() ? _cpu_nodes[cpu] : 0;
+}
+
+std::uint32_t numa_topology::get_current_node() const noexcept {
+  if (current_thread_node < _nodes.size()) {
+    return current_thread_node;
+  }
+  return get_node_of_cpu(get_current_cpu());
+}
+
+void numa_topology::set_current_thread_node(std::uint32_t node_index) noexcept {
+  current_thread_node = node_index;
+}
+
+std::uint32_t numa_topology::get_current_thread_node() noexcept {
+  return current_thread_node;
+}
+
+std::uint32_t numa_topology::get_current_cpu() noexcept {
+#if defined(__linux__)
+  // getcpu is served by vDSO, so it is cheap enough for every push
+  const auto cpu = ::sched_getcpu();
+  return cpu >= 0 ? static_cast<std::uint32_t>(cpu) : 0;
+#else
+  return 0;
+#endif
+}
+
+}  // namespace async_coro
@@ -0,0 +1,77 @@
+#include <async_coro/runtime_clock.h>
+
+#if defined(__linux__)
+
+#include <time.h>  // NOLINT(*-deprecated-headers)
+
+#endif
+
+namespace async_coro {
+
+namespace {
+
+// Zero time point means that cache is turned off
+thread_local runtime_clock::clock::time_point cached_now{};
+
+#if defined(CLOCK_MONOTONIC_COARSE)
+
+runtime_clock::clock::time_point read_coarse() noexcept {
+  // coarse clock has the same origin as CLOCK_MONOTONIC that is used by steady_clock
+  timespec time{};
+  ::clock_gettime(CLOCK_MONOTONIC_COARSE, &time);
+  return runtime_clock::clock::time_point{std::chrono::duration_cast<runtime_clock::clock::duration>(
+      std::chrono::seconds{time.tv_sec} + std::chrono::nanoseconds{time.tv_nsec})};
+}
+
+runtime_clock::clock::duration get_coarse_resolution() noexcept {
+  timespec resolution{};
+  if (::clock_getres(CLOCK_MONOTONIC_COARSE, &resolution) != 0) {
+    return runtime_clock::clock::duration::zero();
+  }
+  return std::chrono::duration_cast<runtime_clock::clock::duration>(std::chrono::seconds{resolution.tv_sec} + std::chrono::nanoseconds{resolution.tv_nsec});
+}
+
+#else
+
+runtime_clock::clock::time_point read_coarse() noexcept {
+  return runtime_clock::clock::now();
+}
+
+runtime_clock::clock::duration get_coarse_resolution() noexcept {
+  return runtime_clock::clock::duration::zero();
+}
+
+#endif
+
+}  // namespace
+
+runtime_clock::clock::time_point runtime_clock::now() noexcept {
+  if (cached_now != clock::time_point{}) {
+    return cached_now;
+  }
+  return clock::now();
+}
+
+runtime_clock::clock::time_point runtime_clock::read(clock_mode mode) noexcept {
+  if (mode == clock_mode::coarse) {
+    return read_coarse();
+  }
+  return clock::now();
+}
+
+runtime_clock::clock::time_point runtime_clock::refresh(clock_mode mode) noexcept {
+  const auto time = read(mode);
+  cached_now = mode == clock_mode::precise ? clock::time_point{} : time;
+  return time;
+}
+
+void runtime_clock::reset() noexcept {
+  cached_now = clock::time_point{};
+}
+
+runtime_clock::clock::duration runtime_clock::coarse_resolution() noexcept {
+  static const auto resolution = get_coarse_resolution();
+  return resolution;
+}
+
+}  // namespace async_coro
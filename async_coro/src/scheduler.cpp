@@ -3,12 +3,12 @@
 #include <async_coro/execution_system.h>
 #include <async_coro/internal/scheduled_run_data.h>
 #include <async_coro/scheduler.h>
+#include <async_coro/thread_index.h>
 #include <async_coro/thread_safety/unique_lock.h>
 
 #include <algorithm>
 #include <atomic>
 #include <memory>
-#include <thread>
 #include <utility>
 
 namespace async_coro {
@@ -17,8 +17,10 @@ scheduler::scheduler()
     : scheduler(std::make_unique<execution_system>(execution_system_config{})) {
 }
 
-scheduler::scheduler(i_execution_system::ptr system) noexcept
-    : _execution_system(std::move(system)) {
+scheduler::scheduler(i_execution_system::ptr system, std::pmr::memory_resource* resource) noexcept
+    : _execution_system(std::move(system)),
+      _memory_resource(resource),
+      _managed_coroutines(resource) {
   ASYNC_CORO_ASSERT(_execution_system);
 }
 
@@ -35,11 +37,11 @@ scheduler::~scheduler() {
   coros.clear();
 }
 
-bool scheduler::is_thread_fits(execution_queue_mark execution_queue, std::thread::id thread_id) noexcept {
+bool scheduler::is_thread_fits(execution_queue_mark execution_queue, thread_index thread_id) noexcept {
   return _execution_system->is_thread_fits(execution_queue, thread_id);
 }
 
-void scheduler::continue_execution_impl(base_handle& handle, std::thread::id current_thread) {  // NOLINT(*complexity*)
+void scheduler::continue_execution_impl(base_handle& handle, thread_index current_thread) {  // NOLINT(*complexity*)
   base_handle* handle_to_run = std::addressof(handle);
 
   internal::scheduled_run_data run_data{};
@@ -174,18 +176,23 @@ base_handle_ptr scheduler::cleanup_coroutine(base_handle& handle_impl, bool canc
 void scheduler::plan_continue_on_thread(base_handle& handle_impl, execution_queue_mark execution_queue) {
   ASYNC_CORO_ASSERT(handle_impl._scheduler == this);
 
-  _execution_system->plan_execution(
-      [this, handle_base = &handle_impl, execution_queue](const executor_data& data) {
-        handle_base->_execution_queue = execution_queue;
-        this->continue_execution_impl(*handle_base, data.get_owning_thread());
-      },
-      execution_queue);
+  auto continue_func = [this, handle_base = &handle_impl, execution_queue](const executor_data& data) {
+    handle_base->_execution_queue = execution_queue;
+    this->continue_execution_impl(*handle_base, data.get_owning_thread());
+  };
+
+  // deadline queues resume coroutines with the earliest deadlines first. Continuations can't be dropped as their coroutines would hang
+  if (const task_deadline deadline{.value = handle_impl._deadline, .can_drop = false}; deadline.has_value()) {
+    _execution_system->plan_execution(std::move(continue_func), execution_queue, deadline);
+  } else {
+    _execution_system->plan_execution(std::move(continue_func), execution_queue);
+  }
 }
 
 void scheduler::add_coroutine(base_handle& handle_impl,
                               callback_base_ptr<false> start_function,
                               execution_queue_mark execution_queue) {
-  ASYNC_CORO_ASSERT(handle_impl._execution_thread.load(std::memory_order::relaxed) == std::thread::id{});
+  ASYNC_CORO_ASSERT(handle_impl._execution_thread.load(std::memory_order::relaxed) == thread_index{});
   ASYNC_CORO_ASSERT(handle_impl.get_coroutine_state() == coroutine_state::created);
 
   new (std::addressof(handle_impl._root_state)) base_handle::root_coro_state{.continuation{}, .start_function = std::move(start_function)};
@@ -205,7 +212,7 @@ void scheduler::add_coroutine(base_handle& handle_impl,
 
   handle_impl._scheduler = this;
 
-  const auto current_thread = std::this_thread::get_id();
+  const auto current_thread = thread_index::current();
 
   if (is_thread_fits(execution_queue, current_thread)) {
     // start execution immediately if we in right thread
@@ -226,8 +233,8 @@ void scheduler::set_unhandled_exception_handler(unique_function<void(std::except
 }
 #endif
 
-void scheduler::continue_execution(base_handle& handle_impl, std::thread::id current_thread, passkey_any<internal::coroutine_suspender, base_handle> /*key*/) {
-  ASYNC_CORO_ASSERT(handle_impl._execution_thread.load(std::memory_order::relaxed) != std::thread::id{});
+void scheduler::continue_execution(base_handle& handle_impl, thread_index current_thread, passkey_any<internal::coroutine_suspender, base_handle> /*key*/) {
+  ASYNC_CORO_ASSERT(handle_impl._execution_thread.load(std::memory_order::relaxed) != thread_index{});
   ASYNC_CORO_ASSERT(handle_impl.get_coroutine_state() == coroutine_state::suspended);
 
   if (handle_impl.is_execution_thread_same(current_thread)) {
@@ -240,7 +247,7 @@ void scheduler::continue_execution(base_handle& handle_impl, std::thread::id cur
 
 void scheduler::change_execution_queue(base_handle& handle_impl,
                                        execution_queue_mark execution_queue) {
-  ASYNC_CORO_ASSERT(!is_thread_fits(execution_queue, std::this_thread::get_id()));
+  ASYNC_CORO_ASSERT(!is_thread_fits(execution_queue, thread_index::current()));
 
   plan_continue_on_thread(handle_impl, execution_queue);
 }
@@ -248,7 +255,7 @@ void scheduler::change_execution_queue(base_handle& handle_impl,
 void scheduler::on_child_coro_added(base_handle& parent, base_handle& child, passkey<task_base> /*key*/) {
   ASYNC_CORO_ASSERT(parent.get_coroutine_state() == coroutine_state::running);
   ASYNC_CORO_ASSERT(parent._scheduler == this);
-  ASYNC_CORO_ASSERT(child._execution_thread == std::thread::id{});
+  ASYNC_CORO_ASSERT(child._execution_thread.load(std::memory_order::relaxed) == thread_index{});
   ASYNC_CORO_ASSERT(child.get_coroutine_state() == coroutine_state::created);
 
   parent.set_coroutine_state(coroutine_state::suspended);
@@ -256,6 +263,7 @@ void scheduler::on_child_coro_added(base_handle& parent, base_handle& child, pas
   child._scheduler = this;
   child._execution_thread.store(parent._execution_thread.load(std::memory_order::relaxed), std::memory_order::relaxed);
   child._execution_queue = parent._execution_queue;
+  child._deadline = parent._deadline;
   child.set_parent(parent);
   child.set_coroutine_state(coroutine_state::suspended);
 
@@ -0,0 +1,20 @@
+#include <async_coro/thread_index.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace async_coro {
+
+namespace {
+
+// Zero is reserved for the index that doesn't belong to any thread
+std::atomic_uint32_t next_index{1};
+
+}  // namespace
+
+thread_index thread_index::current() noexcept {
+  thread_local const thread_index index{next_index.fetch_add(1, std::memory_order::relaxed)};
+  return index;
+}
+
+}  // namespace async_coro
@@ -0,0 +1,62 @@
+#include <async_coro/thread_notifier.h>
+
+#if defined(__linux__)
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>  // NOLINT(*-deprecated-headers)
+#include <unistd.h>
+
+#include <cerrno>
+
+#else
+
+#include <async_coro/thread_safety/unique_lock.h>
+
+#endif
+
+namespace async_coro {
+
+#if defined(__linux__)
+
+void thread_notifier::wait_timed(std::chrono::steady_clock::time_point time) noexcept {
+  // FUTEX_WAIT_BITSET takes absolute CLOCK_MONOTONIC time that is the same clock as steady_clock
+  const auto since_epoch = time.time_since_epoch();
+  const auto secs = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+  const timespec abs_time{
+      .tv_sec = static_cast<time_t>(secs.count()),
+      .tv_nsec = static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - secs).count()),
+  };
+  auto* const word = reinterpret_cast<uint32_t*>(&_state);  // NOLINT(*-reinterpret-cast)
+
+  while (_state.load(std::memory_order::relaxed) == state_sleeping_until) {
+    // kernel checks the word under its own lock, so notify that changed state before this call makes it return immediately
+    if (::syscall(SYS_futex, word, FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, state_sleeping_until, &abs_time, nullptr, FUTEX_BITSET_MATCH_ANY) != 0 &&
+        errno == ETIMEDOUT) {
+      return;
+    }
+  }
+}
+
+void thread_notifier::wake_timed() noexcept {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&_state), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1, nullptr, nullptr, 0);  // NOLINT(*-reinterpret-cast)
+}
+
+#else
+
+void thread_notifier::wait_timed(std::chrono::steady_clock::time_point time) noexcept {
+  unique_lock lock{_mutex};
+  _timed_cv.wait_until(lock, time, [this]() noexcept {
+    return _state.load(std::memory_order::relaxed) != state_sleeping_until;
+  });
+}
+
+void thread_notifier::wake_timed() noexcept {
+  // lock guarantees that sleeping thread either sees the new state or is already waiting on condition variable
+  { unique_lock lock{_mutex}; }
+  _timed_cv.notify_one();
+}
+
+#endif
+
+}  // namespace async_coro
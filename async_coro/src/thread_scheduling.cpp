@@ -0,0 +1,90 @@
+#include <async_coro/utils/thread_scheduling.h>
+
+#include <cerrno>
+
+#if defined(__linux__)
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#endif
+
+namespace async_coro {
+
+namespace {
+
+void add_error(std::vector<thread_scheduling_error>& errors, std::string_view thread_name, std::string_view setting, int error_code) {
+  errors.push_back({.thread_name = std::string{thread_name}, .setting = std::string{setting}, .error_code = error_code});
+}
+
+#if defined(__linux__)
+
+int to_native_policy(thread_sched_policy policy) noexcept {
+  switch (policy) {
+    case thread_sched_policy::batch:
+      return SCHED_BATCH;
+    case thread_sched_policy::idle:
+      return SCHED_IDLE;
+    case thread_sched_policy::fifo:
+      return SCHED_FIFO;
+    case thread_sched_policy::round_robin:
+      return SCHED_RR;
+    default:
+      return SCHED_OTHER;
+  }
+}
+
+int set_cpu_set(const std::vector<std::uint32_t>& cpus) noexcept {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const auto cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      return EINVAL;
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+  return ::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set);
+}
+
+#endif
+
+}  // namespace
+
+void apply_thread_scheduling(const thread_scheduling& scheduling, std::string_view thread_name, std::vector<thread_scheduling_error>& errors) {
+#if defined(__linux__)
+  if (!scheduling.cpu_set.empty()) {
+    if (const auto result = set_cpu_set(scheduling.cpu_set); result != 0) {
+      add_error(errors, thread_name, "cpu_set", result);
+    }
+  }
+
+  if (scheduling.policy != thread_sched_policy::inherit) {
+    sched_param param{};
+    param.sched_priority = scheduling.priority;
+    if (const auto result = ::pthread_setschedparam(::pthread_self(), to_native_policy(scheduling.policy), &param); result != 0) {
+      add_error(errors, thread_name, "policy", result);
+    }
+  }
+
+  // nice value is per thread on Linux, so it is set for the thread id rather than for the process
+  if (scheduling.nice_value) {
+    if (::setpriority(PRIO_PROCESS, static_cast<id_t>(::gettid()), *scheduling.nice_value) != 0) {
+      add_error(errors, thread_name, "nice_value", errno);
+    }
+  }
+#else
+  if (!scheduling.cpu_set.empty()) {
+    add_error(errors, thread_name, "cpu_set", ENOTSUP);
+  }
+  if (scheduling.policy != thread_sched_policy::inherit) {
+    add_error(errors, thread_name, "policy", ENOTSUP);
+  }
+  if (scheduling.nice_value) {
+    add_error(errors, thread_name, "nice_value", ENOTSUP);
+  }
+#endif
+}
+
+}  // namespace async_coro
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+namespace mem_hook {
+
+// Memory resource that counts live allocations and total number of allocations made through it
+class counting_resource : public std::pmr::memory_resource {
+ public:
+  std::atomic_int num_allocated = 0;    // NOLINT(*-non-private-*)
+  std::atomic_int num_allocations = 0;  // NOLINT(*-non-private-*)
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    num_allocated++;
+    num_allocations++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+    num_allocated--;
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+}  // namespace mem_hook
@@ -1,9 +1,15 @@
 #include <async_coro/atomic_queue.h>
+#include <async_coro/bounded_atomic_queue.h>
+#include <async_coro/sharded_atomic_queue.h>
+#include <async_coro/work_stealing_deque.h>
 #include <gtest/gtest.h>
 #include <utils/memory_hooks.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <iostream>
 #include <thread>
 #include <vector>
 
@@ -12,7 +18,11 @@
 class atomic_collections : public ::testing::TestWithParam<std::tuple<std::uint32_t, std::uint32_t>> {
 };
 
-TEST_P(atomic_collections, int_queue) {
+class atomic_collections_perf : public ::testing::TestWithParam<std::tuple<std::uint32_t, std::uint32_t>> {
+};
+
+template <class TQueue, class... TArgs>
+static void test_int_queue(std::uint32_t num_cons, std::uint32_t num_prods, TArgs... queue_args) {
   constexpr std::uint32_t num_values = 1000000;
 
   std::atomic_int sum = 0;
@@ -20,14 +30,11 @@ TEST_P(atomic_collections, int_queue) {
 
   const auto mem_before = mem_hook::num_allocated.load();
   {
-    async_coro::atomic_queue<int> q;
+    TQueue q{queue_args...};
 
     std::atomic_int num_pops = 0;
     std::atomic_int num_pushes = 0;
 
-    const auto num_cons = std::get<0>(GetParam());
-    const auto num_prods = std::get<1>(GetParam());
-
     ASSERT_GT(num_cons, 0);
     ASSERT_GT(num_prods, 0);
 
@@ -104,6 +111,476 @@ TEST_P(atomic_collections, int_queue) {
   EXPECT_EQ(sum.load(), sum_pushed.load());
 }
 
+TEST_P(atomic_collections, int_queue) {
+  test_int_queue<async_coro::atomic_queue<int>>(std::get<0>(GetParam()), std::get<1>(GetParam()));
+}
+
+TEST_P(atomic_collections, int_bounded_queue) {
+  test_int_queue<async_coro::bounded_atomic_queue<int>>(std::get<0>(GetParam()), std::get<1>(GetParam()), 16384U);
+}
+
+template <class TQueue>
+static void test_int_queue_bulk(std::uint32_t num_cons, std::uint32_t num_prods) {
+  constexpr std::uint32_t num_values_by_prod = 200000;
+  constexpr std::uint32_t push_batch = 13;
+  constexpr std::uint32_t pop_batch = 8;
+
+  std::atomic_int sum = 0;
+  std::atomic_int sum_pushed = 0;
+  std::atomic_int num_pops = 0;
+
+  const auto mem_before = mem_hook::num_allocated.load();
+  {
+    TQueue q;
+
+    std::atomic_bool stop = false;
+    std::vector<std::thread> consumers;
+    std::vector<std::thread> prods;
+
+    for (std::uint32_t i = 0; i < num_cons; i++) {
+      consumers.emplace_back([&]() {
+        std::array<int, pop_batch> values{};
+        while (!stop) {
+          const auto num = q.try_pop_bulk(values.begin(), values.size());
+          for (std::size_t j = 0; j < num; j++) {
+            sum += values[j];
+          }
+          num_pops += static_cast<int>(num);
+        }
+      });
+    }
+
+    for (std::uint32_t i = 0; i < num_prods; i++) {
+      prods.emplace_back([&]() {
+        std::vector<int> values;
+        for (std::uint32_t j = 0; j < num_values_by_prod; j += push_batch) {
+          values.clear();
+          for (std::uint32_t k = j; k < std::min(j + push_batch, num_values_by_prod); k++) {
+            values.push_back(static_cast<int>(k % 4));
+            sum_pushed += values.back();
+          }
+          q.push_bulk(values);
+        }
+      });
+    }
+
+    for (auto& thread : prods) {
+      thread.join();
+    }
+
+    while (q.has_value()) {
+      std::this_thread::yield();
+    }
+
+    stop = true;
+    for (auto& thread : consumers) {
+      thread.join();
+    }
+
+    EXPECT_EQ(num_pops.load(), num_values_by_prod * num_prods);
+  }
+
+  EXPECT_EQ(mem_before, mem_hook::num_allocated.load());
+
+  EXPECT_EQ(sum.load(), sum_pushed.load());
+}
+
+TEST_P(atomic_collections, int_sharded_queue) {
+  test_int_queue<async_coro::sharded_atomic_queue<int>>(std::get<0>(GetParam()), std::get<1>(GetParam()), 4U);
+}
+
+TEST_P(atomic_collections, int_queue_bulk) {
+  test_int_queue_bulk<async_coro::atomic_queue<int>>(std::get<0>(GetParam()), std::get<1>(GetParam()));
+}
+
+template <class TQueue>
+static void test_bank_reclamation() {
+  constexpr std::size_t block_size = 64;
+  constexpr std::size_t num_values = block_size * 10;
+
+  const auto mem_before = mem_hook::num_allocated.load();
+  {
+    TQueue q;
+
+    for (std::size_t i = 0; i < num_values; i++) {
+      q.push(static_cast<int>(i));
+    }
+    const auto num_banks_peak = q.get_num_banks();
+    EXPECT_GE(num_banks_peak, num_values / block_size);
+
+    int val = 0;
+    while (q.try_pop(val)) {
+    }
+
+    // without retained capacity banks are kept
+    q.push(1);
+    EXPECT_EQ(q.get_num_banks(), num_banks_peak);
+
+    q.shrink_to_fit();
+    // bank of pushed value (and stub for single consumer) can't be released
+    EXPECT_LE(q.get_num_banks(), 3);
+
+    for (std::size_t i = 0; i < num_values; i++) {
+      q.push(static_cast<int>(i));
+    }
+    EXPECT_GE(q.get_num_banks(), num_values / block_size);
+
+    q.set_retained_capacity(block_size * 2);
+
+    while (q.try_pop(val)) {
+    }
+    // single consumer queue releases banks on producer side when it runs out of free values
+    for (std::size_t i = 0; i < block_size + 1; i++) {
+      q.push(static_cast<int>(i));
+    }
+    EXPECT_LE(q.get_num_banks(), 3);
+
+    while (q.try_pop(val)) {
+    }
+  }
+
+  EXPECT_EQ(mem_before, mem_hook::num_allocated.load());
+}
+
+// queue that releases banks while producers and consumers are running
+template <class TQueue>
+struct retaining_queue : TQueue {
+  retaining_queue() noexcept { this->set_retained_capacity(64); }  // NOLINT(*-magic-*)
+};
+
+TEST_P(atomic_collections, int_packed_queue) {
+  test_int_queue<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::packed<async_coro::atomic_queue_policy::mpmc>>>(std::get<0>(GetParam()), std::get<1>(GetParam()));
+}
+
+TEST_P(atomic_collections, int_queue_retained) {
+  test_int_queue<retaining_queue<async_coro::atomic_queue<int>>>(std::get<0>(GetParam()), std::get<1>(GetParam()));
+}
+
+TEST(atomic_collections, bank_reclamation) {
+  test_bank_reclamation<async_coro::atomic_queue<int>>();
+}
+
+TEST(atomic_collections, bank_reclamation_mpsc) {
+  test_bank_reclamation<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::mpsc>>();
+}
+
+TEST(atomic_collections, bank_reclamation_spsc) {
+  test_bank_reclamation<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::spsc>>();
+}
+
+namespace {
+struct move_counter {
+  explicit move_counter(int val, std::atomic_int& num_moves) noexcept : value(val), moves(&num_moves) {}
+  move_counter(move_counter&& other) noexcept : value(other.value), moves(other.moves) { (*moves)++; }
+  move_counter(const move_counter&) = delete;
+  ~move_counter() noexcept = default;
+
+  move_counter& operator=(move_counter&& other) noexcept {
+    value = other.value;
+    moves = other.moves;
+    (*moves)++;
+    return *this;
+  }
+  move_counter& operator=(const move_counter&) = delete;
+
+  int value;
+  std::atomic_int* moves;
+};
+}  // namespace
+
+template <class TQueue>
+static void test_consume_in_place() {
+  std::atomic_int num_moves = 0;
+  std::atomic_int sum = 0;
+
+  TQueue q;
+
+  for (int i = 0; i < 1000; i++) {
+    q.push(i, num_moves);
+  }
+
+  while (q.try_consume([&sum](move_counter& val) { sum += val.value; })) {
+  }
+
+  EXPECT_FALSE(q.has_value());
+  EXPECT_EQ(num_moves.load(), 0);
+  EXPECT_EQ(sum.load(), 999 * 1000 / 2);
+}
+
+TEST(atomic_collections, consume_in_place) {
+  test_consume_in_place<async_coro::atomic_queue<move_counter>>();
+  test_consume_in_place<async_coro::atomic_queue<move_counter, 64, async_coro::atomic_queue_policy::mpsc>>();
+  test_consume_in_place<async_coro::atomic_queue<move_counter, 64, async_coro::atomic_queue_policy::spsc>>();
+}
+
+// owner pushes and pops values, other threads steal them
+static void test_work_stealing_deque(std::uint32_t num_thieves) {
+  constexpr int num_values = 1000000;
+
+  const auto mem_before = mem_hook::num_allocated.load();
+  {
+    async_coro::work_stealing_deque<int> deque{64};
+
+    std::atomic_int64_t sum = 0;
+    std::atomic_int num_taken = 0;
+    std::atomic_bool stop = false;
+
+    std::vector<std::thread> thieves;
+    for (std::uint32_t i = 0; i < num_thieves; i++) {
+      thieves.emplace_back([&]() {
+        int val = 0;
+        while (!stop.load()) {
+          if (deque.try_steal(val)) {
+            sum += val;
+            num_taken++;
+          }
+        }
+      });
+    }
+
+    std::int64_t sum_pushed = 0;
+    int val = 0;
+    for (int i = 0; i < num_values; i++) {
+      while (!deque.try_push(i)) {
+        // deque is full, help thieves
+        if (deque.try_pop(val)) {
+          sum += val;
+          num_taken++;
+        }
+      }
+      sum_pushed += i;
+
+      if (i % 3 == 0 && deque.try_pop(val)) {
+        sum += val;
+        num_taken++;
+      }
+    }
+
+    while (deque.try_pop(val)) {
+      sum += val;
+      num_taken++;
+    }
+
+    while (num_taken.load() < num_values) {
+      std::this_thread::yield();
+    }
+
+    stop = true;
+    for (auto& thread : thieves) {
+      thread.join();
+    }
+
+    EXPECT_FALSE(deque.has_value());
+    EXPECT_EQ(num_taken.load(), num_values);
+    EXPECT_EQ(sum.load(), sum_pushed);
+  }
+  EXPECT_EQ(mem_before, mem_hook::num_allocated.load());
+}
+
+TEST(atomic_collections, sharded_queue_cursor_per_instance) {
+  using queue_t = async_coro::sharded_atomic_queue<int>;
+
+  queue_t first{2};
+  queue_t second{2};
+
+  // producer from a thread whose slot maps to the other shard than the slot of this thread
+  const auto own_shard = async_coro::internal::get_producer_slot() % 2;
+  bool is_other_shard = false;
+  while (!is_other_shard) {
+    std::thread{[&] {
+      is_other_shard = async_coro::internal::get_producer_slot() % 2 != own_shard;
+      if (is_other_shard) {
+        first.push(2);
+        second.push(2);
+      }
+    }}.join();
+  }
+  first.push(1);
+  second.push(1);
+
+  // consumer starts from its own shard, popping from the first queue doesn't move the cursor of the second one
+  int val = 0;
+  ASSERT_TRUE(first.try_pop(val));
+  EXPECT_EQ(val, 1);
+  ASSERT_TRUE(second.try_pop(val));
+  EXPECT_EQ(val, 1);
+  ASSERT_TRUE(second.try_pop(val));
+  EXPECT_EQ(val, 2);
+  ASSERT_TRUE(first.try_pop(val));
+  EXPECT_EQ(val, 2);
+}
+
+TEST(atomic_collections, work_stealing_deque) {
+  test_work_stealing_deque(1);
+  test_work_stealing_deque(3);
+  test_work_stealing_deque(8);
+}
+
+class atomic_collections_single_consumer : public ::testing::TestWithParam<std::uint32_t> {
+};
+
+TEST_P(atomic_collections_single_consumer, int_mpsc_queue) {
+  test_int_queue<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::mpsc>>(1, GetParam());
+}
+
+TEST_P(atomic_collections_single_consumer, int_mpsc_queue_retained) {
+  test_int_queue<retaining_queue<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::mpsc>>>(1, GetParam());
+}
+
+TEST(atomic_collections_single_consumer, int_spsc_queue) {
+  test_int_queue<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::spsc>>(1, 1);
+}
+
+TEST_P(atomic_collections_single_consumer, int_mpsc_queue_bulk) {
+  test_int_queue_bulk<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::mpsc>>(1, GetParam());
+}
+
+TEST(atomic_collections_single_consumer, int_spsc_queue_bulk) {
+  test_int_queue_bulk<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::spsc>>(1, 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    atomic_collections_single_consumer,
+    atomic_collections_single_consumer,
+    ::testing::Values(1u, 2u, 3u, 4u, 8u, 16u),
+    [](const testing::TestParamInfo<atomic_collections_single_consumer::ParamType>& info) {
+      return "producers_" + std::to_string(info.param);
+    });
+
+template <class TQueue, class... TArgs>
+static auto measure_queue_throughput(std::uint32_t num_cons, std::uint32_t num_prods, TArgs... queue_args) {
+  constexpr std::uint32_t num_values_by_prod = 100000;
+
+  using clock = std::chrono::high_resolution_clock;
+
+  TQueue q{queue_args...};
+
+  std::atomic_uint32_t num_pops = 0;
+  std::vector<std::thread> threads;
+  threads.reserve(num_cons + num_prods);
+
+  const auto total = num_values_by_prod * num_prods;
+  const auto start = clock::now();
+
+  for (std::uint32_t i = 0; i < num_cons; i++) {
+    threads.emplace_back([&q, &num_pops, total]() {
+      int val = 0;
+      while (num_pops.load(std::memory_order::relaxed) < total) {
+        if (q.try_pop(val)) {
+          num_pops.fetch_add(1, std::memory_order::relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (std::uint32_t i = 0; i < num_prods; i++) {
+    threads.emplace_back([&q]() {
+      for (std::uint32_t j = 0; j < num_values_by_prod; j++) {
+        q.push(static_cast<int>(j));
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+}
+
+TEST_P(atomic_collections_perf, throughput_compare) {
+  const auto num_cons = std::get<0>(GetParam());
+  const auto num_prods = std::get<1>(GetParam());
+
+  const auto unbounded_t = measure_queue_throughput<async_coro::atomic_queue<int>>(num_cons, num_prods);
+  const auto bounded_t = measure_queue_throughput<async_coro::bounded_atomic_queue<int>>(num_cons, num_prods, 1024U);
+  const auto sharded_t = measure_queue_throughput<async_coro::sharded_atomic_queue<int>>(num_cons, num_prods, num_prods);
+
+  std::cout << "atomic_queue_us: " << unbounded_t.count() << " bounded_atomic_queue_us: " << bounded_t.count()
+            << " sharded_atomic_queue_us: " << sharded_t.count();
+
+  if (num_cons == 1) {
+    const auto mpsc_t = measure_queue_throughput<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::mpsc>>(num_cons, num_prods);
+    std::cout << " mpsc_queue_us: " << mpsc_t.count();
+
+    if (num_prods == 1) {
+      const auto spsc_t = measure_queue_throughput<async_coro::atomic_queue<int, 64, async_coro::atomic_queue_policy::spsc>>(num_cons, num_prods);
+      std::cout << " spsc_queue_us: " << spsc_t.count();
+    }
+  }
+
+  std::cout << "\n";
+}
+
+// Every producer/consumer pair works with its own queue, and all queues are placed next to each other in one array.
+// Measures how much neighbour queues slow each other down through shared cache lines
+template <class TQueue>
+static auto measure_neighbour_queues(std::uint32_t num_pairs) {
+  constexpr std::uint32_t num_values_by_prod = 20000;
+
+  using clock = std::chrono::high_resolution_clock;
+
+  // NOLINTNEXTLINE(*-avoid-c-arrays)
+  const auto queues = std::make_unique<TQueue[]>(num_pairs);
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_pairs * 2);
+
+  const auto start = clock::now();
+
+  for (std::uint32_t i = 0; i < num_pairs; i++) {
+    auto& q = queues[i];
+
+    threads.emplace_back([&q]() {
+      int val = 0;
+      std::uint32_t num_pops = 0;
+      while (num_pops < num_values_by_prod) {
+        if (q.try_pop(val)) {
+          num_pops++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+
+    threads.emplace_back([&q]() {
+      for (std::uint32_t j = 0; j < num_values_by_prod; j++) {
+        q.push(static_cast<int>(j));
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+}
+
+TEST(atomic_collections_perf, neighbour_queues_contention) {
+  // worker count of a 2 socket machine
+  constexpr std::uint32_t num_pairs = 32;
+
+  using namespace async_coro::atomic_queue_policy;
+
+  // packed layouts keep queue state without cache line padding, as it was before the state was split by writers
+  using padded_mpmc = async_coro::atomic_queue<int, 64, mpmc>;
+  using packed_mpmc = async_coro::atomic_queue<int, 64, packed<mpmc>>;
+  using padded_mpsc = async_coro::atomic_queue<int, 64, mpsc>;
+  using packed_mpsc = async_coro::atomic_queue<int, 64, packed<mpsc>>;
+
+  const auto packed_mpmc_t = measure_neighbour_queues<packed_mpmc>(num_pairs);
+  const auto padded_mpmc_t = measure_neighbour_queues<padded_mpmc>(num_pairs);
+  const auto packed_mpsc_t = measure_neighbour_queues<packed_mpsc>(num_pairs);
+  const auto padded_mpsc_t = measure_neighbour_queues<padded_mpsc>(num_pairs);
+
+  std::cout << "sizeof packed: " << sizeof(packed_mpmc) << " padded: " << sizeof(padded_mpmc) << "\n"
+            << "mpmc packed_us: " << packed_mpmc_t.count() << " padded_us: " << padded_mpmc_t.count() << "\n"
+            << "mpsc packed_us: " << packed_mpsc_t.count() << " padded_us: " << padded_mpsc_t.count() << "\n";
+}
+
 INSTANTIATE_TEST_SUITE_P(
     atomic_collections,
     atomic_collections,
@@ -138,4 +615,17 @@ INSTANTIATE_TEST_SUITE_P(
       return "consumers_" + std::to_string(std::get<0>(info.param)) + "_producers_" + std::to_string(std::get<1>(info.param));
     });
 
+INSTANTIATE_TEST_SUITE_P(
+    atomic_collections_perf,
+    atomic_collections_perf,
+    ::testing::Values(
+        std::make_tuple(1u, 1u),
+        std::make_tuple(1u, 4u),
+        std::make_tuple(4u, 1u),
+        std::make_tuple(4u, 4u),
+        std::make_tuple(8u, 8u)),
+    [](const testing::TestParamInfo<atomic_collections_perf::ParamType>& info) {
+      return "consumers_" + std::to_string(std::get<0>(info.param)) + "_producers_" + std::to_string(std::get<1>(info.param));
+    });
+
 // NOLINTEND(*-narrowing-*)
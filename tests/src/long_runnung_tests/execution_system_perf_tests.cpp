@@ -0,0 +1,606 @@
+#include <async_coro/execution_queue_mark.h>
+#include <async_coro/execution_system.h>
+#include <async_coro/numa_topology.h>
+#include <async_coro/runtime_clock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<async_coro::execution_thread_config> make_workers(std::uint32_t num_workers) {
+  std::vector<async_coro::execution_thread_config> workers;
+  workers.reserve(num_workers);
+  for (std::uint32_t i = 0; i < num_workers; i++) {
+    workers.emplace_back("worker" + std::to_string(i), async_coro::execution_queues::worker);
+  }
+  return workers;
+}
+
+// every task plans two children until max depth is reached
+void plan_tree(async_coro::execution_system& system, std::atomic_uint32_t& num_executed, std::uint32_t depth) {
+  system.plan_execution(
+      [&system, &num_executed, depth](const auto&) {
+        num_executed.fetch_add(1, std::memory_order::relaxed);
+        if (depth > 0) {
+          plan_tree(system, num_executed, depth - 1);
+          plan_tree(system, num_executed, depth - 1);
+        }
+      },
+      async_coro::execution_queues::worker);
+}
+
+auto measure_task_tree(std::uint32_t num_workers, bool work_stealing) {
+  constexpr std::uint32_t depth = 17;
+  constexpr std::uint32_t num_tasks = (1U << (depth + 1)) - 1;
+
+  using clock = std::chrono::high_resolution_clock;
+
+  async_coro::execution_system system{{.worker_configs = make_workers(num_workers),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main,
+                                       .work_stealing = work_stealing}};
+
+  std::atomic_uint32_t num_executed = 0;
+
+  const auto start = clock::now();
+
+  plan_tree(system, num_executed, depth);
+
+  while (num_executed.load(std::memory_order::relaxed) < num_tasks) {
+    std::this_thread::yield();
+  }
+
+  const auto time = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+
+  return time;
+}
+
+struct deadline_result {
+  std::chrono::microseconds time;
+  std::uint32_t num_missed;
+};
+
+// tasks with random deadlines are released at once, their deadlines leave 20% of slack over the work of every worker
+deadline_result measure_deadline_misses(std::uint32_t num_workers, async_coro::execution_queue_type queue_type) {
+  constexpr std::uint32_t num_tasks = 20000;
+  static constexpr auto task_work = std::chrono::microseconds{10};
+  constexpr auto planning_time = std::chrono::milliseconds{100};
+
+  using clock = std::chrono::high_resolution_clock;
+
+  async_coro::execution_system system{{.worker_configs = make_workers(num_workers),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main,
+                                       .queue_configs = {{.queue = async_coro::execution_queues::worker, .type = queue_type}}}};
+
+  std::atomic_uint32_t num_executed = 0;
+  std::atomic_uint32_t num_missed = 0;
+
+  // workers are held until all tasks are planned, deadlines count from their release
+  std::atomic_uint32_t num_held = 0;
+  std::atomic_bool release = false;
+  for (std::uint32_t i = 0; i < num_workers; i++) {
+    system.plan_execution(
+        [&](const auto&) {
+          num_held.fetch_add(1, std::memory_order::relaxed);
+          while (!release.load(std::memory_order::acquire)) {
+            std::this_thread::yield();
+          }
+        },
+        async_coro::execution_queues::worker);
+  }
+  while (num_held.load(std::memory_order::relaxed) < num_workers) {
+    std::this_thread::yield();
+  }
+
+  std::mt19937 rng{42};  // NOLINT(*-magic-*)
+  const auto release_time = std::chrono::steady_clock::now() + planning_time;
+  const auto span = std::chrono::nanoseconds{task_work * num_tasks / num_workers} * 6 / 5;  // NOLINT(*-magic-*)
+  std::uniform_int_distribution<std::int64_t> deadline_dist{0, span.count()};
+
+  for (std::uint32_t i = 0; i < num_tasks; i++) {
+    const auto deadline = release_time + std::chrono::nanoseconds{deadline_dist(rng)};
+    system.plan_execution(
+        [&num_executed, &num_missed, deadline](const auto&) {
+          const auto end = std::chrono::steady_clock::now() + task_work;
+          while (std::chrono::steady_clock::now() < end) {
+          }
+          if (end > deadline) {
+            num_missed.fetch_add(1, std::memory_order::relaxed);
+          }
+          num_executed.fetch_add(1, std::memory_order::relaxed);
+        },
+        async_coro::execution_queues::worker, async_coro::task_deadline{deadline});
+  }
+
+  std::this_thread::sleep_until(release_time);
+  const auto start = clock::now();
+  release.store(true, std::memory_order::release);
+
+  while (num_executed.load(std::memory_order::relaxed) < num_tasks) {
+    std::this_thread::yield();
+  }
+
+  return {.time = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start), .num_missed = num_missed.load()};
+}
+
+auto measure_numa_task_tree(std::uint32_t num_workers, async_coro::execution_queue_type queue_type) {
+  constexpr std::uint32_t depth = 17;
+  constexpr std::uint32_t num_tasks = (1U << (depth + 1)) - 1;
+
+  using clock = std::chrono::high_resolution_clock;
+
+  // workers are spread over nodes of the machine, single node machines measure the overhead of node lookups
+  const auto topology = async_coro::numa_topology::discover();
+  const auto workers_per_node = std::max(1U, num_workers / topology.get_num_nodes());
+
+  async_coro::execution_system system{{.worker_configs = make_numa_worker_configs(topology, workers_per_node, async_coro::execution_queues::worker),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main,
+                                       .topology = topology,
+                                       .queue_configs = {{.queue = async_coro::execution_queues::worker, .type = queue_type}}}};
+
+  std::atomic_uint32_t num_executed = 0;
+
+  const auto start = clock::now();
+
+  plan_tree(system, num_executed, depth);
+
+  while (num_executed.load(std::memory_order::relaxed) < num_tasks) {
+    std::this_thread::yield();
+  }
+
+  const auto time = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+
+  return time;
+}
+
+// every task of the chain plans the next one, like coroutine continuations waking each other
+struct continuation_chain {
+  async_coro::execution_system& system;
+  std::atomic_uint32_t& num_executed;
+  std::uint32_t num_left;
+
+  void operator()(const async_coro::executor_data& /*data*/) const {
+    num_executed.fetch_add(1, std::memory_order::relaxed);
+    if (num_left > 0) {
+      system.plan_execution(continuation_chain{system, num_executed, num_left - 1}, async_coro::execution_queues::worker);
+    }
+  }
+};
+
+auto measure_continuation_chains(std::uint32_t num_workers, bool lifo_slot) {
+  constexpr std::uint32_t num_chains = 16;
+  constexpr std::uint32_t chain_length = 20000;
+
+  using clock = std::chrono::high_resolution_clock;
+
+  async_coro::execution_system system{{.worker_configs = make_workers(num_workers),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main,
+                                       .lifo_slot = lifo_slot}};
+
+  std::atomic_uint32_t num_executed = 0;
+
+  const auto start = clock::now();
+
+  for (std::uint32_t i = 0; i < num_chains; i++) {
+    system.plan_execution(continuation_chain{system, num_executed, chain_length - 1}, async_coro::execution_queues::worker);
+  }
+
+  while (num_executed.load(std::memory_order::relaxed) < num_chains * chain_length) {
+    std::this_thread::yield();
+  }
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+}
+
+// average delay between time point of a delayed task and its execution
+auto measure_timer_latency(std::uint32_t num_workers, bool worker_timers) {
+  constexpr std::uint32_t num_timers = 2000;
+
+  async_coro::execution_system system{{.worker_configs = make_workers(num_workers),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main,
+                                       .worker_timers = worker_timers}};
+
+  std::atomic_uint32_t num_executed = 0;
+  std::atomic<std::int64_t> total_latency_ns = 0;
+
+  const auto now = std::chrono::steady_clock::now();
+  for (std::uint32_t i = 0; i < num_timers; i++) {
+    const auto when = now + std::chrono::milliseconds{1} + std::chrono::microseconds{(i % 500) * 200};  // NOLINT(*-magic-*)
+    system.plan_execution_after(
+        [&, when](const auto&) {
+          total_latency_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - when).count(),
+                                     std::memory_order::relaxed);
+          num_executed.fetch_add(1, std::memory_order::relaxed);
+        },
+        async_coro::execution_queues::worker, when);
+  }
+
+  while (num_executed.load(std::memory_order::relaxed) < num_timers) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  return std::chrono::microseconds{total_latency_ns.load() / num_timers / 1000};  // NOLINT(*-magic-*)
+}
+
+// errors of wakeups of sequential 50us sleeps, sorted
+std::vector<std::chrono::nanoseconds> measure_wakeup_errors(bool high_resolution_timers, std::chrono::microseconds spin) {
+  constexpr std::uint32_t num_sleeps = 2000;
+
+  async_coro::execution_system system{{.worker_configs = make_workers(1),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main,
+                                       .timer_resolution = std::chrono::microseconds{1},
+                                       .high_resolution_timers = high_resolution_timers,
+                                       .timer_spin_duration = spin}};
+
+  std::vector<std::chrono::nanoseconds> errors;
+  errors.reserve(num_sleeps);
+
+  for (std::uint32_t i = 0; i < num_sleeps; i++) {
+    std::atomic_bool is_executed = false;
+    std::chrono::nanoseconds error{};
+
+    const auto when = std::chrono::steady_clock::now() + std::chrono::microseconds{50};  // NOLINT(*-magic-*)
+    system.plan_execution_after(
+        [&, when](const auto&) {
+          error = std::chrono::steady_clock::now() - when;
+          is_executed.store(true, std::memory_order::release);
+        },
+        async_coro::execution_queues::worker, when);
+
+    while (!is_executed.load(std::memory_order::acquire)) {
+      std::this_thread::yield();
+    }
+    errors.push_back(error);
+  }
+
+  std::ranges::sort(errors);
+  return errors;
+}
+
+void print_wakeup_errors(const char* name, const std::vector<std::chrono::nanoseconds>& errors) {
+  const auto percentile = [&errors](double part) {
+    const auto index = static_cast<std::size_t>(part * static_cast<double>(errors.size() - 1));
+    return std::chrono::duration<double, std::micro>{errors[index]}.count();
+  };
+
+  std::cout << name << " p50_us: " << percentile(0.5) << " p90_us: " << percentile(0.9)  // NOLINT(*-magic-*)
+            << " p99_us: " << percentile(0.99) << " p999_us: " << percentile(0.999)      // NOLINT(*-magic-*)
+            << " max_us: " << percentile(1.0) << "\n";
+}
+
+struct idle_policy_result {
+  std::chrono::microseconds avg_latency{};
+  std::chrono::microseconds spin_time{};
+  std::chrono::microseconds park_time{};
+};
+
+// latency of tasks planned with short and long gaps and idle time of workers
+idle_policy_result measure_idle_policy(std::uint32_t num_workers, async_coro::worker_idle_policy policy) {
+  constexpr std::uint32_t num_tasks = 2000;
+
+  auto workers = make_workers(num_workers);
+  for (auto& worker : workers) {
+    worker.idle_policy = policy;
+  }
+
+  async_coro::execution_system system{{.worker_configs = std::move(workers),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main}};
+
+  std::atomic_uint32_t num_executed = 0;
+  std::atomic<std::int64_t> total_latency_ns = 0;
+
+  for (std::uint32_t i = 0; i < num_tasks; i++) {
+    const auto planned = std::chrono::steady_clock::now();
+    system.plan_execution(
+        [&, planned](const auto&) {
+          total_latency_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - planned).count(),
+                                     std::memory_order::relaxed);
+          num_executed.fetch_add(1, std::memory_order::relaxed);
+        },
+        async_coro::execution_queues::worker);
+
+    // bursts of tasks with short gaps are separated by long pauses
+    std::this_thread::sleep_for((i % 20 == 19) ? std::chrono::microseconds{1000} : std::chrono::microseconds{10});  // NOLINT(*-magic-*)
+  }
+
+  while (num_executed.load(std::memory_order::relaxed) < num_tasks) {
+    std::this_thread::yield();
+  }
+
+  idle_policy_result result;
+  result.avg_latency = std::chrono::microseconds{total_latency_ns.load() / num_tasks / 1000};  // NOLINT(*-magic-*)
+  for (std::uint32_t i = 0; i < num_workers; i++) {
+    const auto stats = system.get_worker_stats(i);
+    result.spin_time += std::chrono::duration_cast<std::chrono::microseconds>(stats.spin_time);
+    result.park_time += std::chrono::duration_cast<std::chrono::microseconds>(stats.park_time);
+  }
+  return result;
+}
+
+}  // namespace
+
+class execution_system_perf : public ::testing::TestWithParam<std::uint32_t> {
+};
+
+TEST_P(execution_system_perf, work_stealing_compare) {
+  const auto num_workers = GetParam();
+
+  const auto shared_t = measure_task_tree(num_workers, false);
+  const auto stealing_t = measure_task_tree(num_workers, true);
+
+  std::cout << "shared_queue_us: " << shared_t.count() << " work_stealing_us: " << stealing_t.count() << "\n";
+}
+
+TEST_P(execution_system_perf, lifo_slot_compare) {
+  const auto num_workers = GetParam();
+
+  const auto shared_t = measure_continuation_chains(num_workers, false);
+  const auto lifo_t = measure_continuation_chains(num_workers, true);
+
+  std::cout << "shared_queue_us: " << shared_t.count() << " lifo_slot_us: " << lifo_t.count() << "\n";
+}
+
+TEST_P(execution_system_perf, worker_timers_compare) {
+  const auto num_workers = GetParam();
+
+  const auto thread_t = measure_timer_latency(num_workers, false);
+  const auto worker_t = measure_timer_latency(num_workers, true);
+
+  std::cout << "timer_thread_latency_us: " << thread_t.count() << " worker_timers_latency_us: " << worker_t.count() << "\n";
+}
+
+TEST_P(execution_system_perf, numa_queue_compare) {
+  const auto num_workers = GetParam();
+
+  const auto shared_t = measure_numa_task_tree(num_workers, async_coro::execution_queue_type::unbounded);
+  const auto numa_t = measure_numa_task_tree(num_workers, async_coro::execution_queue_type::numa);
+
+  std::cout << "nodes: " << async_coro::numa_topology::discover().get_num_nodes() << " shared_queue_us: " << shared_t.count()
+            << " numa_queue_us: " << numa_t.count() << "\n";
+}
+
+TEST_P(execution_system_perf, weighted_queues_saturation) {
+  constexpr std::uint32_t num_tasks = 200000;
+  constexpr std::uint32_t worker_weight = 4;
+
+  // every worker serves both queues
+  auto workers = make_workers(GetParam());
+  for (auto& worker : workers) {
+    worker.allowed_tasks = async_coro::execution_queues::worker | async_coro::execution_queues::any;
+  }
+
+  async_coro::execution_system system{{.worker_configs = std::move(workers),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main,
+                                       .queue_configs = {{.queue = async_coro::execution_queues::worker, .weight = worker_weight},
+                                                         {.queue = async_coro::execution_queues::any, .weight = 1}}}};
+
+  std::atomic_uint32_t num_worker_executed = 0;
+  std::atomic_uint32_t num_any_executed = 0;
+  std::atomic_uint32_t num_any_at_drain = 0;
+
+  // workers are held until both queues are filled, so they are saturated from the first task
+  std::atomic_uint32_t num_held = 0;
+  std::atomic_bool release = false;
+  for (std::uint32_t i = 0; i < GetParam(); i++) {
+    system.plan_execution(
+        [&](const auto&) {
+          num_held.fetch_add(1, std::memory_order::relaxed);
+          while (!release.load(std::memory_order::acquire)) {
+            std::this_thread::yield();
+          }
+        },
+        async_coro::execution_queues::any);
+  }
+  while (num_held.load(std::memory_order::relaxed) < GetParam()) {
+    std::this_thread::yield();
+  }
+
+  for (std::uint32_t i = 0; i < num_tasks; i++) {
+    system.plan_execution(
+        [&](const auto&) {
+          // shares are measured when the heavier queue is drained, while the other one still has tasks
+          if (num_worker_executed.fetch_add(1, std::memory_order::relaxed) + 1 == num_tasks) {
+            num_any_at_drain.store(num_any_executed.load(std::memory_order::relaxed), std::memory_order::relaxed);
+          }
+        },
+        async_coro::execution_queues::worker);
+    system.plan_execution([&](const auto&) { num_any_executed.fetch_add(1, std::memory_order::relaxed); }, async_coro::execution_queues::any);
+  }
+  release.store(true, std::memory_order::release);
+
+  while (num_worker_executed.load(std::memory_order::relaxed) < num_tasks || num_any_executed.load(std::memory_order::relaxed) < num_tasks) {
+    std::this_thread::yield();
+  }
+
+  const auto num_any = num_any_at_drain.load(std::memory_order::relaxed);
+  std::cout << "weights: " << worker_weight << ":1 served_worker: " << num_tasks << " served_any: " << num_any
+            << " ratio: " << static_cast<double>(num_tasks) / static_cast<double>(std::max<std::uint32_t>(num_any, 1))
+            << " total_served_worker: " << system.get_num_served_tasks(async_coro::execution_queues::worker)
+            << " total_served_any: " << system.get_num_served_tasks(async_coro::execution_queues::any) << "\n";
+}
+
+TEST_P(execution_system_perf, deadline_queue_compare) {
+  const auto num_workers = GetParam();
+
+  const auto fifo = measure_deadline_misses(num_workers, async_coro::execution_queue_type::unbounded);
+  const auto edf = measure_deadline_misses(num_workers, async_coro::execution_queue_type::deadline);
+
+  std::cout << "fifo_us: " << fifo.time.count() << " fifo_missed: " << fifo.num_missed
+            << " edf_us: " << edf.time.count() << " edf_missed: " << edf.num_missed << "\n";
+}
+
+TEST_P(execution_system_perf, wakeup_counters) {
+  constexpr std::uint32_t depth = 17;
+  constexpr std::uint32_t num_tasks = (1U << (depth + 1)) - 1;
+
+  using clock = std::chrono::high_resolution_clock;
+
+  async_coro::execution_system system{{.worker_configs = make_workers(GetParam()),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main}};
+
+  std::atomic_uint32_t num_executed = 0;
+
+  const auto start = clock::now();
+
+  plan_tree(system, num_executed, depth);
+
+  while (num_executed.load(std::memory_order::relaxed) < num_tasks) {
+    std::this_thread::yield();
+  }
+
+  const auto time = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+  const auto stats = system.get_stats();
+
+  std::cout << "task_tree_us: " << time.count() << " wakeups: " << stats.num_wakeups << " skipped_wakeups: " << stats.num_skipped_wakeups << "\n";
+}
+
+TEST_P(execution_system_perf, idle_policy_compare) {
+  const auto num_workers = GetParam();
+
+  for (const auto policy : {async_coro::worker_idle_policy::fixed_loops, async_coro::worker_idle_policy::adaptive}) {
+    const auto result = measure_idle_policy(num_workers, policy);
+
+    std::cout << (policy == async_coro::worker_idle_policy::adaptive ? "adaptive" : "fixed_loops")
+              << " latency_us: " << result.avg_latency.count() << " spin_us: " << result.spin_time.count()
+              << " park_us: " << result.park_time.count() << "\n";
+  }
+}
+
+TEST(execution_system_perf, million_delayed_tasks) {
+  constexpr std::uint32_t num_timers = 1000000;
+
+  using clock = std::chrono::high_resolution_clock;
+
+  async_coro::execution_system system{{.worker_configs = make_workers(1),
+                                       .main_thread_allowed_tasks = async_coro::execution_queues::main}};
+
+  std::vector<async_coro::delayed_task_id> ids;
+  ids.reserve(num_timers);
+
+  // timeouts spread over one hour like request timeouts of a busy service
+  const auto now = std::chrono::steady_clock::now();
+
+  auto start = clock::now();
+  for (std::uint32_t i = 0; i < num_timers; i++) {
+    ids.push_back(system.plan_execution_after([](const auto&) {}, async_coro::execution_queues::worker,
+                                              now + std::chrono::seconds{1} + std::chrono::milliseconds{i % 3600000}));
+  }
+  const auto plan_t = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+  // cancel in random order
+  std::mt19937 rng{42};  // NOLINT(*-magic-*)
+  std::ranges::shuffle(ids, rng);
+
+  std::uint32_t num_cancelled = 0;
+  start = clock::now();
+  for (const auto& task_id : ids) {
+    num_cancelled += system.cancel_execution(task_id) ? 1 : 0;
+  }
+  const auto cancel_t = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+  EXPECT_EQ(num_cancelled, num_timers);
+
+  std::cout << "plan_after_us: " << plan_t.count() << " cancel_us: " << cancel_t.count() << "\n";
+}
+
+TEST(execution_system_perf, runtime_clock_compare) {
+  constexpr std::uint32_t num_reads = 10000000;
+
+  using clock = std::chrono::high_resolution_clock;
+
+  const auto measure = [](auto&& read_time) {
+    std::int64_t sum = 0;
+    const auto start = clock::now();
+    for (std::uint32_t i = 0; i < num_reads; i++) {
+      sum += read_time().time_since_epoch().count() & 1;
+    }
+    const auto time = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+    EXPECT_GE(sum, 0);
+    return time;
+  };
+
+  const auto precise_t = measure([] { return async_coro::runtime_clock::read(async_coro::clock_mode::precise); });
+  const auto coarse_t = measure([] { return async_coro::runtime_clock::read(async_coro::clock_mode::coarse); });
+
+  async_coro::runtime_clock::refresh(async_coro::clock_mode::cached);
+  const auto cached_t = measure([] { return async_coro::runtime_clock::now(); });
+  async_coro::runtime_clock::reset();
+
+  std::cout << "precise_us: " << precise_t.count() << " coarse_us: " << coarse_t.count() << " cached_us: " << cached_t.count() << "\n";
+}
+
+TEST(execution_system_perf, high_resolution_timers_accuracy) {
+  print_wakeup_errors("condition_variable", measure_wakeup_errors(false, std::chrono::microseconds{0}));
+  print_wakeup_errors("timerfd", measure_wakeup_errors(true, std::chrono::microseconds{0}));
+  print_wakeup_errors("timerfd_spin_20us", measure_wakeup_errors(true, std::chrono::microseconds{20}));  // NOLINT(*-magic-*)
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    execution_system_perf,
+    execution_system_perf,
+    ::testing::Values(1U, 2U, 4U, 8U),
+    [](const testing::TestParamInfo<execution_system_perf::ParamType>& info) {
+      return "workers_" + std::to_string(info.param);
+    });
+
+TEST(execution_system_perf, worker_groups_load_phases) {
+  constexpr int num_tasks = 400;
+  constexpr std::uint32_t max_workers = 8;
+
+  using clock = std::chrono::high_resolution_clock;
+
+  async_coro::execution_system system{{
+      .worker_configs = {},
+      .main_thread_allowed_tasks = async_coro::execution_queues::main,
+      .worker_groups = {{.worker = {"elastic", async_coro::execution_queues::worker},
+                         .min_workers = 1,
+                         .max_workers = max_workers,
+                         .spawn_delay = std::chrono::milliseconds{1},
+                         .idle_timeout = std::chrono::milliseconds{50}}},  // NOLINT(*-magic-*)
+  }};
+
+  // peak phase: tasks block like calls to slow services, so the group grows
+  std::atomic_int num_executed{0};
+  std::uint32_t max_running = 0;
+
+  const auto start = clock::now();
+  for (int i = 0; i < num_tasks; i++) {
+    system.plan_execution(
+        [&](const auto&) {
+          std::this_thread::sleep_for(std::chrono::microseconds{200});  // NOLINT(*-magic-*)
+          num_executed++;
+        },
+        async_coro::execution_queues::worker);
+  }
+  while (num_executed.load() < num_tasks) {
+    max_running = std::max(max_running, system.get_num_running_workers());
+    std::this_thread::sleep_for(std::chrono::microseconds{100});  // NOLINT(*-magic-*)
+  }
+  const auto peak_t = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+  // quiet phase: threads above min_workers exit
+  const auto idle_start = clock::now();
+  while (system.get_num_running_workers() > 1 && clock::now() - idle_start < std::chrono::seconds{5}) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  const auto shrink_t = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - idle_start);
+
+  EXPECT_GT(max_running, 1);
+  EXPECT_LE(max_running, max_workers);
+  EXPECT_EQ(system.get_num_running_workers(), 1);
+
+  std::cout << "peak_us: " << peak_t.count() << " max_running: " << max_running << " shrink_ms: " << shrink_t.count() << "\n";
+}
@@ -0,0 +1,69 @@
+#include <async_coro/internal/adaptive_spin.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace {
+
+using spin_t = async_coro::internal::adaptive_spin;
+using std::chrono::microseconds;
+
+}  // namespace
+
+TEST(adaptive_spin, grows_to_wake_latency) {
+  spin_t spin{microseconds{1}, microseconds{100}};
+
+  EXPECT_EQ(spin.get_budget(), microseconds{1});
+
+  for (int i = 0; i < 100; i++) {
+    spin.on_wake_latency(microseconds{20});
+  }
+  EXPECT_NEAR(static_cast<double>(std::chrono::duration_cast<microseconds>(spin.get_wake_latency()).count()), 20.0, 1.0);
+
+  // short idle periods make spinning worth it up to the wake latency
+  for (int i = 0; i < 10; i++) {
+    spin.on_idle_end(microseconds{10});
+  }
+  EXPECT_EQ(spin.get_budget(), spin.get_wake_latency());
+}
+
+TEST(adaptive_spin, shrinks_on_long_idle) {
+  spin_t spin{microseconds{2}, microseconds{50}};
+
+  for (int i = 0; i < 10; i++) {
+    spin.on_idle_end(microseconds{5});
+  }
+
+  // wake latency isn't known yet, max spin is the limit
+  EXPECT_EQ(spin.get_budget(), microseconds{50});
+
+  spin.on_idle_end(std::chrono::milliseconds{10});
+  EXPECT_EQ(spin.get_budget(), microseconds{25});
+
+  for (int i = 0; i < 10; i++) {
+    spin.on_idle_end(std::chrono::milliseconds{10});
+  }
+  EXPECT_EQ(spin.get_budget(), microseconds{2});
+}
+
+TEST(adaptive_spin, budget_is_bounded) {
+  spin_t spin{microseconds{5}, microseconds{30}};
+
+  // very slow and very fast wakeups don't move the budget out of bounds
+  for (int i = 0; i < 100; i++) {
+    spin.on_wake_latency(std::chrono::milliseconds{1});
+    spin.on_idle_end(microseconds{1});
+  }
+  EXPECT_EQ(spin.get_budget(), microseconds{30});
+
+  for (int i = 0; i < 100; i++) {
+    spin.on_wake_latency(std::chrono::nanoseconds{100});
+  }
+  spin.on_idle_end(microseconds{1});
+  EXPECT_EQ(spin.get_budget(), microseconds{5});
+
+  for (int i = 0; i < 20; i++) {
+    spin.backoff();
+  }
+  spin.reset_backoff();
+}
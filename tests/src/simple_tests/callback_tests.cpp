@@ -2,6 +2,9 @@
 #include <async_coro/utils/callback_fwd.h>
 #include <async_coro/utils/callback_ptr.h>
 #include <gtest/gtest.h>
+#include <utils/counting_resource.h>
+
+#include <memory_resource>
 
 namespace callback_tests {
 struct destructor_checker {
@@ -150,3 +153,29 @@ TEST(callback, different_captured_types_noexcept) {
 
   EXPECT_EQ(result, 10 + 30 + 40);
 }
+
+TEST(callback, allocate_from_memory_resource) {
+  mem_hook::counting_resource resource;
+
+  bool destructed = false;
+  int result = 0;
+  {
+    auto callback = async_coro::allocate_callback([&result, checker = callback_tests::destructor_checker{destructed}](int value) {
+      result = value;
+    },
+                                                  resource);
+    EXPECT_EQ(resource.num_allocated.load(), 1);
+
+    callback.execute(5);
+    EXPECT_EQ(result, 5);
+  }
+  EXPECT_TRUE(destructed);
+  EXPECT_EQ(resource.num_allocated.load(), 0);
+
+  auto noexcept_callback = async_coro::allocate_callback([&result](int value) noexcept { result = value; }, resource);
+  EXPECT_EQ(resource.num_allocated.load(), 1);
+
+  noexcept_callback.execute_and_destroy(7);
+  EXPECT_EQ(result, 7);
+  EXPECT_EQ(resource.num_allocated.load(), 0);
+}
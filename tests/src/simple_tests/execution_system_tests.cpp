@@ -1,10 +1,16 @@
 #include <async_coro/execution_queue_mark.h>
 #include <async_coro/execution_system.h>
 #include <gtest/gtest.h>
+#include <utils/counting_resource.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <memory_resource>
 #include <mutex>
+#include <set>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -53,7 +59,7 @@ TEST(execution_system, check_executor_data_thread) {
 
   execution_system system{{.worker_configs = {{"worker", execution_queues::worker}}, .main_thread_allowed_tasks = execution_queues::main}};
 
-  const auto main_thread_id = std::this_thread::get_id();
+  const auto main_thread_id = thread_index::current();
 
   EXPECT_EQ(system.get_main_thread_executor_data().get_owning_thread(), main_thread_id);
 }
@@ -224,3 +230,1509 @@ TEST(execution_system, delayed_multiple_diff_time_order_worker) {
     EXPECT_EQ(order[i], 4 - i);  // reverse order because of time points
   }
 }
+
+TEST(execution_system, bounded_queue_overflow) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .queue_configs = {{.queue = execution_queues::main, .type = execution_queue_type::bounded, .capacity = 4},
+                                             {.queue = execution_queues::worker, .type = execution_queue_type::bounded, .capacity = 4}}}};
+
+  constexpr int num_tasks = 100;
+
+  std::vector<int> order;
+  std::atomic_int num_executed{0};
+
+  for (int i = 0; i < num_tasks; ++i) {
+    system.plan_execution([i, &order](auto&) { order.push_back(i); }, execution_queues::main);
+    system.plan_execution([&num_executed](auto&) { num_executed++; }, execution_queues::worker);
+  }
+
+  for (int tries = 0; tries < num_tasks * 2 && order.size() < num_tasks; ++tries) {
+    system.update_from_main();
+  }
+
+  ASSERT_EQ(order.size(), num_tasks);
+  for (int i = 0; i < num_tasks; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+
+  for (int tries = 0; tries < 200 && num_executed.load() < num_tasks; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+}
+
+TEST(execution_system, plan_execution_bulk) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker1", execution_queues::worker}, {"worker2", execution_queues::worker}, {"worker3", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .queue_configs = {{.queue = execution_queues::main, .type = execution_queue_type::bounded, .capacity = 8}}}};
+
+  constexpr int num_tasks = 50;
+
+  std::vector<int> order;
+  std::atomic_int num_executed{0};
+
+  std::vector<i_execution_system::task_function> main_tasks;
+  std::vector<i_execution_system::task_function> worker_tasks;
+  for (int i = 0; i < num_tasks; ++i) {
+    main_tasks.emplace_back([i, &order](auto&) { order.push_back(i); });
+    worker_tasks.emplace_back([&num_executed](auto&) { num_executed++; });
+  }
+  // empty functions are skipped
+  worker_tasks.emplace_back();
+
+  system.plan_execution_bulk(main_tasks, execution_queues::main);
+  system.plan_execution_bulk(worker_tasks, execution_queues::worker);
+
+  for (int tries = 0; tries < num_tasks * 2 && order.size() < num_tasks; ++tries) {
+    system.update_from_main();
+  }
+
+  ASSERT_EQ(order.size(), num_tasks);
+  for (int i = 0; i < num_tasks; ++i) {
+    EXPECT_EQ(order[i], i);
+  }
+
+  for (int tries = 0; tries < 200 && num_executed.load() < num_tasks; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+}
+
+TEST(execution_system, queue_memory_reclamation) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .queue_configs = {{.queue = execution_queues::main, .retained_capacity = 64}}}};
+
+  constexpr int num_tasks = 1000;
+
+  int num_executed = 0;
+  for (int i = 0; i < num_tasks; ++i) {
+    system.plan_execution([&num_executed](auto&) { num_executed++; }, execution_queues::main);
+  }
+
+  const auto num_banks_peak = system.get_num_allocated_banks(execution_queues::main);
+  EXPECT_GT(num_banks_peak, 1);
+
+  while (num_executed < num_tasks) {
+    system.update_from_main();
+  }
+
+  system.shrink_to_fit();
+
+  EXPECT_LT(system.get_num_allocated_banks(execution_queues::main), num_banks_peak);
+  EXPECT_LE(system.get_num_allocated_banks(execution_queues::main), 2);
+}
+
+TEST(execution_system, sharded_queue_keeps_producer_order) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .queue_configs = {{.queue = execution_queues::main, .type = execution_queue_type::sharded, .num_shards = 3}}}};
+
+  constexpr int num_producers = 4;
+  constexpr int num_tasks = 200;
+
+  std::vector<std::vector<int>> orders(num_producers);
+  std::vector<std::thread> producers;
+
+  for (int producer = 0; producer < num_producers; ++producer) {
+    producers.emplace_back([&system, &orders, producer]() {
+      for (int i = 0; i < num_tasks; ++i) {
+        system.plan_execution([&orders, producer, i](auto&) { orders[producer].push_back(i); }, execution_queues::main);
+      }
+    });
+  }
+
+  for (auto& thread : producers) {
+    thread.join();
+  }
+
+  for (int tries = 0; tries < num_tasks * num_producers * 2; ++tries) {
+    system.update_from_main();
+  }
+
+  for (const auto& order : orders) {
+    ASSERT_EQ(order.size(), num_tasks);
+    for (int i = 0; i < num_tasks; ++i) {
+      EXPECT_EQ(order[i], i);
+    }
+  }
+}
+
+TEST(execution_system, memory_resource) {
+  using namespace async_coro;
+
+  mem_hook::counting_resource resource;
+
+  {
+    execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                             .main_thread_allowed_tasks = execution_queues::main,
+                             .queue_configs = {{.queue = execution_queues::worker, .type = execution_queue_type::bounded, .capacity = 16}},
+                             .memory_resource = &resource}};
+
+    EXPECT_EQ(system.get_memory_resource(), &resource);
+
+    constexpr int num_tasks = 500;
+
+    std::atomic_int num_executed{0};
+    for (int i = 0; i < num_tasks; ++i) {
+      system.plan_execution([&num_executed](auto&) { num_executed++; }, execution_queues::main);
+    }
+    system.plan_execution_after([&num_executed](auto&) { num_executed++; }, execution_queues::worker, std::chrono::steady_clock::now() + std::chrono::milliseconds{1});
+
+    const auto num_allocations = resource.num_allocations.load();
+    EXPECT_GT(num_allocations, 0);
+
+    struct thread_data {
+      int value = 0;
+    };
+    system.get_main_thread_executor_data().get_data<thread_data>().value = 1;
+    EXPECT_GT(resource.num_allocations.load(), num_allocations);
+
+    while (num_executed.load() < num_tasks) {
+      system.update_from_main();
+    }
+
+    for (int tries = 0; tries < 1000 && num_executed.load() < num_tasks + 1; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(num_executed.load(), num_tasks + 1);
+  }
+
+  EXPECT_EQ(resource.num_allocated.load(), 0);
+}
+
+TEST(execution_system, worker_data_uses_memory_resource) {
+  using namespace async_coro;
+
+  mem_hook::counting_resource resource;
+
+  {
+    execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                             .main_thread_allowed_tasks = execution_queues::main,
+                             .memory_resource = &resource}};
+
+    struct thread_data {
+      int value = 0;
+    };
+
+    std::atomic_int num_data_allocations{-1};
+    system.plan_execution(
+        [&](const executor_data& data) {
+          const auto before = resource.num_allocations.load();
+          data.get_data<thread_data>().value = 1;
+          num_data_allocations = resource.num_allocations.load() - before;
+        },
+        execution_queues::worker);
+
+    for (int tries = 0; tries < 1000 && num_data_allocations.load() < 0; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_GT(num_data_allocations.load(), 0);
+  }
+
+  EXPECT_EQ(resource.num_allocated.load(), 0);
+}
+
+TEST(execution_system, work_stealing) {
+  using namespace async_coro;
+
+  constexpr int num_children = 1000;
+
+  execution_system system{{.worker_configs = {{"worker1", execution_queues::worker},
+                                              {"worker2", execution_queues::worker},
+                                              {"worker3", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .work_stealing = true,
+                           .local_queue_capacity = 64}};
+
+  std::atomic_int num_executed{0};
+  std::mutex threads_mutex;
+  std::vector<std::thread::id> threads;
+
+  // root task is planned from main thread to shared queue, children are planned from the worker to its local deque
+  system.plan_execution(
+      [&](auto&) {
+        for (int i = 0; i < num_children; ++i) {
+          system.plan_execution(
+              [&](auto&) {
+                {
+                  std::unique_lock lock{threads_mutex};
+                  if (std::ranges::find(threads, std::this_thread::get_id()) == threads.end()) {
+                    threads.push_back(std::this_thread::get_id());
+                  }
+                }
+                num_executed++;
+              },
+              execution_queues::worker);
+        }
+      },
+      execution_queues::worker);
+
+  for (int tries = 0; tries < 1000 && num_executed.load() < num_children; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_EQ(num_executed.load(), num_children);
+
+  std::unique_lock lock{threads_mutex};
+  EXPECT_FALSE(threads.empty());
+  EXPECT_EQ(std::ranges::find(threads, std::this_thread::get_id()), threads.end());
+}
+
+TEST(execution_system, work_stealing_main_queue_from_worker) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker1", execution_queues::worker},
+                                              {"worker2", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .work_stealing = true}};
+
+  std::atomic_bool executed{false};
+  const auto main_thread_id = std::this_thread::get_id();
+
+  // worker doesn't fit main queue so the task should go to the shared queue
+  system.plan_execution(
+      [&](auto&) {
+        system.plan_execution(
+            [&](auto&) {
+              EXPECT_EQ(std::this_thread::get_id(), main_thread_id);
+              executed = true;
+            },
+            execution_queues::main);
+      },
+      execution_queues::worker);
+
+  for (int tries = 0; tries < 1000 && !executed; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    system.update_from_main();
+  }
+
+  EXPECT_TRUE(executed);
+}
+
+TEST(execution_system, lifo_slot_runs_latest_task_first) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .lifo_slot = true}};
+
+  std::mutex order_mutex;
+  std::vector<int> order;
+  std::atomic_int num_executed{0};
+
+  auto make_task = [&](int index) {
+    return [&, index](auto&) {
+      {
+        std::unique_lock lock{order_mutex};
+        order.push_back(index);
+      }
+      num_executed++;
+    };
+  };
+
+  system.plan_execution(
+      [&](auto&) {
+        system.plan_execution(make_task(1), execution_queues::worker);
+        system.plan_execution(make_task(2), execution_queues::worker);
+      },
+      execution_queues::worker);
+
+  for (int tries = 0; tries < 1000 && num_executed.load() < 2; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  std::unique_lock lock{order_mutex};
+  EXPECT_EQ(order, (std::vector<int>{2, 1}));
+}
+
+TEST(execution_system, lifo_slot_ping_pong_does_not_starve_queue) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .lifo_slot = true,
+                           .max_lifo_slot_hits = 2}};
+
+  std::atomic_bool is_external_executed{false};
+  std::atomic_bool is_chain_finished{false};
+
+  // every task of the chain plans the next one to the LIFO slot until the external task is executed
+  struct chain {
+    execution_system& system;
+    std::atomic_bool& stop;
+    std::atomic_bool& finished;
+
+    void operator()(const executor_data& /*data*/) const {
+      if (stop.load()) {
+        finished = true;
+        return;
+      }
+      system.plan_execution(chain{*this}, execution_queues::worker);
+    }
+  };
+
+  system.plan_execution(
+      [&](auto&) {
+        system.plan_execution(chain{system, is_external_executed, is_chain_finished}, execution_queues::worker);
+      },
+      execution_queues::worker);
+  system.plan_execution([&](auto&) { is_external_executed = true; }, execution_queues::worker);
+
+  for (int tries = 0; tries < 1000 && !is_chain_finished.load(); ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_TRUE(is_external_executed.load());
+  EXPECT_TRUE(is_chain_finished.load());
+}
+
+TEST(execution_system, lifo_slot_with_work_stealing) {
+  using namespace async_coro;
+
+  constexpr int num_tasks = 1000;
+
+  execution_system system{{.worker_configs = {{"worker1", execution_queues::worker},
+                                              {"worker2", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .work_stealing = true,
+                           .lifo_slot = true}};
+
+  std::atomic_int num_executed{0};
+
+  system.plan_execution(
+      [&](auto&) {
+        for (int i = 0; i < num_tasks; ++i) {
+          system.plan_execution([&](auto&) { num_executed++; }, execution_queues::worker);
+        }
+      },
+      execution_queues::worker);
+
+  for (int tries = 0; tries < 1000 && num_executed.load() < num_tasks; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+}
+
+TEST(execution_system, lifo_slot_task_is_stolen_while_worker_is_busy) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker1", execution_queues::worker},
+                                              {"worker2", execution_queues::worker},
+                                              {"worker3", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .work_stealing = true,
+                           .lifo_slot = true}};
+
+  std::atomic_bool is_last_executed{false};
+  std::atomic_int num_timeouts{0};
+  std::atomic_int num_executed{0};
+
+  const auto wait_last = [&] {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+    while (!is_last_executed.load() && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    if (!is_last_executed.load()) {
+      num_timeouts++;
+    }
+    num_executed++;
+  };
+
+  // first blocker goes to the deque and second one to the slot. Second blocker fills the empty slot with the last task
+  // while its worker still has the first blocker in the deque, so the last task can only be executed by the third worker
+  system.plan_execution(
+      [&](auto&) {
+        system.plan_execution([&](auto&) { wait_last(); }, execution_queues::worker);
+        system.plan_execution(
+            [&](auto&) {
+              system.plan_execution([&](auto&) { is_last_executed = true; }, execution_queues::worker);
+              wait_last();
+            },
+            execution_queues::worker);
+      },
+      execution_queues::worker);
+
+  for (int tries = 0; tries < 3000 && num_executed.load() < 2; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_EQ(num_executed.load(), 2);
+  EXPECT_TRUE(is_last_executed.load());
+  EXPECT_EQ(num_timeouts.load(), 0);
+}
+
+TEST(execution_system, plan_execution_after_with_slack) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .default_timer_slack = std::chrono::milliseconds{20}}};
+
+  constexpr int num_tasks = 50;
+
+  std::atomic_int num_executed{0};
+  std::atomic_int num_early{0};
+
+  const auto now = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_tasks; ++i) {
+    const auto when = now + std::chrono::milliseconds{10 + (i % 10)};
+    auto task = [&, when](auto&) {
+      if (std::chrono::steady_clock::now() < when) {
+        num_early++;
+      }
+      num_executed++;
+    };
+
+    // half of tasks use explicit slack, others use default one from config
+    if (i % 2 == 0) {
+      system.plan_execution_after(task, execution_queues::worker, when, timer_slack{std::chrono::milliseconds{30}});
+    } else {
+      system.plan_execution_after(task, execution_queues::worker, when);
+    }
+  }
+
+  for (int tries = 0; tries < 1000 && num_executed.load() < num_tasks; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+  EXPECT_EQ(num_early.load(), 0);
+}
+
+TEST(execution_system, worker_timers) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker1", execution_queues::worker}, {"worker2", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .worker_timers = true}};
+
+  std::vector<int> order;
+  std::mutex order_m;
+  std::atomic_int num_early{0};
+  std::atomic_bool main_executed{false};
+
+  const auto main_thread_id = std::this_thread::get_id();
+  const auto now = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < 5; ++i) {
+    const auto when = now + std::chrono::milliseconds{60 - (10 * i)};
+    system.plan_execution_after(
+        [&, i, when](auto&) {
+          EXPECT_NE(std::this_thread::get_id(), main_thread_id);
+          if (std::chrono::steady_clock::now() < when) {
+            num_early++;
+          }
+          std::scoped_lock lock(order_m);
+          order.push_back(i);
+        },
+        execution_queues::worker, when);
+  }
+
+  // queue without workers gets its tasks from one of the workers
+  system.plan_execution_after(
+      [&](auto&) {
+        EXPECT_EQ(std::this_thread::get_id(), main_thread_id);
+        main_executed = true;
+      },
+      execution_queues::main, now + std::chrono::milliseconds{30});
+
+  // cancelled tasks are never executed
+  const auto task_id = system.plan_execution_after([](auto&) { FAIL(); }, execution_queues::worker, now + std::chrono::milliseconds{40});
+  EXPECT_TRUE(system.cancel_execution(task_id));
+  EXPECT_FALSE(system.cancel_execution(task_id));
+
+  for (int tries = 0; tries < 300 && !main_executed.load(); ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    system.update_from_main();
+  }
+  EXPECT_TRUE(main_executed.load());
+
+  std::unique_lock lock(order_m);
+  for (int tries = 0; tries < 300 && order.size() < 5; ++tries) {
+    lock.unlock();
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    lock.lock();
+  }
+
+  ASSERT_EQ(order.size(), 5u);
+  EXPECT_EQ(num_early.load(), 0);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(order[i], 4 - i);  // reverse order because of time points
+  }
+}
+
+TEST(execution_system, worker_timers_planned_from_worker) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .worker_timers = true}};
+
+  constexpr int num_steps = 10;
+  std::atomic_int num_executed{0};
+
+  // every task plans the next one after a delay, like a coroutine sleeping in a loop
+  std::function<void(const executor_data&)> step = [&](const executor_data&) {
+    if (++num_executed < num_steps) {
+      system.plan_execution_after([&](const auto& data) { step(data); }, execution_queues::worker,
+                                  std::chrono::steady_clock::now() + std::chrono::milliseconds{2});
+    }
+  };
+
+  system.plan_execution_after([&](const auto& data) { step(data); }, execution_queues::worker,
+                              std::chrono::steady_clock::now() + std::chrono::milliseconds{2});
+
+  for (int tries = 0; tries < 500 && num_executed.load() < num_steps; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_EQ(num_executed.load(), num_steps);
+}
+
+TEST(execution_system, worker_timers_sleeper_woken_by_task) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .worker_timers = true}};
+
+  // worker sleeps until this far deadline
+  const auto timer_id = system.plan_execution_after([](auto&) { FAIL(); }, execution_queues::worker,
+                                                    std::chrono::steady_clock::now() + std::chrono::seconds{10});
+  std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+  std::atomic_bool executed{false};
+  const auto start = std::chrono::steady_clock::now();
+  system.plan_execution([&](auto&) { executed = true; }, execution_queues::worker);
+
+  for (int tries = 0; tries < 1000 && !executed.load(); ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_TRUE(executed.load());
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{500});
+  EXPECT_TRUE(system.cancel_execution(timer_id));
+}
+
+TEST(execution_system, plan_periodic) {
+  using namespace async_coro;
+
+  for (const bool worker_timers : {false, true}) {
+    execution_system system{{.worker_configs = {{"worker1", execution_queues::worker}, {"worker2", execution_queues::worker}},
+                             .main_thread_allowed_tasks = execution_queues::main,
+                             .worker_timers = worker_timers}};
+
+    constexpr auto period = std::chrono::milliseconds{5};
+
+    std::atomic_int num_executed{0};
+    std::atomic_int num_running{0};
+    std::atomic_int num_overlaps{0};
+
+    const auto first_time = std::chrono::steady_clock::now() + period;
+    const auto task_id = system.plan_periodic(
+        [&](auto&) {
+          if (num_running.fetch_add(1) != 0) {
+            num_overlaps++;
+          }
+          std::this_thread::sleep_for(std::chrono::microseconds{100});
+          num_executed++;
+          num_running.fetch_sub(1);
+        },
+        execution_queues::worker, first_time, period, missed_tick_policy::skip);
+
+    EXPECT_NE(task_id, delayed_task_id{});
+
+    for (int tries = 0; tries < 1000 && num_executed.load() < 5; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    // ticks are never executed before their time points
+    EXPECT_GE(num_executed.load(), 5);
+    EXPECT_GE(std::chrono::steady_clock::now(), first_time + (period * 4));
+
+    EXPECT_TRUE(system.cancel_execution(task_id));
+    EXPECT_FALSE(system.cancel_execution(task_id));
+
+    // execution that was already planned can still happen
+    std::this_thread::sleep_for(period * 2);
+    const auto num_after_cancel = num_executed.load();
+    std::this_thread::sleep_for(period * 4);
+
+    EXPECT_EQ(num_executed.load(), num_after_cancel);
+    EXPECT_EQ(num_overlaps.load(), 0);
+  }
+}
+
+TEST(execution_system, plan_periodic_missed_tick_policy) {
+  using namespace async_coro;
+
+  constexpr auto period = std::chrono::milliseconds{2};
+  constexpr int num_periods = 30;
+
+  const auto count_ticks = [&](missed_tick_policy policy) {
+    execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                             .main_thread_allowed_tasks = execution_queues::main}};
+
+    std::atomic_int num_executed{0};
+
+    const auto first_time = std::chrono::steady_clock::now() + period;
+    const auto task_id = system.plan_periodic(
+        [&](auto&) {
+          // the first execution is longer than many periods
+          if (num_executed++ == 0) {
+            std::this_thread::sleep_for(period * (num_periods / 2));
+          }
+        },
+        execution_queues::worker, first_time, period, policy);
+
+    std::this_thread::sleep_until(first_time + (period * num_periods));
+    system.cancel_execution(task_id);
+
+    return num_executed.load();
+  };
+
+  const auto num_skip = count_ticks(missed_tick_policy::skip);
+  const auto num_burst = count_ticks(missed_tick_policy::burst);
+
+  // burst executes ticks that were missed during the long execution, skip drops them
+  EXPECT_LT(num_skip, num_periods - 5);
+  EXPECT_GT(num_burst, num_skip);
+  EXPECT_LE(num_burst, num_periods + 1);
+}
+
+TEST(execution_system, high_resolution_timers) {
+  using namespace async_coro;
+
+  for (const auto spin : {std::chrono::microseconds{0}, std::chrono::microseconds{20}}) {
+    execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                             .main_thread_allowed_tasks = execution_queues::main,
+                             .timer_resolution = std::chrono::microseconds{10},
+                             .high_resolution_timers = true,
+                             .timer_spin_duration = spin}};
+
+    constexpr int num_tasks = 50;
+
+    std::atomic_int num_executed{0};
+    std::atomic_int num_early{0};
+
+    const auto now = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_tasks; ++i) {
+      const auto when = now + std::chrono::microseconds{100 * (num_tasks - i)};
+      system.plan_execution_after(
+          [&, when](auto&) {
+            if (std::chrono::steady_clock::now() < when) {
+              num_early++;
+            }
+            num_executed++;
+          },
+          execution_queues::worker, when);
+    }
+
+    // cancelled tasks are never executed
+    const auto task_id = system.plan_execution_after([](auto&) { FAIL(); }, execution_queues::worker, now + std::chrono::milliseconds{1});
+    EXPECT_TRUE(system.cancel_execution(task_id));
+
+    // task far in future doesn't block destruction of the system
+    system.plan_execution_after([](auto&) {}, execution_queues::worker, now + std::chrono::hours{1});
+
+    for (int tries = 0; tries < 1000 && num_executed.load() < num_tasks; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    EXPECT_EQ(num_executed.load(), num_tasks);
+    EXPECT_EQ(num_early.load(), 0);
+  }
+}
+
+TEST(execution_system, high_resolution_timer_spin_sees_earlier_deadline) {
+  using namespace async_coro;
+
+  // timer thread spins the whole wait for the late task
+  execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                           .main_thread_allowed_tasks = execution_queues::main,
+                           .timer_resolution = std::chrono::microseconds{10},
+                           .high_resolution_timers = true,
+                           .timer_spin_duration = std::chrono::milliseconds{500}}};
+
+  std::atomic_bool is_executed{false};
+  std::atomic<std::chrono::steady_clock::time_point> executed_at{};
+
+  const auto now = std::chrono::steady_clock::now();
+  system.plan_execution_after([](auto&) {}, execution_queues::worker, now + std::chrono::milliseconds{400});
+
+  std::this_thread::sleep_for(std::chrono::milliseconds{20});
+  system.plan_execution_after(
+      [&](auto&) {
+        executed_at = std::chrono::steady_clock::now();
+        is_executed = true;
+      },
+      execution_queues::worker, now + std::chrono::milliseconds{40});
+
+  for (int tries = 0; tries < 1000 && !is_executed.load(); ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  ASSERT_TRUE(is_executed.load());
+  EXPECT_LT(executed_at.load() - now, std::chrono::milliseconds{300});
+}
+
+TEST(execution_system, is_thread_fits) {
+  using namespace async_coro;
+
+  execution_system system{{.worker_configs = {{"worker", execution_queues::worker}}, .main_thread_allowed_tasks = execution_queues::main}};
+  execution_system other_system{{.worker_configs = {{"other_worker", execution_queues::worker}}, .main_thread_allowed_tasks = execution_queues::main}};
+
+  EXPECT_TRUE(system.is_thread_fits(execution_queues::main, thread_index::current()));
+  EXPECT_FALSE(system.is_thread_fits(execution_queues::worker, thread_index::current()));
+
+  std::atomic_int num_checked{0};
+  thread_index worker_index;
+
+  system.plan_execution(
+      [&](const executor_data& data) {
+        worker_index = thread_index::current();
+        EXPECT_EQ(data.get_owning_thread(), worker_index);
+        EXPECT_TRUE(system.is_thread_fits(execution_queues::worker, worker_index));
+        EXPECT_FALSE(system.is_thread_fits(execution_queues::main, worker_index));
+        num_checked++;
+      },
+      execution_queues::worker);
+
+  // worker of another system doesn't fit
+  other_system.plan_execution(
+      [&](const executor_data& data) {
+        EXPECT_FALSE(system.is_thread_fits(execution_queues::worker, data.get_owning_thread()));
+        num_checked++;
+      },
+      execution_queues::worker);
+
+  for (int tries = 0; tries < 1000 && num_checked.load() < 2; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(num_checked.load(), 2);
+
+  // index of another thread is checked too
+  EXPECT_TRUE(system.is_thread_fits(execution_queues::worker, worker_index));
+
+  std::thread foreign{[&system]() {
+    EXPECT_FALSE(system.is_thread_fits(execution_queues::worker, thread_index::current()));
+    EXPECT_FALSE(system.is_thread_fits(execution_queues::main, thread_index::current()));
+  }};
+  foreign.join();
+}
+
+TEST(execution_system, wakeups_round_robin) {
+  using namespace async_coro;
+
+  std::vector<execution_thread_config> workers;
+  for (int i = 0; i < 4; i++) {
+    auto& config = workers.emplace_back("worker" + std::to_string(i), execution_queues::worker);
+    config.num_loops_before_sleep = 0;
+  }
+
+  execution_system system{{.worker_configs = std::move(workers), .main_thread_allowed_tasks = execution_queues::main}};
+
+  std::mutex threads_m;
+  std::set<std::thread::id> threads;
+
+  // tasks planned one by one to sleeping workers are spread over all of them
+  for (int i = 0; i < 100; i++) {
+    std::atomic_bool executed{false};
+    system.plan_execution(
+        [&](auto&) {
+          {
+            std::scoped_lock lock{threads_m};
+            threads.insert(std::this_thread::get_id());
+          }
+          executed = true;
+        },
+        execution_queues::worker);
+
+    while (!executed.load()) {
+      std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds{200});
+  }
+
+  std::scoped_lock lock{threads_m};
+  EXPECT_EQ(threads.size(), 4);
+  EXPECT_GT(system.get_stats().num_wakeups, 0);
+}
+
+TEST(execution_system, searching_worker_skips_wakeups) {
+  using namespace async_coro;
+
+  execution_thread_config worker{"worker", execution_queues::worker};
+  worker.num_loops_before_sleep = 100000000;  // NOLINT(*-magic-*)
+
+  execution_system system{{.worker_configs = {worker}, .main_thread_allowed_tasks = execution_queues::main}};
+
+  // let the worker become idle and search for tasks
+  std::this_thread::sleep_for(std::chrono::milliseconds{5});
+
+  constexpr int num_tasks = 10;
+  std::atomic_int num_executed{0};
+  for (int i = 0; i < num_tasks; i++) {
+    system.plan_execution([&](auto&) { num_executed++; }, execution_queues::worker);
+  }
+
+  for (int tries = 0; tries < 1000 && num_executed.load() < num_tasks; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+
+  const auto stats = system.get_stats();
+  EXPECT_GT(stats.num_skipped_wakeups, 0);
+  EXPECT_EQ(stats.num_wakeups, 0);
+}
+
+namespace {
+constexpr auto burst_task_duration = std::chrono::milliseconds{100};
+
+// plans tasks one by one and returns time until all of them are executed
+std::chrono::steady_clock::duration run_burst(async_coro::execution_system& system, int num_tasks) {
+  std::atomic_int num_executed{0};
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_tasks; i++) {
+    // every task is planned separately, so each of them sees searching workers
+    system.plan_execution(
+        [&](auto&) {
+          std::this_thread::sleep_for(burst_task_duration);
+          num_executed++;
+        },
+        async_coro::execution_queues::worker);
+  }
+
+  while (num_executed.load() < num_tasks && std::chrono::steady_clock::now() - start < std::chrono::seconds{2}) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  const auto duration = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+  return duration;
+}
+}  // namespace
+
+TEST(execution_system, searching_worker_passes_skipped_wakeups) {
+  using namespace async_coro;
+
+  execution_thread_config searcher{"searcher", execution_queues::worker};
+  searcher.num_loops_before_sleep = 100000000;  // NOLINT(*-magic-*)
+
+  execution_thread_config sleeper{"sleeper", execution_queues::worker};
+  sleeper.num_loops_before_sleep = 0;
+
+  {
+    execution_system system{{.worker_configs = {searcher, sleeper, sleeper, sleeper}, .main_thread_allowed_tasks = execution_queues::main}};
+
+    // let the sleepers park and the searcher search for tasks
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+    // tasks run on all workers at once
+    EXPECT_LT(run_burst(system, 4), burst_task_duration * 3 / 2);
+  }
+
+  {
+    // task stolen by a searching worker doesn't hold back wakeups
+    execution_system system{{.worker_configs = {searcher, sleeper, sleeper, sleeper, sleeper},
+                             .main_thread_allowed_tasks = execution_queues::main,
+                             .work_stealing = true}};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+    std::atomic_bool is_stolen{false};
+    system.plan_execution(
+        [&](auto&) {
+          // the task is pushed to the local deque of the searcher and a woken peer steals it
+          system.plan_execution(
+              [&](auto&) {
+                is_stolen = true;
+                std::this_thread::sleep_for(burst_task_duration);
+              },
+              execution_queues::worker);
+
+          while (!is_stolen.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+          }
+          std::this_thread::sleep_for(burst_task_duration);
+        },
+        execution_queues::worker);
+
+    while (!is_stolen.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    EXPECT_LT(run_burst(system, 3), burst_task_duration * 3 / 2);
+  }
+
+  {
+    // timer task of a woken worker doesn't hold back wakeups
+    execution_system system{{.worker_configs = {sleeper, sleeper, sleeper, sleeper},
+                             .main_thread_allowed_tasks = execution_queues::main,
+                             .worker_timers = true}};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+    std::atomic_bool is_started{false};
+    system.plan_execution_after(
+        [&](auto&) {
+          is_started = true;
+          std::this_thread::sleep_for(burst_task_duration);
+        },
+        execution_queues::worker, std::chrono::steady_clock::now() + std::chrono::milliseconds{10});
+
+    while (!is_started.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    EXPECT_LT(run_burst(system, 3), burst_task_duration * 3 / 2);
+  }
+}
+
+TEST(execution_system, idle_policy_stats) {
+  using namespace async_coro;
+
+  for (const auto policy : {worker_idle_policy::fixed_loops, worker_idle_policy::adaptive}) {
+    execution_thread_config worker{"worker", execution_queues::worker};
+    worker.idle_policy = policy;
+    worker.min_spin_duration = std::chrono::microseconds{2};
+    worker.max_spin_duration = std::chrono::microseconds{50};
+
+    execution_system system{{.worker_configs = {worker}, .main_thread_allowed_tasks = execution_queues::main}};
+
+    constexpr int num_tasks = 50;
+    std::atomic_int num_executed{0};
+    for (int i = 0; i < num_tasks; i++) {
+      system.plan_execution([&](auto&) { num_executed++; }, execution_queues::worker);
+
+      // worker parks between tasks
+      std::this_thread::sleep_for(std::chrono::microseconds{500});
+    }
+
+    for (int tries = 0; tries < 1000 && num_executed.load() < num_tasks; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(num_executed.load(), num_tasks);
+
+    const auto stats = system.get_worker_stats(0);
+    EXPECT_GT(stats.num_parks, 0);
+    EXPECT_GT(stats.park_time, std::chrono::nanoseconds::zero());
+    EXPECT_GT(stats.spin_time, std::chrono::nanoseconds::zero());
+
+    if (policy == worker_idle_policy::adaptive) {
+      EXPECT_GE(stats.spin_budget, std::chrono::microseconds{2});
+      EXPECT_LE(stats.spin_budget, std::chrono::microseconds{50});
+      // idle periods are much longer than wakeup latency, so spinning time is small
+      EXPECT_LT(stats.spin_time, stats.park_time);
+    } else {
+      EXPECT_EQ(stats.spin_budget, std::chrono::nanoseconds::zero());
+    }
+  }
+}
+
+TEST(execution_system, worker_group_scales) {
+  using namespace async_coro;
+
+  execution_system system{{
+      .worker_configs = {},
+      .main_thread_allowed_tasks = execution_queues::main,
+      .worker_groups = {{.worker = {"elastic", execution_queues::worker},
+                         .min_workers = 1,
+                         .max_workers = 3,
+                         .spawn_delay = std::chrono::milliseconds{1},
+                         .idle_timeout = std::chrono::milliseconds{20}}},
+  }};
+
+  EXPECT_EQ(system.get_num_worker_threads(), 3);
+  EXPECT_EQ(system.get_num_running_workers(), 1);
+
+  // blocked tasks keep the queue non empty until all threads of the group are started
+  constexpr int num_tasks = 3;
+  std::atomic_bool is_released{false};
+  std::atomic_int num_started{0};
+  for (int i = 0; i < num_tasks; i++) {
+    system.plan_execution(
+        [&](auto&) {
+          num_started++;
+          while (!is_released.load()) {
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+          }
+        },
+        execution_queues::worker);
+  }
+
+  for (int tries = 0; tries < 1000 && num_started.load() < num_tasks; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(num_started.load(), num_tasks);
+  EXPECT_EQ(system.get_num_running_workers(), 3);
+
+  is_released = true;
+
+  // threads above min_workers exit after idle_timeout
+  for (int tries = 0; tries < 2000 && system.get_num_running_workers() > 1; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(system.get_num_running_workers(), 1);
+
+  // retired slots are reused
+  std::atomic_int num_executed{0};
+  system.plan_execution([&](auto&) { num_executed++; }, execution_queues::worker);
+  for (int tries = 0; tries < 1000 && num_executed.load() < 1; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(num_executed.load(), 1);
+}
+
+TEST(execution_system, worker_group_starts_from_zero) {
+  using namespace async_coro;
+
+  execution_system system{{
+      .worker_configs = {},
+      .main_thread_allowed_tasks = execution_queues::main,
+      .worker_groups = {{.worker = {"on_demand", execution_queues::worker},
+                         .min_workers = 0,
+                         .max_workers = 2,
+                         .spawn_delay = std::chrono::milliseconds{1},
+                         .idle_timeout = std::chrono::milliseconds{10}}},
+  }};
+
+  EXPECT_EQ(system.get_num_running_workers(), 0);
+
+  for (int round = 0; round < 3; round++) {
+    // the first task starts a thread without waiting for spawn_delay
+    std::atomic_int num_executed{0};
+    thread_index executor;
+    system.plan_execution(
+        [&](auto& data) {
+          executor = data.get_owning_thread();
+          num_executed++;
+        },
+        execution_queues::worker);
+
+    for (int tries = 0; tries < 1000 && num_executed.load() < 1; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(num_executed.load(), 1);
+    EXPECT_NE(executor, thread_index::current());
+
+    for (int tries = 0; tries < 2000 && system.get_num_running_workers() != 0; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    EXPECT_EQ(system.get_num_running_workers(), 0);
+  }
+}
+
+#if defined(__linux__)
+TEST(execution_system, scheduling_errors_are_reported) {
+  using namespace async_coro;
+
+  execution_thread_config worker{"pinned", execution_queues::worker};
+  // no machine has so many cpus, thread keeps running without affinity
+  worker.scheduling.cpu_set = {1U << 20U};
+
+  execution_system system{{
+      .worker_configs = {worker},
+      .main_thread_allowed_tasks = execution_queues::main,
+      .timer_thread_scheduling = {.nice_value = 1},
+  }};
+
+  std::atomic_int num_executed{0};
+  system.plan_execution([&](auto&) { num_executed++; }, execution_queues::worker);
+  for (int tries = 0; tries < 1000 && num_executed.load() < 1; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(num_executed.load(), 1);
+
+  const auto errors = system.get_scheduling_errors();
+  ASSERT_EQ(errors.size(), 1);
+  EXPECT_EQ(errors[0].thread_name, "pinned");
+  EXPECT_EQ(errors[0].setting, "cpu_set");
+  EXPECT_NE(errors[0].error_code, 0);
+}
+#endif
+
+TEST(execution_system, numa_queue_wakes_local_workers) {
+  using namespace async_coro;
+
+  const numa_topology topology{{{.id = 0, .cpus = {0}}, {.id = 1, .cpus = {0}}}};
+
+  execution_system system{{
+      .worker_configs = make_numa_worker_configs(topology, 1, execution_queues::worker),
+      .main_thread_allowed_tasks = execution_queues::main,
+      .topology = topology,
+      .queue_configs = {{.queue = execution_queues::worker, .type = execution_queue_type::numa}},
+  }};
+
+  ASSERT_EQ(system.get_num_worker_threads(), 2);
+  EXPECT_EQ(system.get_numa_topology().get_num_nodes(), 2);
+
+  // tasks are planned as from a thread of node 1
+  numa_topology::set_current_thread_node(1);
+
+  constexpr int num_tasks = 10;
+  std::vector<std::uint32_t> nodes(num_tasks, numa_topology::no_node);
+  std::atomic_int num_executed{0};
+  for (int i = 0; i < num_tasks; i++) {
+    // both workers park, so only the woken one takes the task
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+
+    system.plan_execution(
+        [&, i](auto&) {
+          nodes[i] = numa_topology::get_current_thread_node();
+          num_executed++;
+        },
+        execution_queues::worker);
+
+    for (int tries = 0; tries < 1000 && num_executed.load() <= i; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+  }
+
+  numa_topology::set_current_thread_node(numa_topology::no_node);
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+  EXPECT_EQ(nodes, std::vector<std::uint32_t>(num_tasks, 1));
+}
+
+TEST(execution_system, numa_queue_rotates_local_wakeups) {
+  using namespace async_coro;
+
+  const numa_topology topology{{{.id = 0, .cpus = {0}}, {.id = 1, .cpus = {0}}}};
+
+  execution_system system{{
+      .worker_configs = make_numa_worker_configs(topology, 2, execution_queues::worker),
+      .main_thread_allowed_tasks = execution_queues::main,
+      .topology = topology,
+      .queue_configs = {{.queue = execution_queues::worker, .type = execution_queue_type::numa}},
+  }};
+
+  ASSERT_EQ(system.get_num_worker_threads(), 4);
+
+  numa_topology::set_current_thread_node(1);
+
+  constexpr int num_tasks = 6;
+  std::vector<std::thread::id> threads(num_tasks);
+  std::atomic_int num_executed{0};
+  for (int i = 0; i < num_tasks; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+
+    system.plan_execution(
+        [&, i](auto&) {
+          threads[i] = std::this_thread::get_id();
+          num_executed++;
+        },
+        execution_queues::worker);
+
+    for (int tries = 0; tries < 1000 && num_executed.load() <= i; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+  }
+
+  numa_topology::set_current_thread_node(numa_topology::no_node);
+
+  ASSERT_EQ(num_executed.load(), num_tasks);
+  // both workers of the node take turns instead of the first one getting every wakeup
+  std::ranges::sort(threads);
+  const auto unique_end = std::ranges::unique(threads).begin();
+  EXPECT_EQ(unique_end - threads.begin(), 2);
+}
+
+TEST(execution_system, blocking_pool_is_elastic) {
+  using namespace async_coro;
+
+  execution_system system{{
+      .worker_configs = {{"worker1"}},
+      .blocking_pool = {.max_threads = 2, .idle_timeout = std::chrono::milliseconds{20}},
+  }};
+
+  EXPECT_EQ(system.get_num_blocking_threads(), 0);
+
+  constexpr int num_tasks = 3;
+  std::atomic_int num_blocked{0};
+  std::atomic_int num_executed{0};
+  std::atomic_bool release{false};
+  std::atomic_bool fits_worker_queue{false};
+
+  for (int i = 0; i < num_tasks; i++) {
+    system.plan_blocking([&](const executor_data& data) {
+      if (system.is_thread_fits(execution_queues::worker, data.get_owning_thread())) {
+        fits_worker_queue = true;
+      }
+      num_blocked++;
+      while (!release.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+      num_executed++;
+    });
+  }
+
+  // third task waits for a pool thread
+  for (int tries = 0; tries < 1000 && num_blocked.load() < 2; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds{5});
+  EXPECT_EQ(num_blocked.load(), 2);
+  EXPECT_EQ(system.get_num_blocking_threads(), 2);
+  EXPECT_EQ(system.get_num_worker_threads(), 1);
+  EXPECT_EQ(system.get_num_running_workers(), 1);
+
+  release = true;
+  for (int tries = 0; tries < 1000 && num_executed.load() < num_tasks; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(num_executed.load(), num_tasks);
+  EXPECT_FALSE(fits_worker_queue.load());
+
+  // idle threads exit
+  for (int tries = 0; tries < 1000 && system.get_num_blocking_threads() > 0; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  EXPECT_EQ(system.get_num_blocking_threads(), 0);
+}
+
+TEST(execution_system, blocking_pool_turned_off_uses_workers) {
+  using namespace async_coro;
+
+  execution_system system{{
+      .worker_configs = {{"worker1"}},
+      .blocking_pool = {.max_threads = 0},
+  }};
+
+  std::atomic_bool is_executed{false};
+  std::atomic_bool fits_worker_queue{false};
+
+  system.plan_blocking([&](const executor_data& data) {
+    fits_worker_queue = system.is_thread_fits(execution_queues::worker, data.get_owning_thread());
+    is_executed = true;
+  });
+
+  for (int tries = 0; tries < 1000 && !is_executed.load(); ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  EXPECT_TRUE(is_executed.load());
+  EXPECT_TRUE(fits_worker_queue.load());
+  EXPECT_EQ(system.get_num_blocking_threads(), 0);
+}
+
+TEST(execution_system, blocking_pool_executes_pending_tasks_on_stop) {
+  using namespace async_coro;
+
+  constexpr int num_tasks = 4;
+  std::atomic_int num_executed{0};
+
+  {
+    execution_system system{{
+        .worker_configs = {{"worker1"}},
+        .blocking_pool = {.max_threads = 1},
+    }};
+
+    // all tasks but the first one are pending when the system is destroyed
+    for (int i = 0; i < num_tasks; i++) {
+      system.plan_blocking([&](auto&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        num_executed++;
+      });
+    }
+  }
+
+  EXPECT_EQ(num_executed.load(), num_tasks);
+}
+
+TEST(execution_system, weighted_queues_share_worker) {
+  using namespace async_coro;
+
+  execution_system system{{
+      .worker_configs = {{"worker1", execution_queues::worker | execution_queues::any}},
+      .main_thread_allowed_tasks = execution_queues::main,
+      .queue_configs = {{.queue = execution_queues::worker, .weight = 3},
+                        {.queue = execution_queues::any, .weight = 1}},
+  }};
+
+  std::atomic_bool release{false};
+  std::atomic_bool is_blocked{false};
+
+  // worker is held so both queues are saturated when it starts to serve them
+  system.plan_execution(
+      [&](auto&) {
+        is_blocked = true;
+        while (!release.load()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+      },
+      execution_queues::worker);
+
+  for (int tries = 0; tries < 1000 && !is_blocked.load(); ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_TRUE(is_blocked.load());
+
+  constexpr int num_tasks = 40;
+  std::vector<execution_queue_mark> order;
+  order.reserve(num_tasks * 2);
+  std::atomic_int num_executed{0};
+
+  for (int i = 0; i < num_tasks; i++) {
+    for (auto queue : {execution_queues::worker, execution_queues::any}) {
+      system.plan_execution(
+          [&, queue](auto&) {
+            order.push_back(queue);
+            num_executed++;
+          },
+          queue);
+    }
+  }
+
+  release = true;
+  for (int tries = 0; tries < 1000 && num_executed.load() < num_tasks * 2; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_EQ(num_executed.load(), num_tasks * 2);
+
+  // while both queues have tasks the worker takes 3 tasks of the worker queue per task of the any queue
+  const auto num_worker_tasks = std::count(order.begin(), order.begin() + num_tasks, execution_queues::worker);
+  EXPECT_NEAR(num_worker_tasks, num_tasks * 3 / 4, 2);
+
+  EXPECT_EQ(system.get_num_served_tasks(execution_queues::worker), num_tasks + 1);
+  EXPECT_EQ(system.get_num_served_tasks(execution_queues::any), num_tasks);
+  EXPECT_EQ(system.get_num_served_tasks(execution_queues::main), 0);
+}
+
+TEST(execution_system, deadline_queue_runs_earliest_first) {
+  using namespace async_coro;
+
+  execution_system system{{
+      .worker_configs = {{"worker1", execution_queues::worker}},
+      .main_thread_allowed_tasks = execution_queues::main,
+      .queue_configs = {{.queue = execution_queues::worker, .type = execution_queue_type::deadline}},
+  }};
+
+  std::atomic_bool release{false};
+  std::atomic_bool is_blocked{false};
+
+  // worker is held so all tasks are in the queue when it takes the next one
+  system.plan_execution(
+      [&](auto&) {
+        is_blocked = true;
+        while (!release.load()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+      },
+      execution_queues::worker);
+
+  for (int tries = 0; tries < 1000 && !is_blocked.load(); ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  ASSERT_TRUE(is_blocked.load());
+
+  const auto now = std::chrono::steady_clock::now();
+  std::vector<int> order;
+  std::atomic_int num_executed{0};
+
+  const auto plan = [&](int id, task_deadline deadline) {
+    system.plan_execution(
+        [&, id](auto&) {
+          order.push_back(id);
+          num_executed++;
+        },
+        execution_queues::worker, deadline);
+  };
+
+  plan(5, task_deadline{});
+  plan(3, task_deadline{now + std::chrono::seconds{30}});
+  plan(1, task_deadline{now + std::chrono::seconds{10}});
+  plan(6, task_deadline{});
+  plan(2, task_deadline{now + std::chrono::seconds{20}});
+  plan(4, task_deadline{now + std::chrono::seconds{30}});
+
+  release = true;
+  for (int tries = 0; tries < 1000 && num_executed.load() < 6; ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  // tasks with equal deadlines and tasks without deadline keep FIFO order
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4, 5, 6}));
+  EXPECT_EQ(system.get_num_missed_deadlines(execution_queues::worker), 0);
+}
+
+TEST(execution_system, deadline_queue_missed_policies) {
+  using namespace async_coro;
+
+  for (const auto policy : {missed_deadline_policy::keep, missed_deadline_policy::demote, missed_deadline_policy::drop}) {
+    execution_system system{{
+        .worker_configs = {{"worker1", execution_queues::worker}},
+        .main_thread_allowed_tasks = execution_queues::main,
+        .queue_configs = {{.queue = execution_queues::worker, .type = execution_queue_type::deadline, .missed_deadline = policy}},
+    }};
+
+    std::atomic_bool release{false};
+    std::atomic_bool is_blocked{false};
+
+    system.plan_execution(
+        [&](auto&) {
+          is_blocked = true;
+          while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+          }
+        },
+        execution_queues::worker);
+
+    for (int tries = 0; tries < 1000 && !is_blocked.load(); ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    ASSERT_TRUE(is_blocked.load());
+
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<int> order;
+    std::atomic_int num_executed{0};
+
+    const auto plan = [&](int id, task_deadline deadline) {
+      system.plan_execution(
+          [&, id](auto&) {
+            order.push_back(id);
+            num_executed++;
+          },
+          execution_queues::worker, deadline);
+    };
+
+    plan(1, task_deadline{now - std::chrono::milliseconds{1}});
+    plan(2, task_deadline{now + std::chrono::seconds{10}});
+    plan(3, task_deadline{});
+    plan(4, task_deadline{.value = now - std::chrono::milliseconds{1}, .can_drop = false});
+
+    release = true;
+
+    const int num_expected = policy == missed_deadline_policy::drop ? 3 : 4;
+    for (int tries = 0; tries < 1000 && num_executed.load() < num_expected; ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+
+    if (policy == missed_deadline_policy::keep) {
+      EXPECT_EQ(order, (std::vector<int>{1, 4, 2, 3}));
+      EXPECT_EQ(system.get_num_missed_deadlines(execution_queues::worker), 0);
+    } else if (policy == missed_deadline_policy::demote) {
+      EXPECT_EQ(order, (std::vector<int>{2, 3, 1, 4}));
+      EXPECT_EQ(system.get_num_missed_deadlines(execution_queues::worker), 2);
+    } else {
+      // task that can't be dropped is executed as with keep policy
+      EXPECT_EQ(order, (std::vector<int>{4, 2, 3}));
+      EXPECT_EQ(system.get_num_missed_deadlines(execution_queues::worker), 2);
+    }
+  }
+}
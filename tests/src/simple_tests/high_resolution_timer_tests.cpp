@@ -0,0 +1,52 @@
+#include <async_coro/internal/high_resolution_timer.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+TEST(high_resolution_timer, waits_for_deadline) {
+  async_coro::internal::high_resolution_timer timer;
+  if (!timer.is_valid()) {
+    GTEST_SKIP() << "timerfd is not available";
+  }
+
+  async_coro::internal::high_resolution_timer::prepare_waiting_thread();
+
+  for (int i = 0; i < 10; i++) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds{200};
+    timer.set_deadline(deadline);
+    timer.wait();
+    EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+  }
+
+  // deadline in the past expires right away
+  timer.set_deadline(std::chrono::steady_clock::now() - std::chrono::seconds{1});
+  timer.wait();
+}
+
+TEST(high_resolution_timer, wake_interrupts_wait) {
+  async_coro::internal::high_resolution_timer timer;
+  if (!timer.is_valid()) {
+    GTEST_SKIP() << "timerfd is not available";
+  }
+
+  timer.set_deadline(std::chrono::steady_clock::time_point::max());
+
+  std::thread waker{[&timer]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    timer.wake();
+  }};
+
+  timer.wait();
+  waker.join();
+
+  // moving deadline earlier wakes the waiting thread too
+  timer.set_deadline(std::chrono::steady_clock::now() + std::chrono::hours{1});
+  waker = std::thread{[&timer]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    timer.set_deadline(std::chrono::steady_clock::now());
+  }};
+
+  timer.wait();
+  waker.join();
+}
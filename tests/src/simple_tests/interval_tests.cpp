@@ -0,0 +1,118 @@
+#include <async_coro/await/interval.h>
+#include <async_coro/execution_system.h>
+#include <async_coro/scheduler.h>
+#include <async_coro/task.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+TEST(interval_tests, ticks_on_absolute_time_points) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler;
+
+  constexpr auto period = 10ms;
+  constexpr int num_ticks = 10;
+
+  std::atomic<bool> done{false};
+  std::atomic<long long> elapsed_ms{0};
+
+  auto t = [&]() -> async_coro::task<> {
+    auto start = std::chrono::steady_clock::now();
+    async_coro::interval ticker{period};
+    for (int i = 0; i < num_ticks; i++) {
+      co_await ticker;
+
+      // time of the work should not shift next ticks
+      std::this_thread::sleep_for(3ms);
+    }
+    elapsed_ms.store(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order::relaxed);
+    done.store(true, std::memory_order::release);
+  };
+
+  auto h = scheduler.start_task(t());
+
+  for (int i = 0; i < 2000 && !done.load(std::memory_order::relaxed); ++i) {
+    std::this_thread::sleep_for(1ms);
+    scheduler.get_execution_system<async_coro::execution_system>().update_from_main();
+  }
+
+  ASSERT_TRUE(done.load(std::memory_order::acquire));
+  EXPECT_GE(elapsed_ms.load(std::memory_order::relaxed), period.count() * num_ticks);
+}
+
+TEST(interval_tests, skip_merges_missed_ticks) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler;
+
+  std::atomic<bool> done{false};
+  std::atomic<std::uint32_t> num_merged{0};
+
+  auto t = [&]() -> async_coro::task<> {
+    async_coro::interval ticker{5ms, async_coro::missed_tick_policy::skip};
+    co_await ticker;
+
+    // miss a few ticks
+    std::this_thread::sleep_for(30ms);
+    for (int i = 0; i < 10; i++) {
+      scheduler.get_execution_system<async_coro::execution_system>().update_from_main();
+    }
+
+    num_merged.store(co_await ticker, std::memory_order::relaxed);
+    done.store(true, std::memory_order::release);
+  };
+
+  auto h = scheduler.start_task(t());
+
+  for (int i = 0; i < 2000 && !done.load(std::memory_order::relaxed); ++i) {
+    std::this_thread::sleep_for(1ms);
+    scheduler.get_execution_system<async_coro::execution_system>().update_from_main();
+  }
+
+  ASSERT_TRUE(done.load(std::memory_order::acquire));
+  EXPECT_GE(num_merged.load(std::memory_order::relaxed), 1U);
+}
+
+TEST(interval_tests, burst_resumes_for_every_tick) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler{std::make_unique<async_coro::execution_system>(
+      async_coro::execution_system_config{.worker_configs = {{"worker1"}}})};
+
+  constexpr auto period = 5ms;
+  constexpr int num_ticks = 20;
+
+  std::atomic<bool> done{false};
+  std::atomic<std::uint32_t> total_ticks{0};
+  std::atomic<long long> elapsed_ms{0};
+
+  auto t = [&]() -> async_coro::task<> {
+    auto start = std::chrono::steady_clock::now();
+    async_coro::interval ticker{period, async_coro::execution_queues::worker, async_coro::missed_tick_policy::burst};
+    for (int i = 0; i < num_ticks; i++) {
+      total_ticks.fetch_add(co_await ticker, std::memory_order::relaxed);
+
+      if (i == 0) {
+        // following ticks should come one after another to catch up
+        std::this_thread::sleep_for(period * 5);
+      }
+    }
+    elapsed_ms.store(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order::relaxed);
+    done.store(true, std::memory_order::release);
+  };
+
+  auto h = scheduler.start_task(t());
+
+  for (int i = 0; i < 2000 && !done.load(std::memory_order::relaxed); ++i) {
+    std::this_thread::sleep_for(1ms);
+    scheduler.get_execution_system<async_coro::execution_system>().update_from_main();
+  }
+
+  ASSERT_TRUE(done.load(std::memory_order::acquire));
+  EXPECT_EQ(total_ticks.load(std::memory_order::relaxed), num_ticks);
+  EXPECT_GE(elapsed_ms.load(std::memory_order::relaxed), period.count() * num_ticks);
+}
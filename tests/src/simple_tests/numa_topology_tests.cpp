@@ -0,0 +1,105 @@
+#include <async_coro/internal/task_queue_storage.h>
+#include <async_coro/numa_topology.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void write_cpulist(const std::filesystem::path& node_dir, const std::string& list) {
+  std::filesystem::create_directories(node_dir);
+  std::ofstream{node_dir / "cpulist"} << list << "\n";
+}
+
+}  // namespace
+
+TEST(numa_topology, parse_cpu_list) {
+  std::vector<std::uint32_t> cpus;
+
+  EXPECT_TRUE(async_coro::numa_topology::parse_cpu_list("0-3,8,10-11\n", cpus));
+  EXPECT_EQ(cpus, (std::vector<std::uint32_t>{0, 1, 2, 3, 8, 10, 11}));
+
+  EXPECT_TRUE(async_coro::numa_topology::parse_cpu_list("", cpus));
+  EXPECT_TRUE(cpus.empty());
+
+  EXPECT_FALSE(async_coro::numa_topology::parse_cpu_list("3-1", cpus));
+  EXPECT_FALSE(async_coro::numa_topology::parse_cpu_list("1,x", cpus));
+  EXPECT_FALSE(async_coro::numa_topology::parse_cpu_list("1-", cpus));
+  EXPECT_FALSE(async_coro::numa_topology::parse_cpu_list("4294967290-4294967295", cpus));
+  EXPECT_FALSE(async_coro::numa_topology::parse_cpu_list("8192", cpus));
+  EXPECT_TRUE(async_coro::numa_topology::parse_cpu_list("8190-8191", cpus));
+  EXPECT_EQ(cpus, (std::vector<std::uint32_t>{8190, 8191}));
+}
+
+TEST(numa_topology, read_from_directory) {
+  const auto root = std::filesystem::temp_directory_path() / ("async_coro_numa_" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+  std::filesystem::remove_all(root);
+
+  write_cpulist(root / "node2", "4-5");
+  write_cpulist(root / "node0", "0-1,6");
+  // memory only node
+  write_cpulist(root / "node1", "");
+  std::filesystem::create_directories(root / "power");
+
+  const auto topology = async_coro::numa_topology::read_from(root.string());
+  std::filesystem::remove_all(root);
+
+  ASSERT_EQ(topology.get_num_nodes(), 2);
+  EXPECT_EQ(topology.get_nodes()[0].id, 0);
+  EXPECT_EQ(topology.get_nodes()[0].cpus, (std::vector<std::uint32_t>{0, 1, 6}));
+  EXPECT_EQ(topology.get_nodes()[1].id, 2);
+  EXPECT_EQ(topology.get_nodes()[1].cpus, (std::vector<std::uint32_t>{4, 5}));
+
+  EXPECT_EQ(topology.get_node_of_cpu(6), 0);
+  EXPECT_EQ(topology.get_node_of_cpu(5), 1);
+  // unknown cpus belong to the first node
+  EXPECT_EQ(topology.get_node_of_cpu(100), 0);
+}
+
+TEST(numa_topology, single_node_fallback) {
+  const auto topology = async_coro::numa_topology::read_from("/nonexistent/async_coro/node");
+
+  ASSERT_EQ(topology.get_num_nodes(), 1);
+  EXPECT_FALSE(topology.get_nodes()[0].cpus.empty());
+  EXPECT_EQ(topology.get_current_node(), 0);
+
+  // real machine always has at least one node
+  EXPECT_GE(async_coro::numa_topology::discover().get_num_nodes(), 1);
+}
+
+TEST(numa_topology, queue_prefers_local_node) {
+  const async_coro::numa_topology topology{{{.id = 0, .cpus = {0}}, {.id = 1, .cpus = {1}}}};
+
+  async_coro::internal::task_queue_storage<int> queue;
+  queue.make_numa(topology);
+
+  std::thread{[&] {
+    async_coro::numa_topology::set_current_thread_node(0);
+    queue.push(1);
+    queue.push(2);
+  }}.join();
+
+  std::thread{[&] {
+    async_coro::numa_topology::set_current_thread_node(1);
+    queue.push(3);
+  }}.join();
+
+  std::vector<int> popped;
+  std::thread{[&] {
+    async_coro::numa_topology::set_current_thread_node(1);
+    int val = 0;
+    while (queue.try_pop(val)) {
+      popped.push_back(val);
+    }
+  }}.join();
+
+  // values of the consumer node go first, other nodes are drained after it
+  EXPECT_EQ(popped, (std::vector<int>{3, 1, 2}));
+  EXPECT_FALSE(queue.has_value());
+}
@@ -0,0 +1,161 @@
+#include <async_coro/await/run_blocking.h>
+#include <async_coro/await/switch_to_queue.h>
+#include <async_coro/config.h>
+#include <async_coro/execution_system.h>
+#include <async_coro/scheduler.h>
+#include <async_coro/task.h>
+#include <async_coro/task_handle.h>
+#include <async_coro/thread_index.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(run_blocking_tests, result_and_resume_on_parent_queue) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler;
+
+  std::atomic<bool> done{false};
+  std::thread::id blocking_tid;
+  std::thread::id resumed_tid;
+  std::string result;
+
+  auto t = [&]() -> async_coro::task<> {
+    result = co_await async_coro::run_blocking([&]() {
+      blocking_tid = std::this_thread::get_id();
+      std::this_thread::sleep_for(10ms);
+      return std::string{"blocking result"};
+    });
+    resumed_tid = std::this_thread::get_id();
+    done.store(true, std::memory_order::release);
+  };
+
+  auto h = scheduler.start_task(t());
+
+  for (int i = 0; i < 2000 && !done.load(std::memory_order::acquire); ++i) {
+    std::this_thread::sleep_for(1ms);
+    scheduler.get_execution_system<async_coro::execution_system>().update_from_main();
+  }
+
+  ASSERT_TRUE(done.load(std::memory_order::acquire));
+  EXPECT_EQ(result, "blocking result");
+  EXPECT_NE(blocking_tid, std::this_thread::get_id());
+  EXPECT_EQ(resumed_tid, std::this_thread::get_id());
+}
+
+TEST(run_blocking_tests, pool_threads_are_not_workers) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler{std::make_unique<async_coro::execution_system>(
+      async_coro::execution_system_config{.worker_configs = {{"worker1"}}})};
+
+  auto& system = scheduler.get_execution_system<async_coro::execution_system>();
+
+  constexpr int num_tasks = 4;
+
+  std::atomic<int> num_blocked{0};
+  std::atomic<bool> release{false};
+  std::atomic<int> num_done{0};
+  std::atomic<bool> resumed_on_worker{true};
+
+  auto t = [&]() -> async_coro::task<> {
+    co_await async_coro::switch_to_queue(async_coro::execution_queues::worker);
+
+    const int value = co_await async_coro::run_blocking([&]() {
+      num_blocked.fetch_add(1, std::memory_order::relaxed);
+      while (!release.load(std::memory_order::acquire)) {
+        std::this_thread::sleep_for(1ms);
+      }
+      return 1;
+    });
+
+    if (!system.is_thread_fits(async_coro::execution_queues::worker, async_coro::thread_index::current())) {
+      resumed_on_worker.store(false, std::memory_order::relaxed);
+    }
+    num_done.fetch_add(value, std::memory_order::release);
+  };
+
+  std::vector<async_coro::task_handle<void>> handles;
+  for (int i = 0; i < num_tasks; ++i) {
+    handles.push_back(scheduler.start_task(t()));
+  }
+
+  // all tasks block at the same time while the only worker stays free
+  for (int i = 0; i < 2000 && num_blocked.load(std::memory_order::relaxed) < num_tasks; ++i) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_EQ(num_blocked.load(std::memory_order::relaxed), num_tasks);
+  EXPECT_EQ(system.get_num_blocking_threads(), num_tasks);
+  EXPECT_EQ(system.get_num_worker_threads(), 1);
+
+  release.store(true, std::memory_order::release);
+
+  for (int i = 0; i < 2000 && num_done.load(std::memory_order::acquire) < num_tasks; ++i) {
+    std::this_thread::sleep_for(1ms);
+  }
+
+  EXPECT_EQ(num_done.load(std::memory_order::acquire), num_tasks);
+  EXPECT_TRUE(resumed_on_worker.load(std::memory_order::relaxed));
+}
+
+TEST(run_blocking_tests, pool_turned_off_uses_workers) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler{std::make_unique<async_coro::execution_system>(
+      async_coro::execution_system_config{.worker_configs = {{"worker1"}}, .blocking_pool = {.max_threads = 0}})};
+
+  std::atomic<bool> done{false};
+  int result = 0;
+
+  auto t = [&]() -> async_coro::task<> {
+    result = co_await async_coro::run_blocking([]() { return 1; });
+    done.store(true, std::memory_order::release);
+  };
+
+  auto h = scheduler.start_task(t());
+
+  for (int i = 0; i < 2000 && !done.load(std::memory_order::acquire); ++i) {
+    std::this_thread::sleep_for(1ms);
+    scheduler.get_execution_system<async_coro::execution_system>().update_from_main();
+  }
+
+  ASSERT_TRUE(done.load(std::memory_order::acquire));
+  EXPECT_EQ(result, 1);
+  EXPECT_EQ(scheduler.get_execution_system<async_coro::execution_system>().get_num_blocking_threads(), 0);
+}
+
+#if ASYNC_CORO_WITH_EXCEPTIONS && ASYNC_CORO_COMPILE_WITH_EXCEPTIONS
+TEST(run_blocking_tests, exception_is_rethrown) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler;
+
+  std::atomic<bool> done{false};
+  bool was_thrown = false;
+
+  auto t = [&]() -> async_coro::task<> {
+    try {
+      co_await async_coro::run_blocking([]() { throw std::runtime_error{"blocking error"}; });
+    } catch (const std::runtime_error&) {
+      was_thrown = true;
+    }
+    done.store(true, std::memory_order::release);
+  };
+
+  auto h = scheduler.start_task(t());
+
+  for (int i = 0; i < 2000 && !done.load(std::memory_order::acquire); ++i) {
+    std::this_thread::sleep_for(1ms);
+    scheduler.get_execution_system<async_coro::execution_system>().update_from_main();
+  }
+
+  ASSERT_TRUE(done.load(std::memory_order::acquire));
+  EXPECT_TRUE(was_thrown);
+}
+#endif
@@ -0,0 +1,120 @@
+#include <async_coro/execution_queue_mark.h>
+#include <async_coro/execution_system.h>
+#include <async_coro/runtime_clock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST(runtime_clock, no_cache_by_default) {
+  using async_coro::runtime_clock;
+
+  const auto before = std::chrono::steady_clock::now();
+  const auto now = runtime_clock::now();
+  const auto after = std::chrono::steady_clock::now();
+
+  EXPECT_LE(before, now);
+  EXPECT_LE(now, after);
+}
+
+TEST(runtime_clock, refresh_and_reset) {
+  using async_coro::clock_mode;
+  using async_coro::runtime_clock;
+
+  const auto cached = runtime_clock::refresh(clock_mode::cached);
+  std::this_thread::sleep_for(std::chrono::milliseconds{2});
+
+  EXPECT_EQ(runtime_clock::now(), cached);
+
+  runtime_clock::reset();
+  EXPECT_GT(runtime_clock::now(), cached);
+
+  // precise mode turns the cache off
+  runtime_clock::refresh(clock_mode::cached);
+  runtime_clock::refresh(clock_mode::precise);
+  const auto now = runtime_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds{2});
+  EXPECT_GT(runtime_clock::now(), now);
+}
+
+TEST(runtime_clock, coarse_is_not_ahead_of_steady_clock) {
+  using async_coro::clock_mode;
+  using async_coro::runtime_clock;
+
+  for (int i = 0; i < 1000; i++) {
+    const auto coarse = runtime_clock::read(clock_mode::coarse);
+    const auto precise = std::chrono::steady_clock::now();
+
+    EXPECT_LE(coarse, precise);
+    // NOLINTNEXTLINE(*-magic-*)
+    EXPECT_LE(precise - coarse, runtime_clock::coarse_resolution() + std::chrono::milliseconds{10});
+  }
+}
+
+TEST(runtime_clock, worker_caches_time_of_loop) {
+  using namespace async_coro;
+
+  for (const auto mode : {clock_mode::cached, clock_mode::coarse}) {
+    execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                             .main_thread_allowed_tasks = execution_queues::main,
+                             .clock = mode}};
+
+    std::atomic_bool done{false};
+    std::chrono::steady_clock::time_point first;
+    std::chrono::steady_clock::time_point second;
+
+    system.plan_execution(
+        [&](auto&) {
+          first = runtime_clock::now();
+          std::this_thread::sleep_for(std::chrono::milliseconds{5});
+          second = runtime_clock::now();
+          done = true;
+        },
+        execution_queues::worker);
+
+    for (int tries = 0; tries < 1000 && !done.load(); ++tries) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    ASSERT_TRUE(done.load());
+    EXPECT_EQ(first, second);
+  }
+}
+
+TEST(runtime_clock, delayed_tasks_with_clock_modes) {
+  using namespace async_coro;
+
+  for (const auto mode : {clock_mode::precise, clock_mode::cached, clock_mode::coarse}) {
+    for (const bool worker_timers : {false, true}) {
+      execution_system system{{.worker_configs = {{"worker", execution_queues::worker}},
+                               .main_thread_allowed_tasks = execution_queues::main,
+                               .worker_timers = worker_timers,
+                               .clock = mode}};
+
+      constexpr int num_tasks = 10;
+      std::atomic_int num_executed{0};
+      std::atomic_int num_early{0};
+
+      const auto now = std::chrono::steady_clock::now();
+      for (int i = 0; i < num_tasks; i++) {
+        const auto when = now + std::chrono::milliseconds{2 * (i + 1)};
+        system.plan_execution_after(
+            [&, when](auto&) {
+              if (std::chrono::steady_clock::now() < when) {
+                num_early++;
+              }
+              num_executed++;
+            },
+            execution_queues::worker, when);
+      }
+
+      for (int tries = 0; tries < 1000 && num_executed.load() < num_tasks; ++tries) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+
+      EXPECT_EQ(num_executed.load(), num_tasks);
+      EXPECT_EQ(num_early.load(), 0);
+    }
+  }
+}
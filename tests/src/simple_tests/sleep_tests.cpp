@@ -82,3 +82,33 @@ TEST(sleep_tests, resume_on_worker_queue) {
   // resumed thread should not be main thread (worker thread)
   EXPECT_NE(resumed_tid_hash.load(std::memory_order::relaxed), std::hash<std::thread::id>{}(main_tid));
 }
+
+TEST(sleep_tests, with_timer_slack) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler;
+
+  constexpr auto sleep_dur = 40ms;
+
+  std::atomic<bool> done{false};
+  std::atomic<long long> elapsed_ms{0};
+
+  auto t = [&]() -> async_coro::task<> {
+    auto start = std::chrono::steady_clock::now();
+    co_await async_coro::sleep(sleep_dur, async_coro::timer_slack{20ms});
+    auto end = std::chrono::steady_clock::now();
+    elapsed_ms.store(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(), std::memory_order::relaxed);
+    done.store(true, std::memory_order::release);
+  };
+
+  auto h = scheduler.start_task(t());
+
+  for (int i = 0; i < 2000 && !done.load(std::memory_order::relaxed); ++i) {
+    std::this_thread::sleep_for(1ms);
+    scheduler.get_execution_system<async_coro::execution_system>().update_from_main();
+  }
+
+  ASSERT_TRUE(done.load(std::memory_order::acquire));
+  // slack can only delay the wakeup
+  EXPECT_GE(elapsed_ms.load(std::memory_order::relaxed), sleep_dur.count());
+}
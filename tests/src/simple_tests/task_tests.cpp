@@ -8,6 +8,7 @@
 #include <async_coro/task_launcher.h>
 #include <async_coro/utils/unique_function.h>
 #include <gtest/gtest.h>
+#include <utils/counting_resource.h>
 #include <utils/memory_hooks.h>
 
 #include <atomic>
@@ -17,7 +18,9 @@
 #include <semaphore>
 #include <thread>
 #include <type_traits>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace task_tests {
 struct coro_runner {
@@ -1475,6 +1478,168 @@ TEST(task, deep_recursion) {
   ASSERT_TRUE(res.done());
 }
 
+TEST(task, deadline_is_propagated_to_continuations) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler{std::make_unique<async_coro::execution_system>(
+      async_coro::execution_system_config{
+          .worker_configs = {{"worker1", async_coro::execution_queues::worker}},
+          .queue_configs = {{.queue = async_coro::execution_queues::worker, .type = async_coro::execution_queue_type::deadline}},
+      })};
+
+  auto& system = scheduler.get_execution_system<async_coro::execution_system>();
+
+  std::atomic_bool release = false;
+  std::atomic_bool is_blocked = false;
+
+  // worker is held so continuations of all coroutines are in the queue when it takes the next one
+  system.plan_execution(
+      [&](auto&) {
+        is_blocked = true;
+        while (!release.load()) {
+          std::this_thread::sleep_for(1ms);
+        }
+      },
+      async_coro::execution_queues::worker);
+
+  while (!is_blocked.load()) {
+    std::this_thread::sleep_for(1ms);
+  }
+
+  std::vector<int> order;
+  std::atomic_int num_done = 0;
+
+  const auto routine = [&](int id) -> async_coro::task<> {
+    co_await switch_to_queue(async_coro::execution_queues::worker);
+
+    order.push_back(id);
+    num_done++;
+  };
+
+  const auto now = std::chrono::steady_clock::now();
+  std::vector<async_coro::task_handle<void>> handles;
+  for (const auto& [id, deadline] : {std::pair{3, now + 30s}, std::pair{1, now + 10s}, std::pair{2, now + 20s}}) {
+    async_coro::task_launcher launcher{routine(id), async_coro::execution_queues::main};
+    launcher.set_deadline(async_coro::task_deadline{deadline});
+    handles.push_back(scheduler.start_task(std::move(launcher)));
+  }
+
+  release = true;
+  for (int i = 0; i < 1000 && num_done.load() < 3; i++) {
+    std::this_thread::sleep_for(1ms);
+  }
+
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(task, missed_deadline_continuation_is_not_dropped) {
+  using namespace std::chrono_literals;
+
+  async_coro::scheduler scheduler{std::make_unique<async_coro::execution_system>(
+      async_coro::execution_system_config{
+          .worker_configs = {{"worker1", async_coro::execution_queues::worker}},
+          .queue_configs = {{.queue = async_coro::execution_queues::worker,
+                             .type = async_coro::execution_queue_type::deadline,
+                             .missed_deadline = async_coro::missed_deadline_policy::drop}},
+      })};
+
+  auto& system = scheduler.get_execution_system<async_coro::execution_system>();
+
+  std::atomic_bool release = false;
+  std::atomic_bool is_blocked = false;
+
+  // worker is held until the deadline of the coroutine passes
+  system.plan_execution(
+      [&](auto&) {
+        is_blocked = true;
+        while (!release.load()) {
+          std::this_thread::sleep_for(1ms);
+        }
+      },
+      async_coro::execution_queues::worker);
+
+  while (!is_blocked.load()) {
+    std::this_thread::sleep_for(1ms);
+  }
+
+  std::atomic_bool is_done = false;
+
+  const auto routine = [&]() -> async_coro::task<> {
+    co_await switch_to_queue(async_coro::execution_queues::worker);
+    is_done = true;
+  };
+
+  async_coro::task_launcher launcher{routine(), async_coro::execution_queues::main};
+  launcher.set_deadline(async_coro::task_deadline{std::chrono::steady_clock::now() + 1ms});
+  auto handle = scheduler.start_task(std::move(launcher));
+
+  std::this_thread::sleep_for(5ms);
+  release = true;
+
+  for (int i = 0; i < 1000 && !handle.done(); i++) {
+    std::this_thread::sleep_for(1ms);
+  }
+
+  EXPECT_TRUE(handle.done());
+  EXPECT_TRUE(is_done.load());
+  EXPECT_EQ(system.get_num_missed_deadlines(async_coro::execution_queues::worker), 1);
+}
+
+TEST(task, scheduler_callbacks_use_memory_resource) {
+  using namespace std::chrono_literals;
+
+  mem_hook::counting_resource resource;
+
+  {
+    async_coro::scheduler scheduler{std::make_unique<async_coro::execution_system>(
+                                        async_coro::execution_system_config{.worker_configs = {{"worker1", async_coro::execution_queues::worker}}}),
+                                    &resource};
+
+    auto& system = scheduler.get_execution_system<async_coro::execution_system>();
+
+    std::atomic_bool release = false;
+    std::atomic_bool is_blocked = false;
+
+    // worker is held so the coroutine is still suspended when the continuation is set
+    system.plan_execution(
+        [&](auto&) {
+          is_blocked = true;
+          while (!release.load()) {
+            std::this_thread::sleep_for(1ms);
+          }
+        },
+        async_coro::execution_queues::worker);
+
+    while (!is_blocked.load()) {
+      std::this_thread::sleep_for(1ms);
+    }
+
+    const auto num_before_start = resource.num_allocations.load();
+
+    auto handle = scheduler.start_task(
+        []() -> async_coro::task<int> {
+          co_await switch_to_queue(async_coro::execution_queues::worker);
+          co_return 1;
+        },
+        async_coro::execution_queues::main);
+
+    const auto num_before_continue = resource.num_allocations.load();
+    EXPECT_GT(num_before_continue, num_before_start);
+
+    std::atomic_bool is_continued = false;
+    handle.continue_with([&](auto&, bool) { is_continued = true; });
+    EXPECT_GT(resource.num_allocations.load(), num_before_continue);
+
+    release = true;
+    for (int i = 0; i < 1000 && !is_continued.load(); i++) {
+      std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_TRUE(is_continued.load());
+  }
+
+  EXPECT_EQ(resource.num_allocated.load(), 0);
+}
+
 #if MEM_HOOKS_ENABLED
 
 TEST(task, mem_free_child) {
@@ -0,0 +1,36 @@
+#include <async_coro/thread_index.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+TEST(thread_index, unique_per_thread) {
+  using async_coro::thread_index;
+
+  const auto main_index = thread_index::current();
+
+  EXPECT_NE(main_index, thread_index{});
+  EXPECT_EQ(main_index, thread_index::current());
+
+  constexpr int num_threads = 4;
+
+  std::vector<thread_index> indexes(num_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&indexes, i]() {
+      indexes[i] = thread_index::current();
+      EXPECT_EQ(indexes[i], thread_index::current());
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_threads; i++) {
+    EXPECT_NE(indexes[i], thread_index{});
+    EXPECT_NE(indexes[i], main_index);
+    for (int j = i + 1; j < num_threads; j++) {
+      EXPECT_NE(indexes[i], indexes[j]);
+    }
+  }
+}
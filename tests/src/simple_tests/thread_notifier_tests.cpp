@@ -0,0 +1,42 @@
+#include <async_coro/thread_notifier.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+TEST(thread_notifier, sleep_until_times_out) {
+  async_coro::thread_notifier notifier;
+
+  const auto start = std::chrono::steady_clock::now();
+  notifier.sleep_until(start + std::chrono::milliseconds{20});
+
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds{20});
+  EXPECT_FALSE(notifier.notify());
+}
+
+TEST(thread_notifier, notify_skips_next_sleep_until) {
+  async_coro::thread_notifier notifier;
+
+  EXPECT_FALSE(notifier.notify());
+
+  const auto start = std::chrono::steady_clock::now();
+  notifier.sleep_until(start + std::chrono::seconds{10});
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{1});
+}
+
+TEST(thread_notifier, notify_wakes_sleep_until) {
+  async_coro::thread_notifier notifier;
+
+  const auto start = std::chrono::steady_clock::now();
+  std::thread sleeper{[&] {
+    notifier.sleep_until(std::chrono::steady_clock::now() + std::chrono::seconds{10});
+  }};
+
+  // either wakes the sleeping thread or makes it skip the sleep, both must not wait for the deadline
+  std::this_thread::sleep_for(std::chrono::milliseconds{20});
+  notifier.notify();
+  sleeper.join();
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds{1});
+}
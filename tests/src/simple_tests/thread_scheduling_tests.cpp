@@ -0,0 +1,78 @@
+#include <async_coro/utils/thread_scheduling.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+
+TEST(thread_scheduling, default_changes_nothing) {
+  async_coro::thread_scheduling scheduling;
+  EXPECT_TRUE(scheduling.is_default());
+
+  std::vector<async_coro::thread_scheduling_error> errors;
+  async_coro::apply_thread_scheduling(scheduling, "test", errors);
+  EXPECT_TRUE(errors.empty());
+}
+
+TEST(thread_scheduling, pins_to_cpu) {
+  cpu_set_t allowed;
+  ASSERT_EQ(::sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+
+  std::uint32_t cpu = 0;
+  while (!CPU_ISSET(cpu, &allowed)) {
+    cpu++;
+  }
+
+  std::vector<async_coro::thread_scheduling_error> errors;
+  int running_cpu = -1;
+  int num_allowed = 0;
+
+  // settings are applied to the calling thread, so a separate thread is used
+  std::thread thread{[&] {
+    async_coro::apply_thread_scheduling({.cpu_set = {cpu}}, "pinned", errors);
+
+    cpu_set_t result;
+    ::sched_getaffinity(0, sizeof(result), &result);
+    num_allowed = CPU_COUNT(&result);
+    running_cpu = ::sched_getcpu();
+  }};
+  thread.join();
+
+  EXPECT_TRUE(errors.empty());
+  EXPECT_EQ(num_allowed, 1);
+  EXPECT_EQ(running_cpu, static_cast<int>(cpu));
+}
+
+TEST(thread_scheduling, reports_failures) {
+  std::vector<async_coro::thread_scheduling_error> errors;
+  int nice_value = 0;
+
+  std::thread thread{[&] {
+    // cpu out of range and priority of real time policy out of range fail, nice value is still applied
+    async_coro::apply_thread_scheduling(
+        {.cpu_set = {CPU_SETSIZE}, .policy = async_coro::thread_sched_policy::fifo, .priority = 1000, .nice_value = 5},  // NOLINT(*-magic-*)
+        "broken", errors);
+
+    errno = 0;
+    nice_value = ::getpriority(PRIO_PROCESS, static_cast<id_t>(::gettid()));
+  }};
+  thread.join();
+
+  ASSERT_EQ(errors.size(), 2);
+  EXPECT_EQ(errors[0].thread_name, "broken");
+  EXPECT_EQ(errors[0].setting, "cpu_set");
+  EXPECT_EQ(errors[0].error_code, EINVAL);
+  EXPECT_EQ(errors[1].setting, "policy");
+  EXPECT_NE(errors[1].error_code, 0);
+  EXPECT_EQ(nice_value, 5);
+}
+
+#endif
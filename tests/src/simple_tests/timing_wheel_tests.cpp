@@ -0,0 +1,279 @@
+#include <async_coro/internal/timing_wheel.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace {
+
+using wheel_t = async_coro::internal::timing_wheel<int>;
+using clock_t_ = wheel_t::clock;
+
+constexpr clock_t_::time_point start_time{};
+
+clock_t_::time_point at_ms(std::int64_t ms) { return start_time + std::chrono::milliseconds{ms}; }
+
+std::vector<int> advance(wheel_t& wheel, std::int64_t now_ms) {
+  std::vector<int> fired;
+  wheel.advance(at_ms(now_ms), [&](int&& val) { fired.push_back(val); });
+  return fired;
+}
+
+}  // namespace
+
+TEST(timing_wheel, fires_in_time) {
+  wheel_t wheel{std::chrono::milliseconds{1}, start_time};
+
+  EXPECT_FALSE(wheel.next_deadline().has_value());
+
+  wheel.insert(at_ms(5), 5);
+  wheel.insert(at_ms(3), 3);
+  wheel.insert(at_ms(100), 100);
+  wheel.insert(at_ms(5000), 5000);
+
+  constexpr std::int64_t hours_10 = 10LL * 60 * 60 * 1000;
+  wheel.insert(at_ms(hours_10), 0);
+
+  EXPECT_EQ(wheel.size(), 5);
+  EXPECT_EQ(wheel.next_deadline(), at_ms(3));
+
+  EXPECT_TRUE(advance(wheel, 2).empty());
+  EXPECT_EQ(advance(wheel, 4), std::vector<int>{3});
+  EXPECT_EQ(advance(wheel, 5), std::vector<int>{5});
+  EXPECT_TRUE(advance(wheel, 99).empty());
+  EXPECT_EQ(advance(wheel, 4000), std::vector<int>{100});
+  EXPECT_EQ(advance(wheel, 5000), std::vector<int>{5000});
+  EXPECT_TRUE(advance(wheel, hours_10 - 1).empty());
+  EXPECT_EQ(advance(wheel, hours_10), std::vector<int>{0});
+
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.next_deadline().has_value());
+}
+
+TEST(timing_wheel, rounds_up_to_resolution) {
+  wheel_t wheel{std::chrono::milliseconds{10}, start_time};
+
+  wheel.insert(start_time + std::chrono::microseconds{10001}, 1);
+
+  // timer should never fire before its time
+  EXPECT_TRUE(advance(wheel, 10).empty());
+  EXPECT_TRUE(advance(wheel, 19).empty());
+  EXPECT_EQ(advance(wheel, 20), std::vector<int>{1});
+}
+
+TEST(timing_wheel, past_timer_fires_on_next_advance) {
+  wheel_t wheel{std::chrono::milliseconds{1}, start_time};
+
+  EXPECT_TRUE(advance(wheel, 50).empty());
+
+  wheel.insert(at_ms(10), 10);
+
+  EXPECT_EQ(wheel.next_deadline(), at_ms(50));
+  EXPECT_EQ(advance(wheel, 50), std::vector<int>{10});
+}
+
+TEST(timing_wheel, cancel) {
+  wheel_t wheel{std::chrono::milliseconds{1}, start_time};
+
+  const auto id1 = wheel.insert(at_ms(10), 1);
+  const auto id2 = wheel.insert(at_ms(10), 2);
+  const auto id3 = wheel.insert(at_ms(100000), 3);
+
+  EXPECT_NE(id1, 0);
+  EXPECT_NE(id1, id2);
+
+  int val = 0;
+  EXPECT_TRUE(wheel.cancel(id1, val));
+  EXPECT_EQ(val, 1);
+  EXPECT_FALSE(wheel.cancel(id1, val));
+
+  EXPECT_TRUE(wheel.cancel(id3, val));
+  EXPECT_EQ(val, 3);
+  EXPECT_EQ(wheel.size(), 1);
+
+  // node of cancelled timer is reused with a new id
+  const auto id4 = wheel.insert(at_ms(20), 4);
+  EXPECT_NE(id4, id1);
+  EXPECT_NE(id4, id3);
+  EXPECT_FALSE(wheel.cancel(id1, val));
+  EXPECT_FALSE(wheel.cancel(id3, val));
+
+  EXPECT_EQ(advance(wheel, 100000), (std::vector<int>{2, 4}));
+
+  // fired timers can't be cancelled
+  EXPECT_FALSE(wheel.cancel(id2, val));
+  EXPECT_FALSE(wheel.cancel(id4, val));
+  EXPECT_FALSE(wheel.cancel(0, val));
+}
+
+TEST(timing_wheel, random_timers) {
+  wheel_t wheel{std::chrono::milliseconds{1}, start_time};
+
+  std::mt19937_64 rng{42};  // NOLINT(*-magic-*)
+  std::vector<std::int64_t> times;
+  std::vector<wheel_t::id_type> ids;
+
+  constexpr int num_timers = 10000;
+  for (int i = 0; i < num_timers; i++) {
+    // times from 0 to about 12 days cover all levels
+    const auto shift = std::uniform_int_distribution<int>{0, 30}(rng);  // NOLINT(*-magic-*)
+    const auto time = std::uniform_int_distribution<std::int64_t>{0, std::int64_t{1} << shift}(rng);
+    times.push_back(time);
+    ids.push_back(wheel.insert(at_ms(time), i));
+  }
+
+  // cancel every 4th timer
+  std::vector<bool> is_cancelled(num_timers, false);
+  for (int i = 0; i < num_timers; i += 4) {
+    int val = 0;
+    EXPECT_TRUE(wheel.cancel(ids[i], val));
+    EXPECT_EQ(val, i);
+    is_cancelled[i] = true;
+  }
+
+  std::vector<bool> is_fired(num_timers, false);
+  std::int64_t prev_now = -1;
+  std::int64_t now = 0;
+  while (!wheel.empty()) {
+    wheel.advance(at_ms(now), [&](int&& index) {
+      EXPECT_FALSE(is_cancelled[index]);
+      EXPECT_FALSE(is_fired[index]);
+      EXPECT_LE(times[index], now);
+      EXPECT_GT(times[index], prev_now);
+      is_fired[index] = true;
+    });
+
+    prev_now = now;
+    now += std::uniform_int_distribution<std::int64_t>{1, std::int64_t{1} << std::uniform_int_distribution<int>{0, 24}(rng)}(rng);  // NOLINT(*-magic-*)
+  }
+
+  for (int i = 0; i < num_timers; i++) {
+    EXPECT_NE(is_cancelled[i], is_fired[i]);
+  }
+}
+
+TEST(timing_wheel, slack_groups_timers) {
+  wheel_t wheel{std::chrono::milliseconds{1}, start_time};
+
+  // 100 timers with windows [100 + i, 200 + i] should fire on aligned ticks 128, 192 and 256 only
+  constexpr int num_timers = 100;
+  for (int i = 0; i < num_timers; i++) {
+    wheel.insert_with_slack(at_ms(100 + i), std::chrono::milliseconds{100}, 100 + i);
+  }
+
+  EXPECT_EQ(wheel.next_deadline(), at_ms(128));
+
+  std::size_t num_fired = 0;
+  int num_ticks = 0;
+  for (std::int64_t now = 0; !wheel.empty(); now++) {
+    const auto fired = advance(wheel, now);
+    if (!fired.empty()) {
+      num_ticks++;
+    }
+    num_fired += fired.size();
+  }
+
+  EXPECT_EQ(num_fired, num_timers);
+  EXPECT_EQ(num_ticks, 3);
+}
+
+TEST(timing_wheel, slack_never_fires_early) {
+  wheel_t wheel{std::chrono::milliseconds{1}, start_time};
+
+  std::mt19937 rng{7};  // NOLINT(*-magic-*)
+  std::vector<std::int64_t> times;
+  std::vector<std::int64_t> slacks;
+
+  constexpr int num_timers = 1000;
+  for (int i = 0; i < num_timers; i++) {
+    const auto time = std::uniform_int_distribution<std::int64_t>{0, 10000}(rng);  // NOLINT(*-magic-*)
+    const auto slack = std::uniform_int_distribution<std::int64_t>{0, 1000}(rng);  // NOLINT(*-magic-*)
+    times.push_back(time);
+    slacks.push_back(slack);
+    wheel.insert_with_slack(at_ms(time), std::chrono::milliseconds{slack}, i);
+  }
+
+  std::int64_t now = 0;
+  while (!wheel.empty()) {
+    wheel.advance(at_ms(now), [&](int&& index) {
+      EXPECT_LE(times[index], now);
+      EXPECT_LE(now, times[index] + slacks[index]);
+    });
+    now++;
+  }
+}
+
+TEST(timing_wheel, slack_saturates) {
+  wheel_t wheel{std::chrono::milliseconds{1}, start_time};
+
+  // window end is past the max time point, timer is still planned inside the window
+  const auto timer_id = wheel.insert_with_slack(at_ms(10), clock_t_::duration::max(), 1);
+
+  const auto deadline = wheel.next_deadline();
+  ASSERT_TRUE(deadline.has_value());
+  EXPECT_GE(*deadline, at_ms(10));
+  EXPECT_TRUE(advance(wheel, 9).empty());
+
+  int val = 0;
+  EXPECT_TRUE(wheel.cancel(timer_id, val));
+  EXPECT_EQ(val, 1);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timing_wheel, periodic_rearms_in_place) {
+  wheel_t wheel{std::chrono::milliseconds{1}, start_time};
+
+  const auto timer_id = wheel.insert_periodic(at_ms(10), 1);
+  wheel.insert(at_ms(25), 2);
+
+  std::vector<std::int64_t> periodic_fires;
+  std::int64_t now = 0;
+
+  const auto on_periodic = [&](int& val) -> std::optional<wheel_t::clock::time_point> {
+    EXPECT_EQ(val, 1);
+    periodic_fires.push_back(now);
+    return at_ms(10 + (10 * static_cast<std::int64_t>(periodic_fires.size())));
+  };
+
+  std::vector<int> fired;
+  for (now = 0; now <= 45; now++) {  // NOLINT(*-magic-*)
+    wheel.advance(at_ms(now), [&](int&& val) { fired.push_back(val); }, on_periodic);
+  }
+
+  EXPECT_EQ(periodic_fires, (std::vector<std::int64_t>{10, 20, 30, 40}));
+  EXPECT_EQ(fired, std::vector<int>{2});
+  EXPECT_EQ(wheel.size(), 1);
+
+  // id stays valid after re-arms
+  int val = 0;
+  EXPECT_TRUE(wheel.cancel(timer_id, val));
+  EXPECT_EQ(val, 1);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timing_wheel, periodic_catches_up_in_one_advance) {
+  wheel_t wheel{std::chrono::milliseconds{1}, start_time};
+
+  wheel.insert_periodic(at_ms(10), 1);
+
+  int num_fires = 0;
+  const auto on_periodic = [&](int& /*val*/) -> std::optional<wheel_t::clock::time_point> {
+    num_fires++;
+    if (num_fires == 5) {  // NOLINT(*-magic-*)
+      // timer is removed
+      return std::nullopt;
+    }
+    return at_ms(10 + (10 * static_cast<std::int64_t>(num_fires)));
+  };
+
+  // ticks 10, 20, 30 and 40 were missed and fire at once, later ones are in future
+  EXPECT_EQ(wheel.advance(at_ms(45), [](int&&) {}, on_periodic), 4);
+  EXPECT_EQ(num_fires, 4);
+
+  EXPECT_EQ(wheel.advance(at_ms(50), [](int&&) {}, on_periodic), 1);
+  EXPECT_EQ(num_fires, 5);
+  EXPECT_TRUE(wheel.empty());
+}